@@ -0,0 +1,94 @@
+// Compile from the src folder with:
+// g++ -std=c++14 -O3 -I. extras/experiments/context_freeze.cpp
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "lib/internal/context.hpp"
+
+#define ROUNDS 2000
+
+using namespace std;
+using namespace fcpp;
+
+class timer {
+    typedef std::chrono::high_resolution_clock clock_t;
+    typedef std::chrono::duration<double, std::ratio<1>> second_t;
+
+    std::chrono::time_point<clock_t, second_t> beginning;
+
+  public:
+    timer() : beginning(clock_t::now()) {}
+    double elapsed() const {
+        return std::chrono::duration_cast<second_t>(clock_t::now() - beginning).count();
+    }
+};
+
+// metric counting the rounds since a message was received
+struct metric {
+    template <typename... Ts>
+    double update(double const& r, Ts const&...) const {
+        return r + 1;
+    }
+};
+
+// microseconds per round with a given neighbourhood size and fraction of neighbours replaced every round
+template <bool pointer>
+double experiment(size_t n, double churn) {
+    using context_type = internal::context<false, pointer, true, false, false, false, false, double, int>;
+    using export_type = typename context_type::export_type;
+    mt19937_64 rng(42);
+    uniform_real_distribution<double> coin(0, 1);
+    vector<device_t> hood(n);
+    device_t next = 1;
+    for (auto& d : hood) d = next++;
+    export_type e;
+    for (trace_t t = 0; t < 20; ++t) e->insert(t, int(t));
+    context_type c;
+    size_t acc = 0;
+    double elapsed = 0;
+    for (size_t r = 0; r < ROUNDS; ++r) {
+        // some neighbours leave, and are replaced by new ones
+        for (auto& d : hood) if (coin(rng) < churn) d = next++;
+        // messages from the current neighbours arrive in arbitrary order
+        shuffle(hood.begin(), hood.end(), rng);
+        timer t;
+        for (device_t d : hood) c.insert(d, e, 0, 1.5, 0);
+        c.freeze(std::numeric_limits<device_t>::max(), 0);
+        acc += c.align(0).size();
+        // messages older than a round are discarded
+        c.unfreeze(0, metric{}, 1.5);
+        elapsed += t.elapsed();
+    }
+    if (acc == 42) cout << endl;
+    return elapsed / ROUNDS * 1000000;
+}
+
+int main() {
+    cout << "Microseconds per round (pointer exports / flat exports)" << endl;
+    for (size_t n : {10, 100, 1000}) {
+        cout << n << " neighbours:";
+        for (double churn : {0.0, 0.01, 0.1, 0.5, 1.0})
+            cout << "\tchurn " << churn << " " << experiment<true>(n, churn) << " / " << experiment<false>(n, churn);
+        cout << endl;
+    }
+}
+
+/*
+ RESULTS (single-core virtual machine)
+
+Full stable sort at every freeze:
+Microseconds per round (pointer exports / flat exports)
+10 neighbours:	churn 0 1.96275 / 2.71219	churn 0.01 1.45165 / 2.73242	churn 0.1 1.51475 / 2.84147	churn 0.5 1.75066 / 3.18157	churn 1 1.55149 / 2.69734
+100 neighbours:	churn 0 14.7244 / 31.3263	churn 0.01 14.1197 / 29.54	churn 0.1 13.7743 / 30.0529	churn 0.5 15.9113 / 35.2212	churn 1 14.5663 / 32.1878
+1000 neighbours:	churn 0 179.428 / 418.411	churn 0.01 184.493 / 418.496	churn 0.1 189.74 / 433.524	churn 0.5 202.871 / 456.626	churn 1 184.607 / 407.741
+
+Known neighbours replaced in place, new ones sorted and merged:
+Microseconds per round (pointer exports / flat exports)
+10 neighbours:	churn 0 0.916992 / 1.64211	churn 0.01 0.955136 / 1.63802	churn 0.1 1.10195 / 1.79968	churn 0.5 1.40339 / 2.32256	churn 1 1.47789 / 2.62477
+100 neighbours:	churn 0 10.1189 / 16.826	churn 0.01 9.41261 / 12.1577	churn 0.1 9.02336 / 14.9459	churn 0.5 9.62419 / 20.5937	churn 1 12.2135 / 20.455
+1000 neighbours:	churn 0 112.986 / 162.466	churn 0.01 130.59 / 183.58	churn 0.1 128.201 / 186.757	churn 0.5 143.406 / 284.497	churn 1 142.533 / 302.233
+ */
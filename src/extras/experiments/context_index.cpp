@@ -0,0 +1,155 @@
+// Compile from the src folder with:
+// g++ -std=c++14 -O3 -I. extras/experiments/context_index.cpp
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "lib/internal/context.hpp"
+
+#define TRACES 20
+#define QUERIES 2000000
+#define DATA 20000
+
+using namespace std;
+using namespace fcpp;
+
+class timer {
+    typedef std::chrono::high_resolution_clock clock_t;
+    typedef std::chrono::duration<double, std::ratio<1>> second_t;
+
+    std::chrono::time_point<clock_t, second_t> beginning;
+
+  public:
+    timer() : beginning(clock_t::now()) {}
+    double elapsed() const {
+        return std::chrono::duration_cast<second_t>(clock_t::now() - beginning).count();
+    }
+};
+
+using map_type = common::multitype_map<trace_t, int, double>;
+using data_type = vector<pair<device_t, map_type>>;
+
+mt19937_64 rng(42);
+
+inline trace_t code_point(trace_t t) {
+    return t * 0x9E3779B97F4A7C15ULL;
+}
+
+// exports with TRACES aligned call points, half of which with values
+vector<map_type> exports(size_t n) {
+    vector<map_type> v(n);
+    for (size_t i=0; i<n; ++i)
+        for (trace_t t=0; t<TRACES; ++t) {
+            v[i].insert(code_point(t));
+            if (t % 2) v[i].insert(code_point(t), int(rng() % 100));
+        }
+    return v;
+}
+
+// probing every export for every query (without a trace index)
+size_t scan_round(data_type const& data, size_t repeat) {
+    size_t acc = 0;
+    for (trace_t t=0; t<TRACES; ++t)
+        for (size_t k=0; k<repeat; ++k) {
+            if (t % 2) {
+                vector<device_t> ids;
+                vector<int> vals{0};
+                for (auto const& x : data)
+                    if (x.second.count<int>(code_point(t))) {
+                        ids.push_back(x.first);
+                        vals.push_back(x.second.at<int>(code_point(t)));
+                    }
+                acc += vals.size();
+            } else {
+                vector<device_t> v;
+                for (auto const& x : data)
+                    if (x.second.contains(code_point(t))) v.push_back(x.first);
+                acc += v.size();
+            }
+        }
+    return acc;
+}
+
+// building the trace index and querying it (with a trace index)
+size_t index_round(data_type const& data, internal::trace_index<int, double>& index, size_t repeat) {
+    size_t acc = 0;
+    index.clear();
+    for (auto const& x : data) index.insert(x.first, x.second);
+    index.sort();
+    for (trace_t t=0; t<TRACES; ++t)
+        for (size_t k=0; k<repeat; ++k) {
+            if (t % 2) acc += details::get_vals(index.nbr(code_point(t), 0, 0)).size();
+            else acc += index.align(code_point(t), 0).size();
+        }
+    return acc;
+}
+
+void experiment(size_t n, size_t repeat) {
+    vector<map_type> ex = exports(n);
+    size_t rounds = QUERIES / n / TRACES / repeat + 1;
+    size_t devices = DATA / n + 1;
+    size_t acc = 0;
+    // a different neighbourhood for every device, so that caches are cold as in a simulation
+    vector<data_type> data(devices);
+    for (auto& d : data)
+        for (size_t i=0; i<n; ++i) d.emplace_back(i+1, ex[i]);
+    internal::trace_index<int, double> index;
+    cout << "Experiment with " << n << " neighbours and " << repeat << " queries per trace" << endl;
+    {
+        timer t;
+        for (size_t r=0; r<rounds; ++r)
+            acc += scan_round(data[r % devices], repeat);
+        cout << "neighbour scan: " << t.elapsed() / rounds * 1000000 << " us/round" << endl;
+    }
+    {
+        timer t;
+        for (size_t r=0; r<rounds; ++r)
+            acc += index_round(data[r % devices], index, repeat);
+        cout << "trace index:    " << t.elapsed() / rounds * 1000000 << " us/round" << endl;
+    }
+    if (acc == 42) cout << endl;
+}
+
+int main() {
+    for (size_t repeat : {1, 4})
+        for (size_t n : {10, 30, 100, 300, 1000})
+            experiment(n, repeat);
+}
+
+/*
+ RESULTS (single-core virtual machine)
+
+Experiment with 10 neighbours and 1 queries per trace
+neighbour scan: 11.9234 us/round
+trace index:    6.61095 us/round
+Experiment with 30 neighbours and 1 queries per trace
+neighbour scan: 20.552 us/round
+trace index:    16.1543 us/round
+Experiment with 100 neighbours and 1 queries per trace
+neighbour scan: 58.1115 us/round
+trace index:    46.1051 us/round
+Experiment with 300 neighbours and 1 queries per trace
+neighbour scan: 161.28 us/round
+trace index:    134.319 us/round
+Experiment with 1000 neighbours and 1 queries per trace
+neighbour scan: 513.726 us/round
+trace index:    536.518 us/round
+Experiment with 10 neighbours and 4 queries per trace
+neighbour scan: 31.103 us/round
+trace index:    10.711 us/round
+Experiment with 30 neighbours and 4 queries per trace
+neighbour scan: 51.7234 us/round
+trace index:    22.633 us/round
+Experiment with 100 neighbours and 4 queries per trace
+neighbour scan: 140.691 us/round
+trace index:    63.0994 us/round
+Experiment with 300 neighbours and 4 queries per trace
+neighbour scan: 323.054 us/round
+trace index:    181.397 us/round
+Experiment with 1000 neighbours and 4 queries per trace
+neighbour scan: 1062.72 us/round
+trace index:    723.338 us/round
+ */
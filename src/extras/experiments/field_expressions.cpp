@@ -0,0 +1,94 @@
+// Compile from the src folder with:
+// g++ -std=c++14 -O3 -I. extras/experiments/field_expressions.cpp
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "lib/data/field.hpp"
+
+#define OPERATIONS 4000000
+
+using namespace std;
+using namespace fcpp;
+
+class timer {
+    typedef std::chrono::high_resolution_clock clock_t;
+    typedef std::chrono::duration<double, std::ratio<1>> second_t;
+
+    std::chrono::time_point<clock_t, second_t> beginning;
+
+  public:
+    timer() : beginning(clock_t::now()) {}
+    double elapsed() const {
+        return std::chrono::duration_cast<second_t>(clock_t::now() - beginning).count();
+    }
+};
+
+// a field with n neighbours, skipping every k-th one
+field<double> neighbours(size_t n, size_t k, double v) {
+    details::field_ids ids;
+    details::field_vals<double> vals;
+    vals.push_back(v);
+    for (size_t i=0; i<n; ++i) if (i % k) {
+        ids.push_back(i);
+        vals.push_back(v + i);
+    }
+    return details::make_field(std::move(ids), std::move(vals));
+}
+
+auto minimum = [] (double x, double y) { return x < y ? x : y; };
+auto maximum = [] (double x, double y) { return x > y ? x : y; };
+
+// the field computations of a gradient, materialising every intermediate field
+double eager(field<double> const& d, field<double> const& w, field<double> const& p, vector<device_t> const& dom) {
+    field<double> t = w * 2.0;
+    field<double> s = d + t;
+    field<double> m = map_hood(maximum, s, p);
+    field<double> r = m - 1.0;
+    return details::fold_hood(minimum, r, dom);
+}
+
+auto sum = [] (double x, double y) { return x + y; };
+auto product = [] (double x, double y) { return x * y; };
+
+// the same computations, fused in a single pass
+double lazy(field<double> const& d, field<double> const& w, field<double> const& p, vector<device_t> const& dom) {
+    using details::map_lazy;
+    return details::fold_hood(minimum, map_lazy(sum, map_lazy(maximum, map_lazy(sum, d, map_lazy(product, w, 2.0)), p), -1.0), dom);
+}
+
+template <typename F>
+void experiment(char const* name, size_t n, F&& f) {
+    size_t rounds = OPERATIONS / (n+1);
+    field<double> d = neighbours(n, 2, 1), w = neighbours(n, 3, 2), p = neighbours(n, 5, 3);
+    vector<device_t> dom;
+    for (size_t i=0; i<n; ++i) dom.push_back(i);
+    double acc = 0;
+    timer t;
+    for (size_t r=0; r<rounds; ++r) acc += f(d, w, p + r, dom);
+    cout << name << " with " << n << " neighbours: " << t.elapsed() / rounds * 1000000000 << " ns/round" << endl;
+    if (acc == 42) cout << endl;
+}
+
+int main() {
+    for (size_t n : {4, 8, 16, 64, 256}) {
+        experiment("eager", n, eager);
+        experiment("lazy ", n, lazy);
+    }
+}
+
+/*
+ RESULTS (single-core virtual machine)
+
+eager with 4 neighbours: 70.4973 ns/round
+lazy  with 4 neighbours: 39.0749 ns/round
+eager with 8 neighbours: 119.666 ns/round
+lazy  with 8 neighbours: 67.028 ns/round
+eager with 16 neighbours: 375.126 ns/round
+lazy  with 16 neighbours: 174.306 ns/round
+eager with 64 neighbours: 1157.92 ns/round
+lazy  with 64 neighbours: 616.076 ns/round
+eager with 256 neighbours: 4348.96 ns/round
+lazy  with 256 neighbours: 2525.57 ns/round
+ */
@@ -0,0 +1,117 @@
+// Compile from the src folder with:
+// g++ -std=c++14 -O3 -I. extras/experiments/field_storage.cpp
+// and compare with the heap-only storage obtained with:
+// g++ -std=c++14 -O3 -I. -DFCPP_FIELD_INLINE=0 extras/experiments/field_storage.cpp
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "lib/data/field.hpp"
+
+#define OPERATIONS 4000000
+
+using namespace std;
+using namespace fcpp;
+
+size_t allocations = 0;
+
+void* operator new(size_t n) {
+    ++allocations;
+    if (void* p = malloc(n)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+class timer {
+    typedef std::chrono::high_resolution_clock clock_t;
+    typedef std::chrono::duration<double, std::ratio<1>> second_t;
+
+    std::chrono::time_point<clock_t, second_t> beginning;
+
+  public:
+    timer() : beginning(clock_t::now()) {}
+    double elapsed() const {
+        return std::chrono::duration_cast<second_t>(clock_t::now() - beginning).count();
+    }
+};
+
+// a field with n neighbours, as returned by nbr
+field<double> neighbours(size_t n, double k) {
+    details::field_ids ids;
+    details::field_vals<double> vals;
+    vals.push_back(k);
+    for (size_t i=0; i<n; ++i) {
+        ids.push_back(i);
+        vals.push_back(k + i);
+    }
+    return details::make_field(std::move(ids), std::move(vals));
+}
+
+// the field computations of a round of abf_distance
+double round(size_t n, double k, vector<device_t> const& dom) {
+    field<double> d = neighbours(n, k);
+    field<double> w = neighbours(n, 1);
+    field<double> s = map_hood([] (double x, double y) { return x + y; }, d, w);
+    s = s * 2.0 - d;
+    return details::fold_hood([] (double x, double y) { return x < y ? x : y; }, s, dom);
+}
+
+void experiment(size_t n) {
+    size_t rounds = OPERATIONS / (n+1);
+    double acc = 0;
+    vector<device_t> dom;
+    for (size_t i=0; i<n; ++i) dom.push_back(i);
+    cout << "Experiment with " << n << " neighbours (inline capacity " << FCPP_FIELD_INLINE << ")" << endl;
+    allocations = 0;
+    timer t;
+    for (size_t r=0; r<rounds; ++r) acc += round(n, r, dom);
+    cout << "time:        " << t.elapsed() / rounds * 1000000000 << " ns/round" << endl;
+    cout << "allocations: " << double(allocations) / rounds << " per round" << endl;
+    if (acc == 42) cout << endl;
+}
+
+int main() {
+    for (size_t n : {2, 4, 8, 16, 32})
+        experiment(n);
+}
+
+/*
+ RESULTS (single-core virtual machine)
+
+Experiment with 2 neighbours (inline capacity 0)
+time:        532.133 ns/round
+allocations: 17 per round
+Experiment with 4 neighbours (inline capacity 0)
+time:        761.828 ns/round
+allocations: 24 per round
+Experiment with 8 neighbours (inline capacity 0)
+time:        1058.91 ns/round
+allocations: 31 per round
+Experiment with 16 neighbours (inline capacity 0)
+time:        1482.76 ns/round
+allocations: 38 per round
+Experiment with 32 neighbours (inline capacity 0)
+time:        2118.91 ns/round
+allocations: 45 per round
+Experiment with 2 neighbours (inline capacity 8)
+time:        173.999 ns/round
+allocations: 0 per round
+Experiment with 4 neighbours (inline capacity 8)
+time:        137.658 ns/round
+allocations: 0 per round
+Experiment with 8 neighbours (inline capacity 8)
+time:        169.679 ns/round
+allocations: 0 per round
+Experiment with 16 neighbours (inline capacity 8)
+time:        704.883 ns/round
+allocations: 10 per round
+Experiment with 32 neighbours (inline capacity 8)
+time:        1439.3 ns/round
+allocations: 17 per round
+ */
@@ -0,0 +1,147 @@
+// Compile from the src folder with:
+// g++ -std=c++14 -O3 -I. extras/experiments/fold_hood.cpp
+// for SSE2, and for AVX2 with:
+// g++ -std=c++14 -O3 -mavx2 -I. extras/experiments/fold_hood.cpp
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "lib/data/field.hpp"
+
+#define OPERATIONS 100000000
+
+using namespace std;
+using namespace fcpp;
+
+class timer {
+    typedef std::chrono::high_resolution_clock clock_t;
+    typedef std::chrono::duration<double, std::ratio<1>> second_t;
+
+    std::chrono::time_point<clock_t, second_t> beginning;
+
+  public:
+    timer() : beginning(clock_t::now()) {}
+    double elapsed() const {
+        return std::chrono::duration_cast<second_t>(clock_t::now() - beginning).count();
+    }
+};
+
+// a field with n neighbours, aligned to the domain
+template <typename T>
+field<T> neighbours(size_t n) {
+    details::field_ids ids;
+    details::field_vals<T> vals;
+    vals.push_back(T(1));
+    for (size_t i=0; i<n; ++i) {
+        ids.push_back(i);
+        vals.push_back(T((i * 37) % 101 < 90));
+    }
+    return details::make_field(std::move(ids), std::move(vals));
+}
+
+// throughput in millions of values per second of a fold
+template <typename T, typename F>
+double throughput(F&& op, size_t n) {
+    field<T> f = neighbours<T>(n);
+    vector<device_t> dom;
+    for (size_t i=0; i<n; ++i) dom.push_back(i);
+    size_t rounds = OPERATIONS / n;
+    T acc = T(0);
+    timer t;
+    for (size_t r=0; r<rounds; ++r) {
+        details::self(f, r % n) = T(r % 2);
+        acc = acc + details::fold_hood(op, f, dom);
+    }
+    double res = rounds * n / t.elapsed() / 1000000;
+    static volatile T sink;
+    sink = acc;
+    return res;
+}
+
+template <typename T>
+void experiment(char const* name) {
+    cout << "Experiment with " << name << " (millions of values per second)" << endl;
+    for (size_t n : {8, 32, 128, 512, 4096}) {
+        cout << n << " values:";
+        cout << "\tmin " << throughput<T>([] (T const& x, T const& y) -> T { return std::min(x, y); }, n);
+        cout << " -> " << throughput<T>(common::fold_min<T>{}, n);
+        cout << "\tsum " << throughput<T>([] (T const& x, T const& y) -> T { return x + y; }, n);
+        cout << " -> " << throughput<T>(common::fold_sum<T>{}, n) << endl;
+    }
+}
+
+template <>
+void experiment<bool>(char const* name) {
+    cout << "Experiment with " << name << " (millions of values per second)" << endl;
+    for (size_t n : {8, 32, 128, 512, 4096}) {
+        cout << n << " values:";
+        cout << "\tall " << throughput<bool>([] (bool x, bool y) -> bool { return x and y; }, n);
+        cout << " -> " << throughput<bool>(common::fold_all<bool>{}, n);
+        cout << "\tany " << throughput<bool>([] (bool x, bool y) -> bool { return x or y; }, n);
+        cout << " -> " << throughput<bool>(common::fold_any<bool>{}, n) << endl;
+    }
+}
+
+int main() {
+    experiment<real_t>("real_t");
+    experiment<hops_t>("hops_t");
+    experiment<int>("int");
+    experiment<bool>("bool");
+}
+
+/*
+ RESULTS (single-core virtual machine, scalar lambda -> vectorised operator)
+
+SSE2:
+Experiment with real_t (millions of values per second)
+8 values:	min 283.33 -> 285.75	sum 231.968 -> 328.496
+32 values:	min 293.99 -> 826.539	sum 296.994 -> 889.221
+128 values:	min 333.634 -> 1404.85	sum 287.995 -> 1652.02
+512 values:	min 325.192 -> 1676.94	sum 400.591 -> 2374.61
+4096 values:	min 402.353 -> 1757.71	sum 429.628 -> 2724.26
+Experiment with hops_t (millions of values per second)
+8 values:	min 293.075 -> 367.441	sum 250.243 -> 282.063
+32 values:	min 258.194 -> 842.618	sum 289.377 -> 846.161
+128 values:	min 297.462 -> 2442.44	sum 296.246 -> 2251.23
+512 values:	min 342.952 -> 3644.42	sum 322.823 -> 3258.59
+4096 values:	min 354.672 -> 5011.86	sum 307.672 -> 6719.95
+Experiment with int (millions of values per second)
+8 values:	min 233.166 -> 284.835	sum 232.626 -> 253.996
+32 values:	min 283.814 -> 739.446	sum 351.924 -> 867.398
+128 values:	min 351.821 -> 1175.39	sum 319.287 -> 1798.61
+512 values:	min 322.817 -> 1573.27	sum 334.883 -> 4016
+4096 values:	min 427.663 -> 2017.34	sum 353.062 -> 4713.7
+Experiment with bool (millions of values per second)
+8 values:	all 243.541 -> 265.162	any 253.241 -> 314.172
+32 values:	all 397.518 -> 959.719	any 358.792 -> 938.838
+128 values:	all 386.171 -> 2716.3	any 367.242 -> 3514.96
+512 values:	all 414.139 -> 4770.81	any 319.433 -> 3453
+4096 values:	all 479.844 -> 10459.3	any 472.002 -> 10794.9
+
+AVX2:
+Experiment with real_t (millions of values per second)
+8 values:	min 241.069 -> 226.162	sum 219.498 -> 282.586
+32 values:	min 283.082 -> 649.117	sum 234.974 -> 775.22
+128 values:	min 276.278 -> 1664.12	sum 257.791 -> 1916.31
+512 values:	min 294.372 -> 2440.62	sum 263.68 -> 3124.54
+4096 values:	min 310.321 -> 2806.15	sum 305.998 -> 3158.29
+Experiment with hops_t (millions of values per second)
+8 values:	min 227.977 -> 258.097	sum 198.164 -> 248.211
+32 values:	min 291.033 -> 710.439	sum 239.842 -> 721.165
+128 values:	min 273.739 -> 2212.22	sum 246.741 -> 2112.94
+512 values:	min 306.857 -> 3512.81	sum 267.17 -> 3639.26
+4096 values:	min 437.374 -> 5509.89	sum 355.542 -> 6854.01
+Experiment with int (millions of values per second)
+8 values:	min 303.079 -> 351.349	sum 283.266 -> 306.308
+32 values:	min 368.99 -> 790.312	sum 246.878 -> 796.844
+128 values:	min 319.897 -> 1749.77	sum 280.491 -> 2009.09
+512 values:	min 373.554 -> 4039.21	sum 309.226 -> 3939.09
+4096 values:	min 389.855 -> 4264.83	sum 354.468 -> 5388.73
+Experiment with bool (millions of values per second)
+8 values:	all 236.079 -> 274.586	any 232.686 -> 262.904
+32 values:	all 302.74 -> 613.579	any 385.783 -> 746.957
+128 values:	all 295.296 -> 1620.42	any 256.998 -> 1650.32
+512 values:	all 318.396 -> 3476.23	any 331.29 -> 3666.39
+4096 values:	all 348.356 -> 8057.92	any 339.361 -> 8407.57
+ */
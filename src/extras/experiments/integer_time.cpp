@@ -0,0 +1,81 @@
+// Compile from the src folder with:
+// g++ -std=c++14 -O3 -I. extras/experiments/integer_time.cpp
+
+#define FCPP_TIME_TYPE int64_t
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "lib/component/identifier.hpp"
+
+#define EVENTS 10000000
+
+using namespace std;
+using namespace fcpp;
+
+class timer {
+    typedef std::chrono::high_resolution_clock clock_t;
+    typedef std::chrono::duration<double, std::ratio<1>> second_t;
+
+    std::chrono::time_point<clock_t, second_t> beginning;
+
+  public:
+    timer() : beginning(clock_t::now()) {}
+    double elapsed() const {
+        return std::chrono::duration_cast<second_t>(clock_t::now() - beginning).count();
+    }
+};
+
+// nanoseconds per event of n devices with a period of one second in nanoseconds, random phases and a given jitter
+// (as produced by `sequence::periodic`), popping events as `identifier::net::update` does
+template <typename Q>
+double experiment(size_t n, double jitter) {
+    mt19937_64 rng(42);
+    uniform_int_distribution<times_t> phase(0, 1000000000);
+    uniform_int_distribution<times_t> period(1000000000*(1-jitter), 1000000000*(1+jitter));
+    // periods are drawn in advance, to time only the queue
+    vector<times_t> periods(1 << 16);
+    for (times_t& p : periods) p = period(rng);
+    Q q;
+    for (size_t i = 0; i < n; ++i) q.push(phase(rng), device_t(i));
+    size_t events = 0, k = 0;
+    timer t;
+    while (events < EVENTS) {
+        times_t now = q.next();
+        for (device_t d : q.pop(now)) {
+            q.push(now + periods[k++ & (periods.size()-1)], d);
+            ++events;
+        }
+    }
+    return t.elapsed() / events * 1000000000;
+}
+
+int main() {
+    for (double jitter : {0.0, 0.1}) {
+        cout << "Nanoseconds per event with integral times and period jitter " << jitter << " (priority queue / map / calendar queue / radix heap)" << endl;
+        for (size_t n : {1000, 100000, 1000000}) {
+            cout << n << " devices:\t" << experiment<component::details::times_queue<false>>(n, jitter);
+            cout << " / " << experiment<component::details::times_queue<true>>(n, jitter);
+            cout << " / " << experiment<component::details::calendar_queue>(n, jitter);
+            cout << " / " << experiment<component::details::radix_queue<times_t>>(n, jitter) << endl;
+        }
+    }
+}
+
+/*
+ RESULTS (single-core virtual machine)
+
+Nanoseconds per event with integral times and period jitter 0 (priority queue / map / calendar queue / radix heap)
+1000 devices:	138.182 / 107.667 / 54.3104 / 99.769
+100000 devices:	171.711 / 269.356 / 101.683 / 145.801
+1000000 devices:	365.81 / 296.407 / 141.275 / 153.377
+Nanoseconds per event with integral times and period jitter 0.1 (priority queue / map / calendar queue / radix heap)
+1000 devices:	131.901 / 203.496 / 71.8435 / 164.838
+100000 devices:	222.911 / 492.635 / 204.994 / 202.896
+1000000 devices:	409.465 / 1343.49 / 385.213 / 230.144
+
+ The radix heap does not depend on the regularity of schedules, and wins with many devices on jittered
+ schedules, where the calendar queue and the priority queue both suffer from cache misses.
+ */
@@ -0,0 +1,98 @@
+// Compile from the src folder with:
+// g++ -std=c++14 -O3 -I. extras/experiments/metric_expiry.cpp
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "lib/internal/context.hpp"
+
+#define MESSAGES 4000000
+
+using namespace std;
+using namespace fcpp;
+
+class timer {
+    typedef std::chrono::high_resolution_clock clock_t;
+    typedef std::chrono::duration<double, std::ratio<1>> second_t;
+
+    std::chrono::time_point<clock_t, second_t> beginning;
+
+  public:
+    timer() : beginning(clock_t::now()) {}
+    double elapsed() const {
+        return std::chrono::duration_cast<second_t>(clock_t::now() - beginning).count();
+    }
+};
+
+// metric growing by one at every round, as `metric::retain` with rounds of unit length
+struct aging {
+    template <typename N>
+    double update(double const& r, N const&) const {
+        return r == 0 ? 0 : r + 1;
+    }
+};
+
+// the same metric, declaring its linear growth
+struct linear_aging : public aging {
+    template <typename N>
+    double shift(N const&) const {
+        return 1;
+    }
+};
+
+// microseconds per round of a device with n neighbours, a fraction of which sends in every round
+template <typename M, bool wheel>
+double experiment(size_t n, double senders, double retain) {
+    using context_type = internal::context<false, true, false, false, false, false, wheel, double, int>;
+    mt19937_64 rng(42);
+    uniform_real_distribution<double> coin(0, 1);
+    typename context_type::export_type e;
+    for (trace_t t = 0; t < 20; ++t) e->insert(t, int(t));
+    // senders are drawn in advance, to time only the context
+    vector<vector<device_t>> hoods(97);
+    for (auto& h : hoods)
+        for (device_t d = 1; d <= n; ++d)
+            if (coin(rng) < senders) h.push_back(d);
+    context_type c;
+    size_t rounds = MESSAGES / n, acc = 0;
+    timer t;
+    for (size_t r = 0; r < rounds; ++r) {
+        for (device_t d : hoods[r % hoods.size()]) c.insert(d, e, 0.5, retain, 0);
+        c.freeze(std::numeric_limits<device_t>::max(), 0);
+        acc += c.size(0);
+        c.unfreeze(0, M{}, retain);
+    }
+    if (acc == 42) cout << endl;
+    return t.elapsed() / rounds * 1000000;
+}
+
+int main() {
+    for (double retain : {10, 100}) {
+        cout << "Microseconds per round with messages retained for " << retain << " rounds (scan / timing wheel)" << endl;
+        for (size_t n : {10, 100, 1000}) {
+            cout << n << " neighbours:";
+            for (double senders : {1.0, 0.5, 0.1, 0.01})
+                cout << "\tsending " << senders << " " << experiment<aging, false>(n, senders, retain) << " / " << experiment<linear_aging, true>(n, senders, retain);
+            cout << endl;
+        }
+    }
+}
+
+/*
+ RESULTS (single-core virtual machine)
+
+Microseconds per round with messages retained for 10 rounds (scan / timing wheel)
+10 neighbours:	sending 1 0.288615 / 0.32817	sending 0.5 0.208157 / 0.179616	sending 0.1 0.0836294 / 0.104739	sending 0.01 0.0179482 / 0.0283917
+100 neighbours:	sending 1 3.33311 / 3.41672	sending 0.5 2.23519 / 2.71394	sending 0.1 0.926061 / 1.51142	sending 0.01 0.161229 / 0.18249
+1000 neighbours:	sending 1 69.8468 / 82.2896	sending 0.5 53.2499 / 69.315	sending 0.1 19.5194 / 31.2947	sending 0.01 1.48966 / 2.06598
+Microseconds per round with messages retained for 100 rounds (scan / timing wheel)
+10 neighbours:	sending 1 0.311684 / 0.303197	sending 0.5 0.180003 / 0.183173	sending 0.1 0.0659846 / 0.0493242	sending 0.01 0.0291219 / 0.029424
+100 neighbours:	sending 1 3.45044 / 3.1778	sending 0.5 2.14263 / 1.7926	sending 0.1 0.616941 / 0.352307	sending 0.01 0.211693 / 0.0771904
+1000 neighbours:	sending 1 70.7939 / 71.4517	sending 0.5 53.6602 / 49.6532	sending 0.1 14.2428 / 13.2998	sending 0.01 2.29517 / 1.40243
+
+ Every export is still checked once per retain time (when its queued expiry is reached), through a
+ binary search instead of a sequential scan: the wheel pays off only with retain times of many rounds.
+ */
@@ -0,0 +1,103 @@
+// Compile from the src folder with:
+// g++ -std=c++14 -O3 -I. extras/experiments/neighbour_pruning.cpp
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <iostream>
+
+#include "lib/fcpp.hpp"
+
+#define DEVICES 1000
+#define SIDE    2000
+#define END     2000
+
+using namespace std;
+using namespace fcpp;
+using namespace component::tags;
+
+class timer {
+    typedef std::chrono::high_resolution_clock clock_t;
+    typedef std::chrono::duration<double, std::ratio<1>> second_t;
+
+    std::chrono::time_point<clock_t, second_t> beginning;
+
+  public:
+    timer() : beginning(clock_t::now()) {}
+    double elapsed() const {
+        return std::chrono::duration_cast<second_t>(clock_t::now() - beginning).count();
+    }
+};
+
+namespace fcpp {
+namespace coordination {
+    // devices walking at random, counting their neighbours
+    MAIN() {
+        rectangle_walk(CALL, make_vec(0,0), make_vec(SIDE,SIDE), 10, 1);
+        count_hood(CALL);
+    }
+    FUN_EXPORT main_t = common::export_list<rectangle_walk_t<2>>;
+}
+}
+
+DECLARE_OPTIONS(options,
+    program<coordination::main>,
+    exports<coordination::main_t>,
+    round_schedule<sequence::periodic_n<1, 1, 1, END>>,
+    spawn_schedule<sequence::multiple_n<DEVICES, 0>>,
+    init<x, distribution::rect_n<1, 0, 0, SIDE, SIDE>>,
+    connector<connect::fixed<100>>
+);
+
+using net_t = component::batch_simulator<options>::net;
+
+int main() {
+    std::stringstream log;
+    net_t network{common::make_tagged_tuple<output>(&log)};
+    timer t;
+    cout << "time\tcontext\tfield entries\tmax RSS (MB)\tseconds" << endl;
+    for (times_t e = END/10; e <= END; e += END/10) {
+        network.run(e);
+        size_t context = 0, entries = 0;
+        for (device_t i = 0; i < DEVICES; ++i) {
+            auto const& n = network.node_at(i);
+            context += n.size();
+            entries += details::get_ids(n.message_time()).size();
+            entries += details::get_ids(n.nbr_dist()).size();
+            entries += details::get_ids(n.nbr_vec()).size();
+        }
+        rusage r;
+        getrusage(RUSAGE_SELF, &r);
+        cout << e << "\t" << double(context) / DEVICES << "\t" << double(entries) / DEVICES << "\t\t" << r.ru_maxrss / 1024.0 << "\t\t" << t.elapsed() << endl;
+    }
+}
+
+/*
+ RESULTS (single-core virtual machine, per-device averages)
+
+Without pruning (fields only grow):
+time	context	field entries	max RSS (MB)	seconds
+200	13.763	537.906		20.2734		2.46736
+400	2.004	943.626		27.0234		5.6377
+600	1.803	1284.37		33.0234		9.43314
+800	1.769	1569.48		38.0234		13.7929
+1000	14.009	1805.65		42.3984		18.8216
+1200	1.619	2007.73		46.2734		24.7191
+1400	1.454	2171.45		49.3984		30.0063
+1600	1.396	2306.65		52.1484		35.1342
+1800	14.111	2425.39		54.5234		40.451
+2000	1.291	2520.52		56.5234		45.9071
+
+With pruning at context freeze:
+time	context	field entries	max RSS (MB)	seconds
+200	13.763	36.018		12.625		1.8385
+400	2.004	34.023		12.625		3.55529
+600	1.803	34.872		12.625		5.38767
+800	1.769	34.776		12.625		7.26853
+1000	14.009	38.304		12.625		9.01774
+1200	1.619	34.014		12.625		11.2046
+1400	1.454	34.92		12.625		12.867
+1600	1.396	34.842		12.625		14.673
+1800	14.111	39.702		12.75		16.7566
+2000	1.291	34.413		12.75		18.8585
+ */
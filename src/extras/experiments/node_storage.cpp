@@ -0,0 +1,132 @@
+// Compile from the src folder with:
+// g++ -std=c++14 -O3 -I. extras/experiments/node_storage.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "lib/common/random_access_map.hpp"
+#include "lib/common/slab_map.hpp"
+#include "lib/settings.hpp"
+
+#define ACCESSES 20000000
+
+using namespace std;
+using namespace fcpp;
+
+class timer {
+    typedef std::chrono::high_resolution_clock clock_t;
+    typedef std::chrono::duration<double, std::ratio<1>> second_t;
+
+    std::chrono::time_point<clock_t, second_t> beginning;
+
+  public:
+    timer() : beginning(clock_t::now()) {}
+    double elapsed() const {
+        return std::chrono::duration_cast<second_t>(clock_t::now() - beginning).count();
+    }
+};
+
+// a non-movable stand-in for a node, with its state spread over a few cache lines
+struct node {
+    node(device_t uid) : uid(uid) {}
+    node(const node&) = delete;
+    void update() {
+        for (size_t i = 0; i < 16; ++i) state[i] += state[(i+1) & 15] + uid;
+    }
+    const device_t uid;
+    common::mutex<true> mutex;
+    size_t state[16] = {};
+};
+
+// random access map storing nodes through pointers (as it needs to move values)
+struct ptr_map : public common::random_access_map<device_t, std::unique_ptr<node>> {
+    void emplace(device_t uid) {
+        common::random_access_map<device_t, std::unique_ptr<node>>::emplace(uid, new node(uid));
+    }
+    static node& get(value_type& p) {
+        return *p.second;
+    }
+};
+
+// slab map storing nodes in place
+struct slab : public common::slab_map<device_t, node> {
+    void emplace(device_t uid) {
+        common::slab_map<device_t, node>::emplace(std::piecewise_construct, std::make_tuple(uid), std::make_tuple(uid));
+    }
+    static node& get(value_type& p) {
+        return p.second;
+    }
+};
+
+// nanoseconds per node for iterating, updating by uid and erasing and inserting nodes
+template <typename M>
+tuple<double, double, double> experiment(size_t n) {
+    mt19937_64 rng(42);
+    M m;
+    vector<device_t> uids;
+    for (size_t i = 0; i < n; ++i) {
+        m.emplace(device_t(i));
+        uids.push_back(device_t(i));
+    }
+    // churn before measuring, so that nodes are scattered as in a long simulation
+    for (size_t i = 0; i < n; ++i) {
+        size_t k = rng() % n;
+        m.erase(uids[k]);
+        uids[k] += n;
+        m.emplace(uids[k]);
+    }
+    size_t sum = 0, rep = ACCESSES / n;
+    timer t1;
+    for (size_t r = 0; r < rep; ++r)
+        for (auto& p : m) M::get(p).update();
+    double iter = t1.elapsed() / (rep * n) * 1000000000;
+    shuffle(uids.begin(), uids.end(), rng);
+    timer t2;
+    for (size_t r = 0; r < rep; ++r)
+        for (device_t uid : uids) {
+            node& x = M::get(*m.find(uid));
+            common::lock_guard<true> l(x.mutex);
+            x.update();
+        }
+    double upd = t2.elapsed() / (rep * n) * 1000000000;
+    timer t3;
+    for (size_t r = 0; r < rep; ++r)
+        for (size_t i = 0; i < n; ++i) {
+            size_t k = rng() % n;
+            m.erase(uids[k]);
+            uids[k] += n;
+            m.emplace(uids[k]);
+        }
+    double churn = t3.elapsed() / (rep * n) * 1000000000;
+    for (auto& p : m) sum += M::get(p).state[0];
+    if (sum == 42) cout << endl;
+    return make_tuple(iter, upd, churn);
+}
+
+int main() {
+    cout << "Nanoseconds per node for iteration / update by uid / churn (random access map / slab map)" << endl;
+    for (size_t n : {1000, 100000, 1000000}) {
+        auto x = experiment<ptr_map>(n);
+        auto y = experiment<slab>(n);
+        cout << n << " nodes:\t" << get<0>(x) << " / " << get<0>(y);
+        cout << "\t" << get<1>(x) << " / " << get<1>(y);
+        cout << "\t" << get<2>(x) << " / " << get<2>(y) << endl;
+    }
+}
+
+/*
+ RESULTS (single-core virtual machine)
+
+Nanoseconds per node for iteration / update by uid / churn (random access map / slab map)
+1000 nodes:	9.3438 / 6.39656	55.458 / 29.3221	357.286 / 131.591
+100000 nodes:	21.4587 / 15.2532	619.581 / 212.583	1458.61 / 410.429
+1000000 nodes:	79.1147 / 54.7506	754.114 / 529.086	2290.13 / 1065.42
+
+ Slabs keep nodes in few contiguous blocks whatever the churn, and erasing does not free memory
+ but only recycles slots, so that all three workloads gain (especially churn, dominated by allocation).
+ */
@@ -0,0 +1,115 @@
+// Compile from the src folder with:
+// g++ -std=c++14 -O3 -I. extras/experiments/online_context.cpp
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "lib/internal/context.hpp"
+
+#define MESSAGES 2000000
+#define CONTEXTS 200
+
+using namespace std;
+using namespace fcpp;
+
+class timer {
+    typedef std::chrono::high_resolution_clock clock_t;
+    typedef std::chrono::duration<double, std::ratio<1>> second_t;
+
+    std::chrono::time_point<clock_t, second_t> beginning;
+
+  public:
+    timer() : beginning(clock_t::now()) {}
+    double elapsed() const {
+        return std::chrono::duration_cast<second_t>(clock_t::now() - beginning).count();
+    }
+};
+
+// metric growing with the age of messages, by a given step every round
+struct metric {
+    double step;
+
+    template <typename... Ts>
+    double update(double const& r, Ts const&...) const {
+        return r + step;
+    }
+};
+
+using context_type = internal::context<true, true, false, false, false, false, false, double, int>;
+
+// fills a context with messages from a neighbourhood, in arbitrary order and with random metrics
+void receive(context_type& c, vector<device_t>& hood, context_type::export_type const& e, device_t hoodsize, mt19937_64& rng) {
+    shuffle(hood.begin(), hood.end(), rng);
+    for (device_t d : hood)
+        c.insert(d, e, uniform_real_distribution<double>(0, 1)(rng), 1.5, hoodsize);
+}
+
+// microseconds per round of a device with n neighbours, keeping at most hoodsize of them
+double experiment(size_t n, device_t hoodsize, double step) {
+    mt19937_64 rng(42);
+    vector<device_t> hood(n);
+    for (size_t i = 0; i < n; ++i) hood[i] = 2*i+1;
+    context_type::export_type e;
+    for (trace_t t = 0; t < 20; ++t) e->insert(t, int(t));
+    context_type c;
+    size_t rounds = MESSAGES / n, acc = 0;
+    timer t;
+    for (size_t r = 0; r < rounds; ++r) {
+        receive(c, hood, e, hoodsize, rng);
+        c.freeze(hoodsize, 0);
+        acc += c.align(0).size();
+        for (trace_t t = 0; t < 20; t += 4)
+            acc += details::get_ids(c.nbr(t, 0, 0)).size();
+        c.unfreeze(0, metric{step}, 1.5);
+    }
+    if (acc == 42) cout << endl;
+    return t.elapsed() / rounds * 1000000;
+}
+
+// megabytes of memory taken by contexts with n neighbours each
+double memory(size_t n) {
+    mt19937_64 rng(42);
+    vector<device_t> hood(n);
+    for (size_t i = 0; i < n; ++i) hood[i] = 2*i+1;
+    context_type::export_type e;
+    rusage before, after;
+    getrusage(RUSAGE_SELF, &before);
+    vector<context_type> v(CONTEXTS);
+    for (auto& c : v) receive(c, hood, e, n, rng);
+    getrusage(RUSAGE_SELF, &after);
+    return (after.ru_maxrss - before.ru_maxrss) / 1024.0;
+}
+
+int main() {
+    cout << "Microseconds per round (all neighbours / hoodsize 10), with stable or half-renewed neighbourhoods" << endl;
+    cout << "MB of memory for " << CONTEXTS << " contexts" << endl;
+    for (size_t n : {10, 100, 300, 1000}) {
+        cout << n << " neighbours:\tstable " << experiment(n, n, 0.25) << " / " << experiment(n, 10, 0.25);
+        cout << "\trenewed " << experiment(n, n, 1) << " / " << experiment(n, 10, 1);
+        cout << "\t" << memory(n) << " MB" << endl;
+    }
+}
+
+/*
+ RESULTS (single-core virtual machine)
+
+Hash maps of exports and metrics, with a lazy priority queue and a sorted copy built at freeze:
+Microseconds per round (all neighbours / hoodsize 10), with stable or half-renewed neighbourhoods
+MB of memory for 200 contexts
+10 neighbours:	stable 2.30171 / 2.07996	renewed 2.56944 / 3.02232	0.25 MB
+100 neighbours:	stable 25.5359 / 25.9748	renewed 39.8658 / 19.6882	1.875 MB
+300 neighbours:	stable 51.2706 / 51.368	renewed 94.3367 / 45.7356	4.91016 MB
+1000 neighbours:	stable 188.797 / 153.655	renewed 316.698 / 145.43	11.8281 MB
+
+Contiguous exports, sorted array of devices and indexed heap:
+Microseconds per round (all neighbours / hoodsize 10), with stable or half-renewed neighbourhoods
+MB of memory for 200 contexts
+10 neighbours:	stable 1.38708 / 1.36416	renewed 1.64572 / 1.63256	0.25 MB
+100 neighbours:	stable 13.8598 / 12.5019	renewed 17.215 / 12.4321	0.875 MB
+300 neighbours:	stable 51.9795 / 33.7907	renewed 80.3719 / 37.2594	2.72266 MB
+1000 neighbours:	stable 190.649 / 129.612	renewed 353.5 / 112.6	4.125 MB
+ */
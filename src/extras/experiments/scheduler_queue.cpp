@@ -0,0 +1,78 @@
+// Compile from the src folder with:
+// g++ -std=c++14 -O3 -I. extras/experiments/scheduler_queue.cpp
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "lib/component/identifier.hpp"
+
+#define EVENTS 10000000
+
+using namespace std;
+using namespace fcpp;
+
+class timer {
+    typedef std::chrono::high_resolution_clock clock_t;
+    typedef std::chrono::duration<double, std::ratio<1>> second_t;
+
+    std::chrono::time_point<clock_t, second_t> beginning;
+
+  public:
+    timer() : beginning(clock_t::now()) {}
+    double elapsed() const {
+        return std::chrono::duration_cast<second_t>(clock_t::now() - beginning).count();
+    }
+};
+
+// nanoseconds per event of n devices with unit period, random phases and a given jitter
+// (as produced by `sequence::periodic`), popping events as `identifier::net::update` does
+template <typename Q>
+double experiment(size_t n, double jitter) {
+    mt19937_64 rng(42);
+    uniform_real_distribution<times_t> phase(0, 1);
+    uniform_real_distribution<times_t> period(1-jitter, 1+jitter);
+    // periods are drawn in advance, to time only the queue
+    vector<times_t> periods(1 << 16);
+    for (times_t& p : periods) p = period(rng);
+    Q q;
+    for (size_t i = 0; i < n; ++i) q.push(phase(rng), device_t(i));
+    size_t events = 0, k = 0;
+    timer t;
+    while (events < EVENTS) {
+        times_t now = q.next();
+        for (device_t d : q.pop(now)) {
+            q.push(now + periods[k++ & (periods.size()-1)], d);
+            ++events;
+        }
+    }
+    return t.elapsed() / events * 1000000000;
+}
+
+int main() {
+    for (double jitter : {0.0, 0.1}) {
+        cout << "Nanoseconds per event with period jitter " << jitter << " (priority queue / map / calendar queue)" << endl;
+        for (size_t n : {1000, 100000, 1000000}) {
+            cout << n << " devices:\t" << experiment<component::details::times_queue<false>>(n, jitter);
+            cout << " / " << experiment<component::details::times_queue<true>>(n, jitter);
+            cout << " / " << experiment<component::details::calendar_queue>(n, jitter) << endl;
+        }
+    }
+}
+
+/*
+ RESULTS (single-core virtual machine)
+
+Nanoseconds per event with period jitter 0 (priority queue / map / calendar queue)
+1000 devices:	124.642 / 87.6347 / 52.1811
+100000 devices:	191.491 / 210.067 / 86.4075
+1000000 devices:	383.781 / 317.172 / 187.99
+Nanoseconds per event with period jitter 0.1 (priority queue / map / calendar queue)
+1000 devices:	150.714 / 211.813 / 91.5759
+100000 devices:	252.138 / 523.598 / 196.511
+1000000 devices:	418.487 / 1299.01 / 407.944
+
+ The calendar queue does constant work per event, but with a million devices every push lands in a
+ bucket far from the cache: on jittered schedules this evens out the logarithmic cost of the heap.
+ */
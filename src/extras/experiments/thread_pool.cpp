@@ -0,0 +1,93 @@
+// Compile from the src folder with:
+// g++ -std=c++14 -O3 -I. -pthread extras/experiments/thread_pool.cpp
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "lib/common/algorithm.hpp"
+
+#define EVENTS 2000000
+#define THREADS 4
+
+using namespace std;
+
+class timer {
+    typedef std::chrono::high_resolution_clock clock_t;
+    typedef std::chrono::duration<double, std::ratio<1>> second_t;
+
+    std::chrono::time_point<clock_t, second_t> beginning;
+
+  public:
+    timer() : beginning(clock_t::now()) {}
+    double elapsed() const {
+        return std::chrono::duration_cast<second_t>(clock_t::now() - beginning).count();
+    }
+};
+
+// parallel for spawning a fresh set of threads at every call (as before the thread pool)
+template <typename F>
+void spawning_for(size_t num, size_t len, F&& f) {
+    std::vector<std::thread> pool;
+    pool.reserve(num);
+    for (size_t t=0; t<std::min(num,len); ++t)
+        pool.emplace_back([=,&f] () {
+            for (size_t i=t; i<len; i+=num) f(i,t);
+        });
+    for (std::thread& t : pool) t.join();
+}
+
+vector<double> state(4096, 1.0);
+
+// a light event, comparable to a small round
+void event(size_t i, size_t) {
+    double& x = state[i];
+    for (int k=0; k<50; ++k) x = sqrt(x + k);
+}
+
+void experiment(size_t batch) {
+    size_t batches = EVENTS / batch;
+    cout << "Experiment with batch size " << batch << endl;
+    {
+        timer t;
+        for (size_t b=0; b<batches; ++b)
+            spawning_for(THREADS, batch, event);
+        cout << "spawning threads: " << batches * batch / t.elapsed() << " events/sec" << endl;
+    }
+    {
+        timer t;
+        for (size_t b=0; b<batches; ++b)
+            fcpp::common::parallel_for(fcpp::common::tags::parallel_execution(THREADS), batch, event);
+        cout << "thread pool:      " << batches * batch / t.elapsed() << " events/sec" << endl;
+    }
+}
+
+int main() {
+    experiment(4);
+    experiment(16);
+    experiment(64);
+    experiment(256);
+    experiment(4096);
+}
+
+/*
+ RESULTS (single-core virtual machine, 4 threads)
+
+Experiment with batch size 4
+spawning threads: 67390.8 events/sec
+thread pool:      727186 events/sec
+Experiment with batch size 16
+spawning threads: 236308 events/sec
+thread pool:      2.06213e+06 events/sec
+Experiment with batch size 64
+spawning threads: 955052 events/sec
+thread pool:      3.17361e+06 events/sec
+Experiment with batch size 256
+spawning threads: 2.31825e+06 events/sec
+thread pool:      4.24415e+06 events/sec
+Experiment with batch size 4096
+spawning threads: 4.27455e+06 events/sec
+thread pool:      4.641e+06 events/sec
+ */
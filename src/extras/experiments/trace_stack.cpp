@@ -0,0 +1,98 @@
+// Compile from the src folder with:
+// g++ -std=c++14 -O3 -I. extras/experiments/trace_stack.cpp
+
+#include <chrono>
+#include <iostream>
+
+#include "lib/beautify.hpp"
+#include "lib/internal/trace.hpp"
+
+#define CALLS 200000000
+
+using namespace std;
+using namespace fcpp;
+
+class timer {
+    typedef std::chrono::high_resolution_clock clock_t;
+    typedef std::chrono::duration<double, std::ratio<1>> second_t;
+
+    std::chrono::time_point<clock_t, second_t> beginning;
+
+  public:
+    timer() : beginning(clock_t::now()) {}
+    double elapsed() const {
+        return std::chrono::duration_cast<second_t>(clock_t::now() - beginning).count();
+    }
+};
+
+// minimal node, holding only the stack trace
+struct node_type {
+    internal::trace stack_trace;
+};
+
+// a chain of nested aggregate function calls
+FUN trace_t chain(ARGS, int depth) { CODE
+    if (depth == 0) return node.stack_trace.hash(0);
+    return chain(CALL, depth-1) + 1;
+}
+
+// a chain of nested aggregate function calls, with a loop at every level
+FUN trace_t looped(ARGS, int depth) { CODE
+    if (depth == 0) return node.stack_trace.hash(0);
+    trace_t acc = 0;
+    for (LOOP(i, 0); i < 2; ++i)
+        acc += i == 0 ? node.stack_trace.hash(0) : looped(CALL, depth-1);
+    return acc;
+}
+
+// nanoseconds per trace push and pop, with a node created every round or reused
+template <typename F>
+double overhead(F&& f, int depth, bool fresh) {
+    size_t rounds = CALLS / depth;
+    trace_t acc = 0;
+    node_type reused;
+    timer t;
+    for (size_t r=0; r<rounds; ++r) {
+        if (fresh) {
+            node_type node;
+            acc += f(node, depth);
+        } else acc += f(reused, depth);
+    }
+    double res = t.elapsed() / rounds / depth * 1000000000;
+    static volatile trace_t sink;
+    sink = acc;
+    return res;
+}
+
+int main() {
+    cout << "Nanoseconds per call (reused node / fresh node)" << endl;
+    for (int depth : {4, 16, 64}) {
+        cout << "depth " << depth << ":";
+        cout << "\tFUN chain " << overhead([](node_type& node, int d) {
+            return chain(node, 0, d);
+        }, depth, false) << " / " << overhead([](node_type& node, int d) {
+            return chain(node, 0, d);
+        }, depth, true);
+        cout << "\tFUN with LOOP " << overhead([](node_type& node, int d) {
+            return looped(node, 0, d);
+        }, depth, false) << " / " << overhead([](node_type& node, int d) {
+            return looped(node, 0, d);
+        }, depth, true) << endl;
+    }
+}
+
+/*
+ RESULTS (single-core virtual machine)
+
+Heap-allocated stack trace (std::vector):
+Nanoseconds per call (reused node / fresh node)
+depth 4:	FUN chain 9.70905 / 38.5494	FUN with LOOP 17.9975 / 50.66
+depth 16:	FUN chain 9.29042 / 20.3608	FUN with LOOP 16.8893 / 31.1648
+depth 64:	FUN chain 16.1689 / 21.8398	FUN with LOOP 26.0834 / 35.0868
+
+Inline stack trace of FCPP_TRACE_DEPTH elements:
+Nanoseconds per call (reused node / fresh node)
+depth 4:	FUN chain 7.11826 / 12.2559	FUN with LOOP 16.7801 / 14.6411
+depth 16:	FUN chain 6.95443 / 7.89752	FUN with LOOP 21.1276 / 15.9094
+depth 64:	FUN chain 14.9483 / 15.027	FUN with LOOP 24.1796 / 24.7708
+ */
@@ -10,6 +10,7 @@
 
 #include <cmath>
 
+#include <atomic>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
@@ -19,6 +20,7 @@
 #include "lib/common/serialize.hpp"
 #include "lib/component/base.hpp"
 #include "lib/data/field.hpp"
+#include "lib/internal/field_builder.hpp"
 #include "lib/internal/twin.hpp"
 #include "lib/option/distribution.hpp"
 
@@ -54,7 +56,7 @@ namespace tags {
     template <bool b>
     struct symmetric;
 
-    //! @brief Declaration flag associating to whether the topology of the graph is static. For FUTURE use.
+    //! @brief Declaration flag associating to whether the topology of the graph is static.
     template <bool b>
     struct static_topology;
 }
@@ -72,6 +74,10 @@ namespace tags {
  * <b>Declaration flags:</b>
  * - \ref tags::message_size defines whether message sizes should be emulated (defaults to false).
  * - \ref tags::parallel defines whether parallelism is enabled (defaults to \ref FCPP_PARALLEL).
+ * - \ref tags::static_topology defines whether messages are sent through a compressed adjacency of the graph, rebuilt only when arcs or nodes change (defaults to false).
+ *
+ * With a static topology, the adjacency is rebuilt at the first net update after a change,
+ * and messages are sent through the lists of neighbours until then. It requires a parent \ref identifier component.
  */
 template <class... Ts>
 struct graph_connector {
@@ -84,6 +90,9 @@ struct graph_connector {
     //! @brief Whether the neighbour relation is symmetric (defaults to true).
     constexpr static bool symmetric = common::option_flag<tags::symmetric, true, Ts...>;
 
+    //! @brief Whether the topology of the graph is static.
+    constexpr static bool static_topology = common::option_flag<tags::static_topology, false, Ts...>;
+
     //! @brief Delay generator for sending messages after rounds.
     using delay_type = common::option_type<tags::delay, distribution::constant_n<times_t, 0>, Ts...>;
 
@@ -100,10 +109,15 @@ struct graph_connector {
     struct component : public P {
         DECLARE_COMPONENT(connector);
         CHECK_COMPONENT(randomizer);
-        CHECK_COMPONENT(identifier);
+        REQUIRE_COMPONENT_IF(connector,identifier,static_topology);
+
+        class net;
 
         //! @brief The local part of the component.
         class node : public P::node {
+            //! @brief The net can access the compressed adjacency.
+            friend class net;
+
           public: // visible by net objects and the main program
             //@{
             /**
@@ -115,20 +129,24 @@ struct graph_connector {
             template <typename S, typename T>
             node(typename F::net& n, const common::tagged_tuple<S,T>& t) : P::node(n,t), m_delay(get_generator(has_randomizer<P>{}, *this),t), m_nbr_msg_size(0) {
                 m_send = TIME_MAX;
+                P::node::net.topology_changed();
             }
 
-            //! @brief Destructor leaving the corresponding cell.
+            //! @brief Destructor invalidating the adjacency.
             ~node() {
+                P::node::net.topology_changed();
             }
 
             void connect(typename F::node *n) {
                 m_neighbours.first().emplace(n->uid,n);
                 n->m_neighbours.second().emplace(P::node::uid,&P::node::as_final());
+                P::node::net.topology_changed();
             }
 
             void disconnect(device_t i) {
                 (m_neighbours.first()[i])->m_neighbours.second().erase(P::node::uid);
                 m_neighbours.first().erase(i);
+                P::node::net.topology_changed();
             }
 
             bool connected(device_t i) const {
@@ -152,12 +170,12 @@ struct graph_connector {
 
             //! @brief Size of last message sent.
             size_t msg_size() const {
-                return fcpp::details::self(m_nbr_msg_size.front(), P::node::uid);
+                return fcpp::details::self(m_nbr_msg_size.front().get(), P::node::uid);
             }
 
             //! @brief Sizes of messages received from neighbours.
             field<size_t> const& nbr_msg_size() const {
-                return m_nbr_msg_size.front();
+                return m_nbr_msg_size.front().get();
             }
 
             /**
@@ -181,7 +199,13 @@ struct graph_connector {
                     P::node::as_final().send(t, m);
                     P::node::as_final().receive(t, P::node::uid, m);
                     common::unlock_guard<parallel> u(P::node::mutex);
-                    for (std::pair<device_t, typename F::node*> p : m_neighbours.first()) {
+                    if (static_topology and P::node::net.topology_ready()) {
+                        typename F::node* const* adj = P::node::net.adjacency().data();
+                        for (size_t i = m_adjacency_begin; i < m_adjacency_end; ++i) {
+                            common::lock_guard<parallel> l(adj[i]->mutex);
+                            adj[i]->receive(t, P::node::uid, m);
+                        }
+                    } else for (std::pair<device_t, typename F::node*> p : m_neighbours.first()) {
                         typename F::node *n = p.second;
                         if (n != this) {
                             common::lock_guard<parallel> l(n->mutex);
@@ -195,9 +219,16 @@ struct graph_connector {
             //! @brief Performs computations at round start with current time `t`.
             void round_start(times_t t) {
                 m_send = t + m_delay(get_generator(has_randomizer<P>{}, *this));
+                m_nbr_msg_size.front().merge();
                 P::node::round_start(t);
             }
 
+            //! @brief Restricts data about neighbours to a sorted domain of devices (called when the domain is frozen).
+            void align_neighbours(std::vector<device_t> const& dom) {
+                m_nbr_msg_size.front().align(dom);
+                P::node::align_neighbours(dom);
+            }
+
             //! @brief Performs computations at round end with current time `t`.
             void round_end(times_t t) {
                 P::node::round_end(t);
@@ -222,7 +253,7 @@ struct graph_connector {
             void receive_size(common::bool_pack<true>, device_t d, const common::tagged_tuple<S,T>& m) {
                 common::osstream os;
                 os << m;
-                fcpp::details::self(m_nbr_msg_size.front(), d) = os.size();
+                m_nbr_msg_size.front().set(d, os.size());
             }
 
             //! @brief Returns the `randomizer` generator if available.
@@ -246,8 +277,11 @@ struct graph_connector {
             //! @brief Time of the next send-message event.
             times_t m_send;
 
+            //! @brief The range of neighbours in the compressed adjacency.
+            size_t m_adjacency_begin = 0, m_adjacency_end = 0;
+
             //! @brief Sizes of messages received from neighbours.
-            common::option<field<size_t>, message_size> m_nbr_msg_size;
+            common::option<internal::field_builder<size_t>, message_size> m_nbr_msg_size;
         };
 
         //! @brief The global part of the component.
@@ -262,7 +296,45 @@ struct graph_connector {
                 maybe_clear(has_identifier<P>{}, *this);
             }
 
+            //! @brief Updates the internal status of net component (rebuilding the adjacency if needed).
+            void update() {
+                if (static_topology and not m_topology_ready.load(std::memory_order_acquire))
+                    build_topology(has_identifier<P>{});
+                P::net::update();
+            }
+
+            //! @brief Records that arcs or nodes changed, so that the adjacency is rebuilt at the next update.
+            inline void topology_changed() {
+                m_topology_ready.store(false, std::memory_order_release);
+            }
+
+            //! @brief Whether the adjacency reflects the current graph.
+            inline bool topology_ready() const {
+                return m_topology_ready.load(std::memory_order_acquire);
+            }
+
+            //! @brief The compressed adjacency, listing the neighbours of every node in a contiguous range.
+            std::vector<typename F::node*> const& adjacency() const {
+                return m_adjacency;
+            }
+
           private: // implementation details
+            //! @brief Rebuilds the compressed adjacency from the lists of neighbours of nodes.
+            void build_topology(std::true_type) {
+                m_adjacency.clear();
+                for (auto it = P::net::node_begin(); it != P::net::node_end(); ++it) {
+                    typename F::node& n = it->second;
+                    n.m_adjacency_begin = m_adjacency.size();
+                    for (std::pair<device_t, typename F::node*> p : n.m_neighbours.first())
+                        if (p.second != &n) m_adjacency.push_back(p.second);
+                    n.m_adjacency_end = m_adjacency.size();
+                }
+                m_topology_ready.store(true, std::memory_order_release);
+            }
+
+            //! @brief No adjacency without an identifier (never called).
+            void build_topology(std::false_type) {}
+
             //! @brief Returns the `randomizer` generator if available.
             template <typename N>
             inline auto& get_generator(std::true_type, N& n) {
@@ -287,6 +359,12 @@ struct graph_connector {
 
             //! @brief The mutex regulating access to maps.
             common::mutex<parallel> m_mutex;
+
+            //! @brief The compressed adjacency.
+            std::vector<typename F::node*> m_adjacency;
+
+            //! @brief Whether the adjacency reflects the current graph.
+            std::atomic<bool> m_topology_ready{false};
         };
     };
 };
@@ -15,7 +15,11 @@
 #include "lib/common/option.hpp"
 #include "lib/common/profiler.hpp"
 #include "lib/common/random_access_map.hpp"
+#include "lib/common/simd.hpp"
+#include "lib/common/slab_map.hpp"
+#include "lib/common/small_vector.hpp"
 #include "lib/common/tagged_tuple.hpp"
+#include "lib/common/thread_pool.hpp"
 #include "lib/common/traits.hpp"
 
 #endif // FCPP_COMMON_H_
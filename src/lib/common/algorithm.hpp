@@ -9,6 +9,7 @@
 #define FCPP_COMMON_ALGORITHM_H_
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
 #include <set>
 #include <type_traits>
@@ -54,6 +55,8 @@ namespace std {
 //! @endcond
 #endif
 
+#include "lib/common/thread_pool.hpp"
+
 /**
  * @brief Namespace containing all the objects in the FCPP library.
  */
@@ -264,7 +267,7 @@ void parallel_for(tags::parallel_execution e, size_t len, F&& f) {
 }
 #else
 /**
- * @brief Bypassable parallel for (standard parallel version).
+ * @brief Bypassable parallel for (standard parallel version, on the persistent thread pool).
  *
  * Executes a function (with index and thread number as arguments) for indices up to `len`.
  * The thread numbers range from zero to `n-1`.
@@ -279,13 +282,9 @@ void parallel_for(tags::parallel_execution e, size_t len, F&& f) {
         parallel_for(tags::sequential_execution{}, len, f);
         return;
     }
-    std::vector<std::thread> pool;
-    pool.reserve(e.num);
-    for (size_t t=0; t<std::min(e.num,len); ++t)
-        pool.emplace_back([=,&f] () {
-            for (size_t i=t; i<len; i+=e.num) f(i,t);
-        });
-    for (std::thread& t : pool) t.join();
+    thread_pool::instance().run(std::min(e.num,len), [=,&f] (size_t t) {
+        for (size_t i=t; i<len; i+=e.num) f(i,t);
+    });
 }
 #endif
 
@@ -308,7 +307,7 @@ void parallel_for(tags::dynamic_execution e, size_t len, F&& f) {
 }
 #else
 /**
- * @brief Bypassable parallel for (standard parallel version with dynamic scheduling).
+ * @brief Bypassable parallel for (standard parallel version with dynamic scheduling, on the persistent thread pool).
  *
  * Executes a function (with index and thread number as arguments) for indices up to `len`.
  * The thread numbers range from zero to `n-1`.
@@ -323,23 +322,14 @@ void parallel_for(tags::dynamic_execution e, size_t len, F&& f) {
         parallel_for(tags::sequential_execution{}, len, f);
         return;
     }
-    std::vector<std::thread> pool;
-    pool.reserve(e.num);
-    std::mutex m;
-    size_t i=0;
-    for (size_t t=0; t<std::min(e.num,len); ++t)
-        pool.emplace_back([=,&i,&f,&m] () {
-            size_t j;
-            while (true) {
-                m.lock();
-                j = i;
-                i += e.size;
-                m.unlock();
-                if (j >= len) break;
-                for (size_t k=j; k<j+e.size and k<len; ++k) f(k,t);
-            }
-        });
-    for (std::thread& t : pool) t.join();
+    std::atomic<size_t> i{0};
+    thread_pool::instance().run(std::min(e.num,len), [=,&i,&f] (size_t t) {
+        while (true) {
+            size_t j = i.fetch_add(e.size);
+            if (j >= len) break;
+            for (size_t k=j; k<j+e.size and k<len; ++k) f(k,t);
+        }
+    });
 }
 #endif
 
@@ -375,7 +365,7 @@ void parallel_while(tags::parallel_execution e, F&& f) {
 }
 #else
 /**
- * @brief Bypassable parallel for (standard parallel version).
+ * @brief Bypassable parallel while (standard parallel version, on the persistent thread pool).
  *
  * Executes a function (with index and thread number as argument) until it returns `false`.
  * The thread numbers range from zero to `n-1`.
@@ -389,13 +379,9 @@ void parallel_while(tags::parallel_execution e, F&& f) {
         parallel_while(tags::sequential_execution{}, f);
         return;
     }
-    std::vector<std::thread> pool;
-    pool.reserve(e.num);
-    for (size_t t=0; t<e.num; ++t)
-        pool.emplace_back([=,&f] () {
-            for (size_t i=t; f(i,t); i+=e.num);
-        });
-    for (std::thread& t : pool) t.join();
+    thread_pool::instance().run(e.num, [=,&f] (size_t t) {
+        for (size_t i=t; f(i,t); i+=e.num);
+    });
 }
 #endif
 
@@ -417,7 +403,7 @@ void parallel_while(tags::dynamic_execution e, F&& f) {
 }
 #else
 /**
- * @brief Bypassable parallel for (standard parallel version with dynamic scheduling).
+ * @brief Bypassable parallel while (standard parallel version with dynamic scheduling, on the persistent thread pool).
  *
  * Executes a function (with index and thread number as argument) until it returns `false`.
  * The thread numbers range from zero to `n-1`.
@@ -431,23 +417,14 @@ void parallel_while(tags::dynamic_execution e, F&& f) {
         parallel_while(tags::sequential_execution{}, f);
         return;
     }
-    std::vector<std::thread> pool;
-    pool.reserve(e.num);
-    std::mutex m;
-    size_t i=0;
-    for (size_t t=0; t<e.num; ++t)
-        pool.emplace_back([=,&i,&f,&m] () {
-            size_t j;
-            while (true) {
-                m.lock();
-                j = i;
-                i += e.size;
-                m.unlock();
-                for (size_t k=j; k<j+e.size; ++k)
-                    if (not f(k,t)) return;
-            }
-        });
-    for (std::thread& t : pool) t.join();
+    std::atomic<size_t> i{0};
+    thread_pool::instance().run(e.num, [=,&i,&f] (size_t t) {
+        while (true) {
+            size_t j = i.fetch_add(e.size);
+            for (size_t k=j; k<j+e.size; ++k)
+                if (not f(k,t)) return;
+        }
+    });
 }
 #endif
 
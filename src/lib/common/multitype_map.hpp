@@ -2,18 +2,27 @@
 
 /**
  * @file multitype_map.hpp
- * @brief Implementation of the `multitype_map<T, Ts...>` class template for handling heterogeneous indexed data.
+ * @brief Implementation of the `multitype_map<T, Ts...>`, `flat_multitype_map<T, Ts...>` and `schema_multitype_map<T, Ts...>` class templates for handling heterogeneous indexed data.
  */
 
 #ifndef FCPP_COMMON_MULTITYPE_MAP_H_
 #define FCPP_COMMON_MULTITYPE_MAP_H_
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
 #include <ostream>
+#include <stdexcept>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "lib/settings.hpp"
+#include "lib/common/mutex.hpp"
 #include "lib/common/tagged_tuple.hpp"
 #include "lib/common/traits.hpp"
 
@@ -30,6 +39,21 @@ namespace fcpp {
 namespace common {
 
 
+//! @cond INTERNAL
+//! @brief Forward declaration of serialization streams.
+template <bool io>
+class sstream;
+
+namespace details {
+    //! @brief Clears a tagged tuple of containers of some types.
+    template <typename U, typename... Ss>
+    void clear_tables(U& x, type_sequence<Ss...>) {
+        ignore((get<Ss>(x).clear(), 0)...);
+    }
+}
+//! @endcond
+
+
 /**
  * @brief Class for handling heterogeneous indexed data.
  *
@@ -139,6 +163,24 @@ class multitype_map {
         return m_keys.count(key);
     }
 
+    //! @brief Removes all the content (keeping the bucket arrays, while the entries are freed).
+    void clear() {
+        m_keys.clear();
+        details::clear_tables(m_data, value_types{});
+    }
+
+    //! @brief Calls `f(key)` for every key with a void value.
+    template <typename F>
+    void for_keys(F&& f) const {
+        for (T const& k : m_keys) f(k);
+    }
+
+    //! @brief Calls `f(key, value)` for every value of a certain type.
+    template <typename A, typename F>
+    void for_values(F&& f) const {
+        for (auto const& x : get_map<A>(bool_pack<type_supported<A>>{})) f(x.first, x.second);
+    }
+
     //! @brief Prints the content of the multitype map.
     template <typename O, typename... Ss>
     void print(O& o, Ss... xs) const {
@@ -201,6 +243,737 @@ class multitype_map {
 };
 
 
+/**
+ * @brief Class for handling heterogeneous indexed data, with flat cache-friendly storage.
+ *
+ * Has the same interface as \ref multitype_map, but stores the values of each type in a
+ * contiguous vector of key-value pairs sorted by key (and void keys in a sorted vector),
+ * so that building a map requires a single allocation per type used, and lookups are
+ * binary searches in contiguous memory. Best suited for small maps, such as exports.
+ *
+ * @param T Key type.
+ * @param Ts Admissible value types.
+ */
+template <typename T, typename... Ts>
+class flat_multitype_map {
+    //! @brief Checks whether a type is supported by the map.
+    template <typename A>
+    constexpr static bool type_supported = type_count<std::remove_reference_t<A>, Ts...> != 0;
+
+    //! @brief The storage type for values of a given type.
+    template <typename A>
+    using table_type = std::vector<std::pair<T, std::remove_reference_t<A>>>;
+
+  public:
+    //! @brief The type of the keys.
+    typedef T key_type;
+
+    //! @brief List of admissible types (without repetitions).
+    using value_types = type_uniq<Ts...>;
+
+    //! @brief List of table types (without repetitions).
+    using map_types = type_uniq<std::vector<std::pair<T, Ts>>...>;
+
+    //! @name constructors
+    //! @{
+    /**
+     * @brief Default constructor (creates an empty structure).
+     */
+    flat_multitype_map() = default;
+
+    //! @brief Copy constructor.
+    flat_multitype_map(flat_multitype_map const&) = default;
+
+    //! @brief Move constructor.
+    flat_multitype_map(flat_multitype_map&&) = default;
+    //! @}
+
+    //! @name assignment operators
+    //! @{
+    //! @brief Copy assignment.
+    flat_multitype_map& operator=(flat_multitype_map const&) = default;
+
+    //! @brief Move assignment.
+    flat_multitype_map& operator=(flat_multitype_map&&) = default;
+    //! @}
+
+    //! @brief Equality operator.
+    bool operator==(flat_multitype_map const& o) const {
+        return m_keys == o.m_keys and tables_compare(m_data, o.m_data, value_types{});
+    }
+
+    #define MISSING_TYPE_MESSAGE "\033[1m\033[4munsupported type access (add type A to exports type list)\033[0m"
+
+    //! @brief Inserts value at corresponding key.
+    template<typename A>
+    void insert(T key, A const& value) {
+        find_or_insert(get_table<A>(bool_pack<type_supported<A>>{}), key) = value;
+        static_assert(type_supported<A>, MISSING_TYPE_MESSAGE);
+    }
+
+    //! @brief Inserts value at corresponding key by moving.
+    template<typename A, typename = std::enable_if_t<not std::is_reference<A>::value>>
+    void insert(T key, A&& value) {
+        find_or_insert(get_table<A>(bool_pack<type_supported<A>>{}), key) = std::move(value);
+        static_assert(type_supported<A>, MISSING_TYPE_MESSAGE);
+    }
+
+    #undef MISSING_TYPE_MESSAGE
+
+    //! @brief Inserts void value at corresponding key.
+    void insert(T key) {
+        auto it = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+        if (it == m_keys.end() or *it != key) m_keys.insert(it, key);
+    }
+
+    //! @brief Deletes value at corresponding key.
+    template<typename A>
+    void erase(T key) {
+        auto&& t = get_table<A>(bool_pack<type_supported<A>>{});
+        auto it = find(t, key);
+        if (it != t.end()) t.erase(it);
+    }
+
+    //! @brief Deletes void value at corresponding key.
+    void remove(T key) {
+        auto it = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+        if (it != m_keys.end() and *it == key) m_keys.erase(it);
+    }
+
+    //! @brief Immutable reference to the value of a certain type at a given key.
+    template<typename A>
+    A const& at(T key) const {
+        return at_impl(get_table<A>(bool_pack<type_supported<A>>{}), key);
+    }
+
+    //! @brief Mutable reference to the value of a certain type at a given key.
+    template<typename A>
+    A& at(T key) {
+        return at_impl(get_table<A>(bool_pack<type_supported<A>>{}), key);
+    }
+
+    //! @brief Whether the key is present in the value map or not for a certain type.
+    template<typename A>
+    bool count(T key) const {
+        auto const& t = get_table<A>(bool_pack<type_supported<A>>{});
+        return find(t, key) != t.end();
+    }
+
+    //! @brief Whether the key is present in the value map or not for the void type.
+    bool contains(T key) const {
+        return std::binary_search(m_keys.begin(), m_keys.end(), key);
+    }
+
+    //! @brief Removes all the content (keeping allocated memory for later reuse).
+    void clear() {
+        m_keys.clear();
+        details::clear_tables(m_data, value_types{});
+    }
+
+    //! @brief Calls `f(key)` for every key with a void value (in increasing order).
+    template <typename F>
+    void for_keys(F&& f) const {
+        for (T const& k : m_keys) f(k);
+    }
+
+    //! @brief Calls `f(key, value)` for every value of a certain type (in increasing key order).
+    template <typename A, typename F>
+    void for_values(F&& f) const {
+        for (auto const& x : get_table<A>(bool_pack<type_supported<A>>{})) f(x.first, x.second);
+    }
+
+    //! @brief Prints the content of the multitype map.
+    template <typename O, typename... Ss>
+    void print(O& o, Ss... xs) const {
+        m_data.print(o, xs...);
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return s & m_data & m_keys;
+    }
+
+  private:
+    //! @brief Access to the table corresponding to a type.
+    template <typename A>
+    table_type<A>& get_table(bool_pack<true>) {
+        return get<std::remove_reference_t<A>>(m_data);
+    }
+
+    //! @brief Const access to the table corresponding to a type.
+    template <typename A>
+    table_type<A> const& get_table(bool_pack<true>) const {
+        return get<std::remove_reference_t<A>>(m_data);
+    }
+
+    //! @brief Access to a table corresponding to a missing type.
+    template <typename A>
+    table_type<A> get_table(bool_pack<false>) const {
+        return {};
+    }
+
+    //! @brief Iterator to the pair with a given key in a table (or end if missing).
+    template <typename V>
+    static auto find(V&& t, T key) {
+        auto it = std::lower_bound(t.begin(), t.end(), key, [](auto const& x, T k) {
+            return x.first < k;
+        });
+        return it != t.end() and it->first == key ? it : t.end();
+    }
+
+    //! @brief Reference to the value with a given key in a table, inserting a default one if missing.
+    template <typename U>
+    static U& find_or_insert(std::vector<std::pair<T, U>>& t, T key) {
+        // fast path for keys inserted in increasing order
+        if (t.empty() or t.back().first < key) {
+            t.emplace_back(key, U{});
+            return t.back().second;
+        }
+        auto it = std::lower_bound(t.begin(), t.end(), key, [](auto const& x, T k) {
+            return x.first < k;
+        });
+        if (it == t.end() or it->first != key) it = t.emplace(it, key, U{});
+        return it->second;
+    }
+
+    //! @brief Reference to the value with a given key in a table, failing if missing.
+    template <typename V>
+    static auto& at_impl(V&& t, T key) {
+        auto it = find(t, key);
+        #if __cpp_exceptions
+        if (it == t.end())
+            throw std::out_of_range("flat_multitype_map::at");
+        #endif
+        return it->second;
+    }
+
+    //! @brief Compares sorted tables, even in case `decltype(U == U)` is not implicitly convertible to bool.
+    template <typename U>
+    bool table_compare(std::vector<std::pair<T, U>> const& x, std::vector<std::pair<T, U>> const& y) const {
+        if (x.size() != y.size()) return false;
+        for (size_t i = 0; i < x.size(); ++i) {
+            if (x[i].first != y[i].first) return false;
+            if (x[i].second != y[i].second) return false;
+        }
+        return true;
+    }
+
+    //! @brief Compares tagged tuples of tables (no elements).
+    template <typename U>
+    bool tables_compare(U const&, U const&, type_sequence<>) const {
+        return true;
+    }
+
+    //! @brief Compares tagged tuples of tables (some elements).
+    template <typename U, typename S, typename... Ss>
+    bool tables_compare(U const& x, U const& y, type_sequence<S, Ss...>) const {
+        if (not table_compare(get<S>(x), get<S>(y))) return false;
+        return tables_compare(x, y, type_sequence<Ss...>{});
+    }
+
+    //! @brief Sorted tables associating keys to data.
+    tagged_tuple<value_types, map_types> m_data;
+    //! @brief Sorted vector of keys (for void data).
+    std::vector<T> m_keys;
+};
+
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief Number of bits needed to represent a number.
+    constexpr size_t bit_width(size_t n) {
+        return n == 0 ? 0 : 1 + bit_width(n >> 1);
+    }
+
+    /**
+     * @brief Assignment of dense slots to keys, for values of a given type.
+     *
+     * A slot is assigned to a key on its first insertion, and never changes afterwards, so that
+     * every map sharing the registry agrees on it. Lookups are lock-free, while assignments of new
+     * slots are serialised. At most @ref FCPP_EXPORT_SLOTS keys are assigned a slot, further keys
+     * are left without one.
+     */
+    template <typename T>
+    class slot_registry {
+        //! @brief Size of the open addressing table (a power of two, at least twice the number of slots).
+        static constexpr size_t capacity = size_t(1) << (1 + bit_width(FCPP_EXPORT_SLOTS));
+
+      public:
+        //! @brief Value denoting a missing slot.
+        static constexpr size_t npos = size_t(-1);
+
+        //! @brief The slot of a key (or `npos` if not assigned).
+        size_t find(T key) const {
+            for (size_t i = hash(key); ; i = (i+1) & (capacity-1)) {
+                size_t s = m_slots[i].load(std::memory_order_acquire);
+                if (s == 0) return npos;
+                if (m_keys[i] == key) return s-1;
+            }
+        }
+
+        //! @brief The slot of a key, assigning a new one if missing (or `npos` if slots are exhausted).
+        size_t insert(T key) {
+            size_t s = find(key);
+            if (s != npos) return s;
+            lock_guard<true> l(m_mutex);
+            size_t i = hash(key);
+            for (; (s = m_slots[i].load(std::memory_order_relaxed)) != 0; i = (i+1) & (capacity-1))
+                if (m_keys[i] == key) return s-1;
+            if (m_size == FCPP_EXPORT_SLOTS) return npos;
+            m_keys[i] = key;
+            m_slot_keys[m_size] = key;
+            m_slots[i].store(++m_size, std::memory_order_release);
+            return m_size-1;
+        }
+
+        //! @brief The key assigned to a slot.
+        T key(size_t s) const {
+            return m_slot_keys[s];
+        }
+
+      private:
+        //! @brief Starting position of a key in the table.
+        static inline size_t hash(T key) {
+            return (uint64_t(key) * 0x9E3779B97F4A7C15ULL) >> (64 - bit_width(capacity-1));
+        }
+
+        //! @brief Slots (increased by one, zero if empty) of the keys in the table.
+        std::atomic<size_t> m_slots[capacity] = {};
+        //! @brief Keys in the table.
+        T m_keys[capacity];
+        //! @brief Keys by slot.
+        T m_slot_keys[FCPP_EXPORT_SLOTS];
+        //! @brief Number of slots assigned.
+        size_t m_size = 0;
+        //! @brief Mutex serialising the assignment of slots.
+        mutex<true> m_mutex;
+    };
+
+    template <typename T>
+    constexpr size_t slot_registry<T>::npos;
+}
+//! @endcond
+
+
+/**
+ * @brief Assignment of dense slots to keys, shared by a group of \ref schema_multitype_map objects.
+ *
+ * Holds a registry of slots for every admissible type (and for void). It is not copyable,
+ * and is meant to be shared through pointers by the maps of a single network, whose programs
+ * produce the same keys in every round. Every registry takes about `18 * FCPP_EXPORT_SLOTS` bytes.
+ *
+ * @param T Key type.
+ * @param Ts Admissible value types.
+ */
+template <typename T, typename... Ts>
+class slot_schema {
+    //! @brief Types with a registry (void first).
+    using registry_types = typename type_uniq<Ts...>::template push_front<void>;
+
+  public:
+    //! @brief The type of the registries of slots.
+    using registry_type = details::slot_registry<T>;
+
+    //! @brief Default constructor (with no slots assigned).
+    slot_schema() = default;
+
+    //! @brief Disabled copy constructor.
+    slot_schema(slot_schema const&) = delete;
+
+    //! @brief Disabled copy assignment.
+    slot_schema& operator=(slot_schema const&) = delete;
+
+    //! @brief The registry of slots for values of a given type.
+    template <typename A>
+    registry_type& registry() {
+        return m_registries[registry_types::template find<std::remove_reference_t<A>>];
+    }
+
+    //! @brief The registry of slots for values of a given type (const).
+    template <typename A>
+    registry_type const& registry() const {
+        return m_registries[registry_types::template find<std::remove_reference_t<A>>];
+    }
+
+  private:
+    //! @brief The registries of slots.
+    std::array<registry_type, registry_types::size> m_registries;
+};
+
+
+/**
+ * @brief Class for handling heterogeneous indexed data, with values stored at dense slots.
+ *
+ * Has the same interface as \ref multitype_map, but a map can be \ref attach "attached" to a
+ * \ref slot_schema assigning dense slots to keys, which is shared with other maps. Values of each
+ * type are then stored in a vector indexed by slot, so that accessing a key in every map (as when
+ * gathering values from neighbours) amounts to a lookup in the shared schema followed by direct
+ * indexing. Keys without a slot (as those from loops with a variable number of iterations, once
+ * the @ref FCPP_EXPORT_SLOTS slots are exhausted) and all keys of maps without a schema (as those
+ * just deserialised) are stored in a fallback \ref multitype_map.
+ * Serialises in the same format as \ref multitype_map.
+ *
+ * @param T Key type.
+ * @param Ts Admissible value types.
+ */
+template <typename T, typename... Ts>
+class schema_multitype_map {
+    //! @brief Checks whether a type is supported by the map.
+    template <typename A>
+    constexpr static bool type_supported = type_count<std::remove_reference_t<A>, Ts...> != 0;
+
+    //! @brief The storage type for values of a given type (with their presence flag).
+    template <typename A>
+    using table_type = std::vector<std::pair<bool, std::remove_reference_t<A>>>;
+
+    //! @brief The type of the fallback map.
+    using map_type = multitype_map<T, Ts...>;
+
+    //! @brief Value denoting a missing slot.
+    static constexpr size_t npos = details::slot_registry<T>::npos;
+
+  public:
+    //! @brief The type of the keys.
+    typedef T key_type;
+
+    //! @brief The type of the schemas assigning slots to keys.
+    typedef slot_schema<T, Ts...> schema_type;
+
+    //! @brief List of admissible types (without repetitions).
+    using value_types = type_uniq<Ts...>;
+
+    //! @brief List of table types (without repetitions).
+    using map_types = type_uniq<std::vector<std::pair<bool, Ts>>...>;
+
+    //! @name constructors
+    //! @{
+    /**
+     * @brief Default constructor (creates an empty structure without a schema).
+     */
+    schema_multitype_map() = default;
+
+    //! @brief Copy constructor.
+    schema_multitype_map(schema_multitype_map const&) = default;
+
+    //! @brief Move constructor.
+    schema_multitype_map(schema_multitype_map&&) = default;
+    //! @}
+
+    //! @name assignment operators
+    //! @{
+    //! @brief Copy assignment.
+    schema_multitype_map& operator=(schema_multitype_map const&) = default;
+
+    //! @brief Move assignment.
+    schema_multitype_map& operator=(schema_multitype_map&&) = default;
+    //! @}
+
+    //! @brief Equality operator.
+    bool operator==(schema_multitype_map const& o) const {
+        if (m_schema != o.m_schema) return to_map() == o.to_map();
+        return keys_compare(m_keys, o.m_keys) and tables_compare(m_data, o.m_data, value_types{}) and m_overflow == o.m_overflow;
+    }
+
+    //! @brief The schema the map is attached to (null if none).
+    std::shared_ptr<schema_type> const& schema() const {
+        return m_schema;
+    }
+
+    //! @brief Attaches the map to a schema, moving the content to the slots assigned by it.
+    void attach(std::shared_ptr<schema_type> const& s) {
+        if (s == m_schema) return;
+        map_type m = to_map();
+        clear();
+        m_schema = s;
+        from_map(m);
+    }
+
+    #define MISSING_TYPE_MESSAGE "\033[1m\033[4munsupported type access (add type A to exports type list)\033[0m"
+
+    //! @brief Inserts value at corresponding key.
+    template<typename A>
+    void insert(T key, A const& value) {
+        static_assert(type_supported<A>, MISSING_TYPE_MESSAGE);
+        size_t s = assign<A>(key);
+        if (s == npos) m_overflow.insert(key, value);
+        else find_or_insert(get_table<A>(bool_pack<type_supported<A>>{}), s) = value;
+    }
+
+    //! @brief Inserts value at corresponding key by moving.
+    template<typename A, typename = std::enable_if_t<not std::is_reference<A>::value>>
+    void insert(T key, A&& value) {
+        static_assert(type_supported<A>, MISSING_TYPE_MESSAGE);
+        size_t s = assign<A>(key);
+        if (s == npos) m_overflow.insert(key, std::move(value));
+        else find_or_insert(get_table<A>(bool_pack<type_supported<A>>{}), s) = std::move(value);
+    }
+
+    #undef MISSING_TYPE_MESSAGE
+
+    //! @brief Inserts void value at corresponding key.
+    void insert(T key) {
+        size_t s = assign<void>(key);
+        if (s == npos) m_overflow.insert(key);
+        else {
+            if (m_keys.size() <= s) m_keys.resize(s+1);
+            m_keys[s] = true;
+        }
+    }
+
+    //! @brief Deletes value at corresponding key.
+    template<typename A>
+    void erase(T key) {
+        erase_impl<A>(key, bool_pack<type_supported<A>>{});
+    }
+
+    //! @brief Deletes void value at corresponding key.
+    void remove(T key) {
+        size_t s = slot<void>(key);
+        if (s == npos) m_overflow.remove(key);
+        else if (s < m_keys.size()) m_keys[s] = false;
+    }
+
+    //! @brief Immutable reference to the value of a certain type at a given key.
+    template<typename A>
+    A const& at(T key) const {
+        return at_impl<A>(*this, key, bool_pack<type_supported<A>>{});
+    }
+
+    //! @brief Mutable reference to the value of a certain type at a given key.
+    template<typename A>
+    A& at(T key) {
+        return at_impl<A>(*this, key, bool_pack<type_supported<A>>{});
+    }
+
+    //! @brief Whether the key is present in the value map or not for a certain type.
+    template<typename A>
+    bool count(T key) const {
+        return count_impl<A>(key, bool_pack<type_supported<A>>{});
+    }
+
+    //! @brief Whether the key is present in the value map or not for the void type.
+    bool contains(T key) const {
+        size_t s = slot<void>(key);
+        if (s == npos) return m_overflow.contains(key);
+        return s < m_keys.size() and m_keys[s];
+    }
+
+    //! @brief Removes all the content and detaches from the schema (keeping the tables allocated).
+    void clear() {
+        m_keys.clear();
+        details::clear_tables(m_data, value_types{});
+        m_overflow.clear();
+        m_schema.reset();
+    }
+
+    //! @brief Calls `f(key)` for every key with a void value.
+    template <typename F>
+    void for_keys(F&& f) const {
+        for (size_t s = 0; s < m_keys.size(); ++s)
+            if (m_keys[s]) f(m_schema->template registry<void>().key(s));
+        m_overflow.for_keys(f);
+    }
+
+    //! @brief Calls `f(key, value)` for every value of a certain type.
+    template <typename A, typename F>
+    void for_values(F&& f) const {
+        for_values_impl<A>(f, bool_pack<type_supported<A>>{});
+    }
+
+    //! @brief Prints the content of the multitype map.
+    template <typename O, typename... Ss>
+    void print(O& o, Ss... xs) const {
+        to_map().print(o, xs...);
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        map_type m;
+        if (std::is_same<S, sstream<true>>::value) m = to_map();
+        s & m;
+        if (std::is_same<S, sstream<false>>::value) {
+            std::shared_ptr<schema_type> schema = m_schema;
+            clear();
+            m_schema = std::move(schema);
+            from_map(m);
+        }
+        return s;
+    }
+
+  private:
+    //! @brief The slot of a key for values of a type (or `npos` if not assigned or without a schema).
+    template <typename A>
+    size_t slot(T key) const {
+        return m_schema ? m_schema->template registry<A>().find(key) : npos;
+    }
+
+    //! @brief The slot of a key for values of a type, assigning a new one if missing (or `npos` if not possible).
+    template <typename A>
+    size_t assign(T key) {
+        return m_schema ? m_schema->template registry<A>().insert(key) : npos;
+    }
+
+    //! @brief Access to the table corresponding to a type.
+    template <typename A>
+    table_type<A>& get_table(bool_pack<true>) {
+        return get<std::remove_reference_t<A>>(m_data);
+    }
+
+    //! @brief Const access to the table corresponding to a type.
+    template <typename A>
+    table_type<A> const& get_table(bool_pack<true>) const {
+        return get<std::remove_reference_t<A>>(m_data);
+    }
+
+    //! @brief Reference to the value at a given slot in a table, inserting a default one if missing.
+    template <typename U>
+    static U& find_or_insert(std::vector<std::pair<bool, U>>& t, size_t s) {
+        if (t.size() <= s) t.resize(s+1);
+        t[s].first = true;
+        return t[s].second;
+    }
+
+    //! @brief Deletes value at corresponding key (unsupported type).
+    template <typename A>
+    void erase_impl(T, bool_pack<false>) {}
+
+    //! @brief Deletes value at corresponding key.
+    template <typename A>
+    void erase_impl(T key, bool_pack<true>) {
+        size_t s = slot<A>(key);
+        if (s == npos) m_overflow.template erase<A>(key);
+        else {
+            auto& t = get_table<A>(bool_pack<true>{});
+            if (s < t.size()) t[s] = {};
+        }
+    }
+
+    //! @brief Whether the key is present for a certain type (unsupported type).
+    template <typename A>
+    bool count_impl(T, bool_pack<false>) const {
+        return false;
+    }
+
+    //! @brief Whether the key is present for a certain type.
+    template <typename A>
+    bool count_impl(T key, bool_pack<true>) const {
+        size_t s = slot<A>(key);
+        if (s == npos) return m_overflow.template count<A>(key);
+        auto const& t = get_table<A>(bool_pack<true>{});
+        return s < t.size() and t[s].first;
+    }
+
+    //! @brief Calls `f(key, value)` for every value of a certain type (unsupported type).
+    template <typename A, typename F>
+    void for_values_impl(F&, bool_pack<false>) const {}
+
+    //! @brief Calls `f(key, value)` for every value of a certain type.
+    template <typename A, typename F>
+    void for_values_impl(F& f, bool_pack<true>) const {
+        auto const& t = get_table<A>(bool_pack<true>{});
+        for (size_t s = 0; s < t.size(); ++s)
+            if (t[s].first) f(m_schema->template registry<A>().key(s), t[s].second);
+        m_overflow.template for_values<A>(f);
+    }
+
+    //! @brief Reference to the value with a given key in a map, failing if missing (unsupported type).
+    template <typename A, typename M>
+    static auto& at_impl(M& m, T key, bool_pack<false>) {
+        return m.m_overflow.template at<A>(key);
+    }
+
+    //! @brief Reference to the value with a given key in a map, failing if missing.
+    template <typename A, typename M>
+    static auto& at_impl(M& m, T key, bool_pack<true>) {
+        size_t s = m.template slot<A>(key);
+        if (s == npos) return m.m_overflow.template at<A>(key);
+        auto& t = m.template get_table<A>(bool_pack<true>{});
+        #if __cpp_exceptions
+        if (s >= t.size() or not t[s].first)
+            throw std::out_of_range("schema_multitype_map::at");
+        #endif
+        return t[s].second;
+    }
+
+    //! @brief Converts the content into a multitype map.
+    map_type to_map() const {
+        map_type m = m_overflow;
+        for_keys([&](T k) {
+            m.insert(k);
+        });
+        to_map(m, value_types{});
+        return m;
+    }
+
+    //! @brief Converts the content of some types into a multitype map.
+    template <typename... Ss>
+    void to_map(map_type& m, type_sequence<Ss...>) const {
+        details::ignore((for_values<Ss>([&](T k, Ss const& v) {
+            m.insert(k, v);
+        }), 0)...);
+    }
+
+    //! @brief Inserts the content of a multitype map.
+    void from_map(map_type const& m) {
+        m.for_keys([&](T k) {
+            insert(k);
+        });
+        from_map(m, value_types{});
+    }
+
+    //! @brief Inserts the content of some types of a multitype map.
+    template <typename... Ss>
+    void from_map(map_type const& m, type_sequence<Ss...>) {
+        details::ignore((m.template for_values<Ss>([&](T k, Ss const& v) {
+            insert(k, v);
+        }), 0)...);
+    }
+
+    //! @brief Compares presence flags of void keys, ignoring trailing missing keys.
+    static bool keys_compare(std::vector<bool> const& x, std::vector<bool> const& y) {
+        for (size_t s = 0; s < std::max(x.size(), y.size()); ++s)
+            if ((s < x.size() and x[s]) != (s < y.size() and y[s])) return false;
+        return true;
+    }
+
+    //! @brief Compares tables, ignoring trailing missing values.
+    template <typename U>
+    static bool table_compare(std::vector<std::pair<bool, U>> const& x, std::vector<std::pair<bool, U>> const& y) {
+        for (size_t s = 0; s < std::max(x.size(), y.size()); ++s) {
+            bool px = s < x.size() and x[s].first;
+            bool py = s < y.size() and y[s].first;
+            if (px != py) return false;
+            if (px and x[s].second != y[s].second) return false;
+        }
+        return true;
+    }
+
+    //! @brief Compares tagged tuples of tables (no elements).
+    template <typename U>
+    static bool tables_compare(U const&, U const&, type_sequence<>) {
+        return true;
+    }
+
+    //! @brief Compares tagged tuples of tables (some elements).
+    template <typename U, typename S, typename... Ss>
+    static bool tables_compare(U const& x, U const& y, type_sequence<S, Ss...>) {
+        if (not table_compare(get<S>(x), get<S>(y))) return false;
+        return tables_compare(x, y, type_sequence<Ss...>{});
+    }
+
+    //! @brief Tables associating slots to data.
+    tagged_tuple<value_types, map_types> m_data;
+    //! @brief Presence flags of slots (for void data).
+    std::vector<bool> m_keys;
+    //! @brief Map for keys without a slot.
+    map_type m_overflow;
+    //! @brief The schema assigning slots to keys (shared with other maps).
+    std::shared_ptr<schema_type> m_schema;
+};
+
 }
 
 
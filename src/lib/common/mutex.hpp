@@ -8,6 +8,7 @@
 #ifndef FCPP_COMMON_MUTEX_H_
 #define FCPP_COMMON_MUTEX_H_
 
+#include <cstddef>
 #include <cstdint>
 
 #include <chrono>
@@ -62,6 +63,29 @@ namespace fcpp {
 namespace common {
 
 
+//! @brief Size of cache lines, for separating data accessed by different threads.
+constexpr size_t cache_line = 64;
+
+
+/**
+ * @brief Padding as large as a cache line, keeping the data before and after it on different cache lines.
+ *
+ * Unlike `alignas`, it does not raise the alignment of the enclosing class (which `new` may not honour before C++17).
+ *
+ * @param enabled Whether the padding will actually take space.
+ */
+template <bool enabled>
+struct cache_padding {
+    //! @brief The padding bytes.
+    char bytes[cache_line];
+};
+
+
+//! @brief Empty padding when `enabled` is false.
+template <>
+struct cache_padding<false> {};
+
+
 /**
  * @brief Provides an uniform object interface for an OpenMP or C++14 mutex.
  *
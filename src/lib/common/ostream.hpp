@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "lib/settings.hpp"
+#include "lib/common/small_vector.hpp"
 #include "lib/common/traits.hpp"
 
 
@@ -121,14 +122,18 @@ typename std::tuple_element<n, std::tuple<Ts...>>::type const& get(const tuple<T
 
 namespace details {
     template <typename T>
-    std::vector<device_t> const& get_ids(field<T> const&);
+    common::small_vector<device_t, FCPP_FIELD_INLINE> const& get_ids(field<T> const&);
     template <typename T>
-    std::vector<T> const& get_vals(field<T> const&);
+    common::small_vector<T, FCPP_FIELD_INLINE+1> const& get_vals(field<T> const&);
 }
 
 namespace common {
     template <typename T, typename... Ts>
     class multitype_map;
+    template <typename T, typename... Ts>
+    class flat_multitype_map;
+    template <typename T, typename... Ts>
+    class schema_multitype_map;
     template <typename K, typename T, typename H, typename P, typename A>
     class random_access_map;
     template<typename S, typename T>
@@ -136,9 +141,9 @@ namespace common {
 }
 
 namespace internal {
-    template <bool online, bool pointer, typename M, typename... Ts>
+    template <bool online, bool pointer, bool flat, bool schema, bool epoch, bool indexed, bool wheel, typename M, typename... Ts>
     class context;
-    template <typename T, bool is_flat>
+    template <typename T, bool is_flat, bool is_epoch>
     class flat_ptr;
     template <typename T, bool is_twin>
     class twin;
@@ -470,6 +475,30 @@ namespace fcpp {
             return fcpp::details::printable_stringify("()", m);
         }
 
+        //! @brief Printing flat multitype maps in arrowhead format.
+        template <typename O, typename T, typename... Ts, typename = if_ostream<O>>
+        O& operator<<(O& o, const flat_multitype_map<T, Ts...>& m) {
+            return fcpp::details::printable_print(o, "()", m);
+        }
+
+        //! @brief Converting flat multitype maps to strings.
+        template <typename T, typename... Ts, typename = fcpp::details::if_stringable<T, Ts...>>
+        std::string to_string(flat_multitype_map<T, Ts...> const& m) {
+            return fcpp::details::printable_stringify("()", m);
+        }
+
+        //! @brief Printing schema multitype maps in arrowhead format.
+        template <typename O, typename T, typename... Ts, typename = if_ostream<O>>
+        O& operator<<(O& o, const schema_multitype_map<T, Ts...>& m) {
+            return fcpp::details::printable_print(o, "()", m);
+        }
+
+        //! @brief Converting schema multitype maps to strings.
+        template <typename T, typename... Ts, typename = fcpp::details::if_stringable<T, Ts...>>
+        std::string to_string(schema_multitype_map<T, Ts...> const& m) {
+            return fcpp::details::printable_stringify("()", m);
+        }
+
         //! @brief Printing random access maps.
         template <typename O, typename K, typename T, typename H, typename P, typename A, typename = if_ostream<O>>
         O& operator<<(O& o, random_access_map<K,T,H,P,A> const& m) {
@@ -498,27 +527,27 @@ namespace fcpp {
     //! @brief Namespace containing objects of internal use.
     namespace internal {
         //! @brief Printing calculus contexts.
-        template <typename O, bool b, bool d, typename... Ts, typename = common::if_ostream<O>>
-        O& operator<<(O& o, const context<b, d, Ts...>& c) {
+        template <typename O, bool b, bool d, bool f, bool s, bool e, bool i, bool w, typename... Ts, typename = common::if_ostream<O>>
+        O& operator<<(O& o, const context<b, d, f, s, e, i, w, Ts...>& c) {
             return fcpp::details::printable_print(o, "()", c);
         }
 
         //! @brief Converting calculus contexts to strings.
-        template <bool b, bool d, typename... Ts>
-    std::string to_string(context<b, d, Ts...> const& c) {
+        template <bool b, bool d, bool f, bool s, bool e, bool i, bool w, typename... Ts>
+    std::string to_string(context<b, d, f, s, e, i, w, Ts...> const& c) {
             return fcpp::details::printable_stringify("()", c);
         }
 
         //! @brief Printing content of flat pointers.
-        template <typename O, typename T, bool is_flat, typename = common::if_ostream<O>>
-        O& operator<<(O& o, const flat_ptr<T, is_flat>& p) {
+        template <typename O, typename T, bool is_flat, bool is_epoch, typename = common::if_ostream<O>>
+        O& operator<<(O& o, const flat_ptr<T, is_flat, is_epoch>& p) {
             o << common::escape(*p);
             return o;
         }
 
         //! @brief Converting flat pointers to strings.
-        template <typename T, bool is_flat, typename = fcpp::details::if_stringable<T>>
-        std::string to_string(flat_ptr<T, is_flat> const& p) {
+        template <typename T, bool is_flat, bool is_epoch, typename = fcpp::details::if_stringable<T>>
+        std::string to_string(flat_ptr<T, is_flat, is_epoch> const& p) {
             return fcpp::details::indexed_stringify(fcpp::details::fcpp_tag{}, common::escape(*p));
         }
 
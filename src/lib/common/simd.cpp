@@ -0,0 +1,3 @@
+// Copyright © 2021 Giorgio Audrito. All Rights Reserved.
+
+#include "lib/common/simd.hpp"
@@ -0,0 +1,368 @@
+// Copyright © 2021 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file simd.hpp
+ * @brief Folding operators with vectorised reductions of contiguous values, and vectorised distance checks.
+ *
+ * Vector instructions are selected at compile time: AVX2 if `__AVX2__` is defined (e.g. with `-mavx2`
+ * or `-march=native`), SSE2 (and SSE4.1) on x86-64 targets, and a scalar loop otherwise.
+ */
+
+#ifndef FCPP_COMMON_SIMD_H_
+#define FCPP_COMMON_SIMD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+/**
+ * @brief Namespace containing objects of common use.
+ */
+namespace common {
+
+
+/**
+ * @name folding operators
+ *
+ * Binary operators for folding fields, whose reduction of contiguous values may be vectorised.
+ * Each operator also provides the folding of a value repeated a given number of times.
+ */
+//! @{
+//! @brief Minimum of values.
+template <typename T>
+struct fold_min {
+    inline T operator()(T const& x, T const& y) const {
+        return std::min(x, y);
+    }
+    static inline T repeat(T const& x, size_t) {
+        return x;
+    }
+};
+
+//! @brief Maximum of values.
+template <typename T>
+struct fold_max {
+    inline T operator()(T const& x, T const& y) const {
+        return std::max(x, y);
+    }
+    static inline T repeat(T const& x, size_t) {
+        return x;
+    }
+};
+
+//! @brief Sum of values.
+template <typename T>
+struct fold_sum {
+    inline T operator()(T const& x, T const& y) const {
+        return x + y;
+    }
+    static inline T repeat(T const& x, size_t n) {
+        return T(x * n);
+    }
+};
+
+//! @brief Conjunction of values.
+template <typename T>
+struct fold_all {
+    inline T operator()(T const& x, T const& y) const {
+        return x and y;
+    }
+    static inline T repeat(T const& x, size_t n) {
+        return n > 1 ? T(x and x) : x;
+    }
+};
+
+//! @brief Disjunction of values.
+template <typename T>
+struct fold_any {
+    inline T operator()(T const& x, T const& y) const {
+        return x or y;
+    }
+    static inline T repeat(T const& x, size_t n) {
+        return n > 1 ? T(x or x) : x;
+    }
+};
+//! @}
+
+//! @brief Whether `O` is a folding operator on arithmetic values of type `T`.
+//! @{
+template <typename O, typename T>
+constexpr bool is_fold_op = false;
+template <typename T>
+constexpr bool is_fold_op<fold_min<T>, T> = std::is_arithmetic<T>::value;
+template <typename T>
+constexpr bool is_fold_op<fold_max<T>, T> = std::is_arithmetic<T>::value;
+template <typename T>
+constexpr bool is_fold_op<fold_sum<T>, T> = std::is_arithmetic<T>::value;
+template <typename T>
+constexpr bool is_fold_op<fold_all<T>, T> = std::is_arithmetic<T>::value;
+template <typename T>
+constexpr bool is_fold_op<fold_any<T>, T> = std::is_arithmetic<T>::value;
+//! @}
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief Vector counterpart of a folding operator (general form, not vectorised).
+    template <typename O>
+    struct simd_op {
+        static constexpr bool value = false;
+    };
+
+    //! @brief Defines the vector counterpart of a folding operator, given vector type, load and combine expressions.
+    #define _DEF_SIMD(O, V, load, combine)              \
+    template <>                                         \
+    struct simd_op<O> {                                 \
+        static constexpr bool value = true;             \
+        using type = V;                                 \
+        template <typename T>                           \
+        static inline V load_(T const* p) {             \
+            return load;                                \
+        }                                               \
+        static inline V combine_(V a, V b) {            \
+            return combine;                             \
+        }                                               \
+    };
+
+#if defined(__AVX2__)
+    #define _LOAD_PD _mm256_loadu_pd(p)
+    #define _LOAD_PS _mm256_loadu_ps(p)
+    #define _LOAD_SI _mm256_loadu_si256((__m256i const*)p)
+    _DEF_SIMD(fold_min<double>,  __m256d, _LOAD_PD, _mm256_min_pd(a, b))
+    _DEF_SIMD(fold_max<double>,  __m256d, _LOAD_PD, _mm256_max_pd(a, b))
+    _DEF_SIMD(fold_sum<double>,  __m256d, _LOAD_PD, _mm256_add_pd(a, b))
+    _DEF_SIMD(fold_min<float>,   __m256,  _LOAD_PS, _mm256_min_ps(a, b))
+    _DEF_SIMD(fold_max<float>,   __m256,  _LOAD_PS, _mm256_max_ps(a, b))
+    _DEF_SIMD(fold_sum<float>,   __m256,  _LOAD_PS, _mm256_add_ps(a, b))
+    _DEF_SIMD(fold_min<int32_t>, __m256i, _LOAD_SI, _mm256_min_epi32(a, b))
+    _DEF_SIMD(fold_max<int32_t>, __m256i, _LOAD_SI, _mm256_max_epi32(a, b))
+    _DEF_SIMD(fold_sum<int32_t>, __m256i, _LOAD_SI, _mm256_add_epi32(a, b))
+    _DEF_SIMD(fold_min<int16_t>, __m256i, _LOAD_SI, _mm256_min_epi16(a, b))
+    _DEF_SIMD(fold_max<int16_t>, __m256i, _LOAD_SI, _mm256_max_epi16(a, b))
+    _DEF_SIMD(fold_sum<int16_t>, __m256i, _LOAD_SI, _mm256_add_epi16(a, b))
+    _DEF_SIMD(fold_min<int8_t>,  __m256i, _LOAD_SI, _mm256_min_epi8(a, b))
+    _DEF_SIMD(fold_max<int8_t>,  __m256i, _LOAD_SI, _mm256_max_epi8(a, b))
+    _DEF_SIMD(fold_sum<int8_t>,  __m256i, _LOAD_SI, _mm256_add_epi8(a, b))
+    _DEF_SIMD(fold_all<bool>,    __m256i, _LOAD_SI, _mm256_and_si256(a, b))
+    _DEF_SIMD(fold_any<bool>,    __m256i, _LOAD_SI, _mm256_or_si256(a, b))
+#elif defined(__SSE2__)
+    #define _LOAD_PD _mm_loadu_pd(p)
+    #define _LOAD_PS _mm_loadu_ps(p)
+    #define _LOAD_SI _mm_loadu_si128((__m128i const*)p)
+    _DEF_SIMD(fold_min<double>,  __m128d, _LOAD_PD, _mm_min_pd(a, b))
+    _DEF_SIMD(fold_max<double>,  __m128d, _LOAD_PD, _mm_max_pd(a, b))
+    _DEF_SIMD(fold_sum<double>,  __m128d, _LOAD_PD, _mm_add_pd(a, b))
+    _DEF_SIMD(fold_min<float>,   __m128,  _LOAD_PS, _mm_min_ps(a, b))
+    _DEF_SIMD(fold_max<float>,   __m128,  _LOAD_PS, _mm_max_ps(a, b))
+    _DEF_SIMD(fold_sum<float>,   __m128,  _LOAD_PS, _mm_add_ps(a, b))
+    _DEF_SIMD(fold_sum<int32_t>, __m128i, _LOAD_SI, _mm_add_epi32(a, b))
+    _DEF_SIMD(fold_min<int16_t>, __m128i, _LOAD_SI, _mm_min_epi16(a, b))
+    _DEF_SIMD(fold_max<int16_t>, __m128i, _LOAD_SI, _mm_max_epi16(a, b))
+    _DEF_SIMD(fold_sum<int16_t>, __m128i, _LOAD_SI, _mm_add_epi16(a, b))
+    _DEF_SIMD(fold_sum<int8_t>,  __m128i, _LOAD_SI, _mm_add_epi8(a, b))
+    _DEF_SIMD(fold_all<bool>,    __m128i, _LOAD_SI, _mm_and_si128(a, b))
+    _DEF_SIMD(fold_any<bool>,    __m128i, _LOAD_SI, _mm_or_si128(a, b))
+#if defined(__SSE4_1__)
+    _DEF_SIMD(fold_min<int32_t>, __m128i, _LOAD_SI, _mm_min_epi32(a, b))
+    _DEF_SIMD(fold_max<int32_t>, __m128i, _LOAD_SI, _mm_max_epi32(a, b))
+    _DEF_SIMD(fold_min<int8_t>,  __m128i, _LOAD_SI, _mm_min_epi8(a, b))
+    _DEF_SIMD(fold_max<int8_t>,  __m128i, _LOAD_SI, _mm_max_epi8(a, b))
+#endif
+#endif
+
+#undef _DEF_SIMD
+#undef _LOAD_PD
+#undef _LOAD_PS
+#undef _LOAD_SI
+
+    //! @brief Scalar reduction of `n > 0` contiguous values.
+    template <typename O, typename T>
+    inline T reduce(O const& op, T const* x, size_t n, std::false_type) {
+        T r = x[0];
+        for (size_t i = 1; i < n; ++i) r = op(x[i], r);
+        return r;
+    }
+
+    //! @brief Vectorised reduction of `n > 0` contiguous values, with two independent accumulators.
+    template <typename O, typename T>
+    T reduce(O const& op, T const* x, size_t n, std::true_type) {
+        using V = typename simd_op<O>::type;
+        constexpr size_t w = sizeof(V) / sizeof(T);
+        if (n < 2*w) return reduce(op, x, n, std::false_type{});
+        V a = simd_op<O>::load_(x);
+        V b = simd_op<O>::load_(x + w);
+        size_t i = 2*w;
+        for (; i + 2*w <= n; i += 2*w) {
+            a = simd_op<O>::combine_(a, simd_op<O>::load_(x + i));
+            b = simd_op<O>::combine_(b, simd_op<O>::load_(x + i + w));
+        }
+        a = simd_op<O>::combine_(a, b);
+        if (i + w <= n) {
+            a = simd_op<O>::combine_(a, simd_op<O>::load_(x + i));
+            i += w;
+        }
+        T lanes[w];
+        std::memcpy(lanes, &a, sizeof(V));
+        T r = reduce(op, lanes, w, std::false_type{});
+        for (; i < n; ++i) r = op(x[i], r);
+        return r;
+    }
+}
+//! @endcond
+
+
+/**
+ * @brief Reduces `n > 0` contiguous values through a folding operator.
+ *
+ * Vectorised for minimum, maximum and sum of floating-point and (8 to 32 bits) integral values,
+ * and for conjunction and disjunction of booleans; a scalar loop is used otherwise.
+ * Vectorised floating-point sums are computed in a different order than a sequential fold,
+ * and may thus differ in the last bits.
+ * Vectorised floating-point minimum and maximum are computed in a different order as well. They
+ * return the same value as a sequential fold of `std::min` or `std::max`, with two exceptions:
+ * - if the result is a zero, its sign may differ (`-0.0` and `0.0` compare equal);
+ * - if some value is NaN, the result may be NaN or a non-NaN value, whereas a sequential
+ *   fold is NaN only if the last value is NaN.
+ */
+template <typename O, typename T>
+inline T reduce(O const& op, T const* x, size_t n) {
+    return details::reduce(op, x, n, std::integral_constant<bool, details::simd_op<O>::value>{});
+}
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief Vector operations for distance checks on values of type `T` (general form, not vectorised).
+    template <typename T>
+    struct simd_dist {
+        static constexpr bool value = false;
+    };
+
+    //! @brief Defines vector operations for distance checks, given value and vector types, instruction prefix and suffix, and comparison mask expression.
+    #define _DEF_SIMD_DIST(T, V, pre, suf, le)          \
+    template <>                                         \
+    struct simd_dist<T> {                               \
+        static constexpr bool value = true;             \
+        using type = V;                                 \
+        static inline V load_(T const* p) {             \
+            return pre##_loadu_##suf(p);                \
+        }                                               \
+        static inline V set1_(T x) {                    \
+            return pre##_set1_##suf(x);                 \
+        }                                               \
+        static inline V sub_(V a, V b) {                \
+            return pre##_sub_##suf(a, b);               \
+        }                                               \
+        static inline V add_(V a, V b) {                \
+            return pre##_add_##suf(a, b);               \
+        }                                               \
+        static inline V mul_(V a, V b) {                \
+            return pre##_mul_##suf(a, b);               \
+        }                                               \
+        static inline uint64_t le_(V a, V b) {          \
+            return (uint64_t)le;                        \
+        }                                               \
+    };
+
+#if defined(__AVX2__)
+    _DEF_SIMD_DIST(double, __m256d, _mm256, pd, _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ)))
+    _DEF_SIMD_DIST(float,  __m256,  _mm256, ps, _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ)))
+#elif defined(__SSE2__)
+    _DEF_SIMD_DIST(double, __m128d, _mm, pd, _mm_movemask_pd(_mm_cmple_pd(a, b)))
+    _DEF_SIMD_DIST(float,  __m128,  _mm, ps, _mm_movemask_ps(_mm_cmple_ps(a, b)))
+#endif
+
+#undef _DEF_SIMD_DIST
+
+    //! @brief Scalar bitmask of the points from `i` to `k` within their radius from `c`.
+    template <size_t n, typename T>
+    inline uint64_t within_radius(T const* c, T const* x, size_t s, T const* r, bool uniform, size_t i, size_t k) {
+        uint64_t m = 0;
+        for (; i < k; ++i) {
+            T d = 0;
+            for (size_t j = 0; j < n; ++j) {
+                T e = x[j*s + i] - c[j];
+                T p = e * e; // in its own statement, not to be contracted with the sum
+                d += p;
+            }
+            T q = r[uniform ? 0 : i];
+            q *= q;
+            if (d <= q) m |= uint64_t(1) << i;
+        }
+        return m;
+    }
+
+    //! @brief Scalar bitmask of the `k` points within their radius from `c`.
+    template <size_t n, typename T>
+    inline uint64_t within_radius(T const* c, T const* x, size_t s, T const* r, bool uniform, size_t k, std::false_type) {
+        return within_radius<n>(c, x, s, r, uniform, 0, k);
+    }
+
+    //! @brief Vectorised bitmask of the `k` points within their radius from `c`, completed by a scalar loop.
+    template <size_t n, typename T>
+    uint64_t within_radius(T const* c, T const* x, size_t s, T const* r, bool uniform, size_t k, std::true_type) {
+        using D = simd_dist<T>;
+        using V = typename D::type;
+        constexpr size_t w = sizeof(V) / sizeof(T);
+        V cv[n];
+        for (size_t j = 0; j < n; ++j) cv[j] = D::set1_(c[j]);
+        V q = D::set1_(r[0]);
+        q = D::mul_(q, q);
+        uint64_t m = 0;
+        size_t i = 0;
+        for (; i + w <= k; i += w) {
+            V d = D::set1_(0);
+            for (size_t j = 0; j < n; ++j) {
+                V e = D::sub_(D::load_(x + j*s + i), cv[j]);
+                d = D::add_(d, D::mul_(e, e));
+            }
+            if (not uniform) {
+                q = D::load_(r + i);
+                q = D::mul_(q, q);
+            }
+            m |= D::le_(d, q) << i;
+        }
+        return m | within_radius<n>(c, x, s, r, uniform, i, k);
+    }
+}
+//! @endcond
+
+
+/**
+ * @brief Bitmask of the `k <= 64` points in `n` dimensions which are within their radius from a centre `c`.
+ *
+ * The `j`-th coordinate of the `i`-th point is `x[j*s + i]`, and its radius is `r[i]` (or `r[0]` for
+ * every point if `uniform`). The `i`-th bit of the result is set if the squared distance of the `i`-th
+ * point from `c` is at most its squared radius. Vectorised for floating-point values, computing the
+ * squared distances in the same order as a scalar loop, rounding every product before summing it.
+ * The result is thus the same as the scalar loop, unless the compiler contracts products and sums of
+ * the scalar loop into fused multiply-adds (as GCC may do across statements in GNU modes, or with
+ * `-ffp-contract=fast`): then points whose distance is within rounding of their radius may differ.
+ * Points whose squared distance and radius are computed exactly are classified in the same way anyway.
+ */
+template <size_t n, typename T>
+inline uint64_t within_radius(T const* c, T const* x, size_t s, T const* r, bool uniform, size_t k) {
+    return details::within_radius<n>(c, x, s, r, uniform, k, std::integral_constant<bool, details::simd_dist<T>::value>{});
+}
+
+
+}
+
+
+}
+
+#endif // FCPP_COMMON_SIMD_H_
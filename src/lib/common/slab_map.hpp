@@ -0,0 +1,274 @@
+// Copyright © 2021 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file slab_map.hpp
+ * @brief Implementation of the `slab_map` class template, a random access map storing values contiguously in cache-aligned slabs.
+ */
+
+#ifndef FCPP_COMMON_SLAB_MAP_H_
+#define FCPP_COMMON_SLAB_MAP_H_
+
+#include <cstddef>
+
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "lib/common/mutex.hpp"
+#include "lib/common/random_access_map.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+/**
+ * @brief Namespace containing objects of common use.
+ */
+namespace common {
+
+
+/**
+ * @brief Class providing the unordered map interface of `random_access_map`, with values stored in slabs of slots.
+ *
+ * Every value lives in a slot aligned to a cache line, within slabs of `N` contiguous slots, so that
+ * values never move and different values never share a cache line. Values are iterated through a
+ * dense array of pointers to their slots, from which erased values are removed by moving the last
+ * pointer in their place. Slots of erased values are reused by the following insertions.
+ *
+ * @param K Key type.
+ * @param T Mapped type.
+ * @param N Number of slots in a slab.
+ */
+template <typename K, typename T, size_t N = 64>
+class slab_map {
+  public:
+    //! @brief The key type.
+    using key_type = K;
+    //! @brief The mapped type.
+    using mapped_type = T;
+    //! @brief The value type.
+    using value_type = std::pair<const key_type, mapped_type>;
+    //! @brief Reference type.
+    using reference = value_type&;
+    //! @brief Const reference type.
+    using const_reference = const value_type&;
+    //! @brief Pointer type.
+    using pointer = value_type*;
+    //! @brief Const pointer type.
+    using const_pointer = const value_type*;
+    //! @brief The type for sizes.
+    using size_type = size_t;
+    //! @brief The type for pointer differences.
+    using difference_type = std::ptrdiff_t;
+
+  private:
+    //! @brief The internal vector type for random access.
+    using vec_t = std::vector<pointer>;
+
+  public:
+    //! @brief The iterator type.
+    using iterator = details::iterator<typename vec_t::iterator, value_type, difference_type, pointer, reference>;
+    //! @brief The const iterator type.
+    using const_iterator = details::iterator<typename vec_t::const_iterator, value_type, difference_type, const_pointer, const_reference>;
+
+    //! @name constructors
+    //! @{
+    //! @brief Default constructor.
+    slab_map() = default;
+
+    //! @brief Deleted copy constructor.
+    slab_map(const slab_map&) = delete;
+
+    //! @brief Move constructor.
+    slab_map(slab_map&& o) {
+        swap(o);
+    }
+    //! @}
+
+    //! @name assignment operators
+    //! @{
+    //! @brief Deleted copy assignment.
+    slab_map& operator=(const slab_map&) = delete;
+
+    //! @brief Move assignment.
+    slab_map& operator=(slab_map&& o) {
+        clear();
+        swap(o);
+        return *this;
+    }
+    //! @}
+
+    //! @brief Destructor.
+    ~slab_map() {
+        clear();
+    }
+
+    //! @brief Test whether the container is empty.
+    bool empty() const noexcept {
+        return m_values.empty();
+    }
+
+    //! @brief Returns the number of elements in the container.
+    size_type size() const noexcept {
+        return m_values.size();
+    }
+
+    //! @brief Returns an iterator pointing to the first element in the container.
+    iterator begin() noexcept {
+        return m_values.begin();
+    }
+
+    //! @brief Returns a const iterator pointing to the first element in the container.
+    const_iterator begin() const noexcept {
+        return m_values.cbegin();
+    }
+    const_iterator cbegin() const noexcept {
+        return m_values.cbegin();
+    }
+
+    //! @brief Returns an iterator pointing to the past-the-end element in the container.
+    iterator end() noexcept {
+        return m_values.end();
+    }
+
+    //! @brief Returns a const iterator pointing to the past-the-end element in the container.
+    const_iterator end() const noexcept {
+        return m_values.cend();
+    }
+    const_iterator cend() const noexcept {
+        return m_values.cend();
+    }
+
+    //! @brief Accesses an element of the container (throwing if not found).
+    mapped_type& at(key_type const& k) {
+        return m_values[index(k)]->second;
+    }
+    mapped_type const& at(key_type const& k) const {
+        return m_values[index(k)]->second;
+    }
+
+    //! @brief Searches the container for an element with a given key (end if not found).
+    iterator find(key_type const& k) {
+        auto it = m_idx.find(k);
+        return it == m_idx.end() ? end() : begin() + it->second;
+    }
+    const_iterator find(key_type const& k) const {
+        auto it = m_idx.find(k);
+        return it == m_idx.end() ? end() : begin() + it->second;
+    }
+
+    //! @brief Counts the elements with a specific key.
+    size_type count(key_type const& k) const {
+        return m_idx.count(k);
+    }
+
+    /**
+     * @brief Constructs and inserts an element (in place, even with non-movable values).
+     *
+     * The slot is taken only once the element is in the container: if the key is already present
+     * or an exception is thrown, the constructed element is destroyed and the slot stays free.
+     */
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        if (m_free.empty()) grow();
+        pointer p = ::new (m_free.back()) value_type(std::forward<Args>(args)...);
+        auto it = m_idx.find(p->first);
+        if (it != m_idx.end()) {
+            p->~value_type();
+            return {begin() + it->second, false};
+        }
+        try {
+            m_values.push_back(p);
+            m_idx.emplace(p->first, m_values.size() - 1);
+        } catch (...) {
+            if (not m_values.empty() and m_values.back() == p) m_values.pop_back();
+            p->~value_type();
+            throw;
+        }
+        m_free.pop_back();
+        return {end() - 1, true};
+    }
+
+    //! @brief Erases the element with a given key (returning the number of elements erased).
+    size_type erase(key_type const& k) {
+        auto it = m_idx.find(k);
+        if (it == m_idx.end()) return 0;
+        size_t i = it->second;
+        m_idx.erase(it);
+        pointer p = m_values[i];
+        if (i+1 < m_values.size()) {
+            m_values[i] = m_values.back();
+            m_idx[m_values[i]->first] = i;
+        }
+        m_values.pop_back();
+        p->~value_type();
+        m_free.push_back(p);
+        return 1;
+    }
+
+    //! @brief Clear content (keeping the slabs for reuse).
+    void clear() noexcept {
+        for (pointer p : m_values) {
+            p->~value_type();
+            m_free.push_back(p);
+        }
+        m_values.clear();
+        m_idx.clear();
+    }
+
+    //! @brief Swaps content with another map.
+    void swap(slab_map& o) {
+        std::swap(m_slabs,  o.m_slabs);
+        std::swap(m_free,   o.m_free);
+        std::swap(m_idx,    o.m_idx);
+        std::swap(m_values, o.m_values);
+    }
+
+  private:
+    //! @brief The size of a slot (a whole number of cache lines).
+    constexpr static size_t slot_size = (sizeof(value_type) + cache_line - 1) / cache_line * cache_line;
+
+    static_assert(alignof(value_type) <= cache_line, "values cannot be aligned beyond a cache line");
+
+    //! @brief The index of a key in the array of values (throwing if not found).
+    inline size_t index(key_type const& k) const {
+        auto it = m_idx.find(k);
+        if (it == m_idx.end()) throw std::out_of_range("slab_map::at");
+        return it->second;
+    }
+
+    //! @brief Allocates a new slab, adding its slots to the free ones (in increasing order of address when popped).
+    void grow() {
+        m_slabs.emplace_back(new char[N * slot_size + cache_line]);
+        size_t base = reinterpret_cast<size_t>(m_slabs.back().get());
+        base = (base + cache_line - 1) / cache_line * cache_line;
+        for (size_t i = N; i > 0; --i)
+            m_free.push_back(reinterpret_cast<pointer>(base + (i-1) * slot_size));
+    }
+
+    //! @brief The raw memory of the slabs.
+    std::vector<std::unique_ptr<char[]>> m_slabs;
+
+    //! @brief The free slots.
+    std::vector<pointer> m_free;
+
+    //! @brief The map from keys to indices in the array of values.
+    std::unordered_map<key_type, size_t> m_idx;
+
+    //! @brief The array of pointers to values.
+    vec_t m_values;
+};
+
+
+}
+
+
+}
+
+#endif // FCPP_COMMON_SLAB_MAP_H_
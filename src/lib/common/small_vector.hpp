@@ -0,0 +1,373 @@
+// Copyright © 2021 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file small_vector.hpp
+ * @brief Implementation of the `small_vector<T, N>` class template, a vector with inline storage for few elements.
+ */
+
+#ifndef FCPP_COMMON_SMALL_VECTOR_H_
+#define FCPP_COMMON_SMALL_VECTOR_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+/**
+ * @brief Namespace containing objects of common use.
+ */
+namespace common {
+
+
+/**
+ * @brief Vector-like container storing up to `N` elements inline, and switching to heap storage when exceeded.
+ *
+ * Supports the subset of the `std::vector` interface used throughout the library.
+ * Contrary to `std::vector<bool>`, elements are always stored as plain values (also for `bool`).
+ * Iterators are plain pointers, and are invalidated by any operation changing the size.
+ *
+ * @param T The type of the elements.
+ * @param N The number of elements stored inline.
+ */
+template <typename T, size_t N>
+class small_vector {
+  public:
+    //! @brief The type of the elements.
+    using value_type = T;
+
+    //! @brief The type of sizes.
+    using size_type = size_t;
+
+    //! @brief Mutable reference to elements.
+    using reference = T&;
+
+    //! @brief Immutable reference to elements.
+    using const_reference = T const&;
+
+    //! @brief Mutable iterator type.
+    using iterator = T*;
+
+    //! @brief Immutable iterator type.
+    using const_iterator = T const*;
+
+    //! @name constructors
+    //! @{
+    //! @brief Default constructor (creates an empty vector).
+    small_vector() : m_data(inline_data()), m_size(0), m_capacity(N) {}
+
+    //! @brief Constructor from an iterator range.
+    template <typename I, typename = typename std::iterator_traits<I>::iterator_category>
+    small_vector(I first, I last) : small_vector() {
+        insert(end(), first, last);
+    }
+
+    //! @brief Copy constructor.
+    small_vector(small_vector const& o) : small_vector(o.begin(), o.end()) {}
+
+    //! @brief Move constructor (never allocating).
+    small_vector(small_vector&& o) noexcept(std::is_nothrow_move_constructible<T>::value) : small_vector() {
+        steal(o);
+    }
+
+    //! @brief Conversion from a standard vector.
+    small_vector(std::vector<T> const& v) : small_vector(v.begin(), v.end()) {}
+    //! @}
+
+    //! @brief Destructor.
+    ~small_vector() {
+        clear();
+        deallocate();
+    }
+
+    //! @name assignment operators
+    //! @{
+    //! @brief Copy assignment.
+    small_vector& operator=(small_vector const& o) {
+        if (this != &o) {
+            clear();
+            insert(end(), o.begin(), o.end());
+        }
+        return *this;
+    }
+
+    //! @brief Move assignment (never allocating).
+    small_vector& operator=(small_vector&& o) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        if (this != &o) {
+            clear();
+            steal(o);
+        }
+        return *this;
+    }
+
+    //! @brief Assignment from a standard vector.
+    small_vector& operator=(std::vector<T> const& v) {
+        clear();
+        insert(end(), v.begin(), v.end());
+        return *this;
+    }
+    //! @}
+
+    //! @brief Equality operator.
+    bool operator==(small_vector const& o) const {
+        if (m_size != o.m_size) return false;
+        for (size_t i = 0; i < m_size; ++i)
+            if (not (m_data[i] == o.m_data[i])) return false;
+        return true;
+    }
+
+    //! @brief Inequality operator.
+    bool operator!=(small_vector const& o) const {
+        return not (*this == o);
+    }
+
+    //! @name element access
+    //! @{
+    inline T& operator[](size_t i) {
+        return m_data[i];
+    }
+    inline T const& operator[](size_t i) const {
+        return m_data[i];
+    }
+    inline T& front() {
+        return m_data[0];
+    }
+    inline T const& front() const {
+        return m_data[0];
+    }
+    inline T& back() {
+        return m_data[m_size-1];
+    }
+    inline T const& back() const {
+        return m_data[m_size-1];
+    }
+    inline T* data() {
+        return m_data;
+    }
+    inline T const* data() const {
+        return m_data;
+    }
+    //! @}
+
+    //! @name iterators
+    //! @{
+    inline iterator begin() {
+        return m_data;
+    }
+    inline const_iterator begin() const {
+        return m_data;
+    }
+    inline iterator end() {
+        return m_data + m_size;
+    }
+    inline const_iterator end() const {
+        return m_data + m_size;
+    }
+    //! @}
+
+    //! @name capacity
+    //! @{
+    inline bool empty() const {
+        return m_size == 0;
+    }
+    inline size_t size() const {
+        return m_size;
+    }
+    inline size_t capacity() const {
+        return m_capacity;
+    }
+    //! @brief Whether the elements are stored inline.
+    inline bool is_inline() const {
+        return m_data == inline_data();
+    }
+    //! @brief Ensures that the capacity is at least `n`.
+    void reserve(size_t n) {
+        if (n > m_capacity) reallocate(n);
+    }
+    //! @}
+
+    //! @name modifiers
+    //! @{
+    //! @brief Removes all elements (keeping the capacity).
+    void clear() {
+        destroy(m_data, m_data + m_size);
+        m_size = 0;
+    }
+
+    //! @brief Resizes the vector, default-constructing new elements.
+    void resize(size_t n) {
+        if (n < m_size) {
+            destroy(m_data + n, m_data + m_size);
+        } else {
+            reserve(n);
+            for (size_t i = m_size; i < n; ++i) new (m_data + i) T();
+        }
+        m_size = n;
+    }
+
+    //! @brief Resizes the vector, copy-constructing new elements from a value.
+    void resize(size_t n, T const& v) {
+        if (n < m_size) {
+            destroy(m_data + n, m_data + m_size);
+        } else {
+            T x(v);
+            reserve(n);
+            for (size_t i = m_size; i < n; ++i) new (m_data + i) T(x);
+        }
+        m_size = n;
+    }
+
+    //! @brief Appends an element constructed in place.
+    template <typename... Ts>
+    T& emplace_back(Ts&&... xs) {
+        if (m_size == m_capacity) {
+            T x(std::forward<Ts>(xs)...);
+            grow(m_size + 1);
+            new (m_data + m_size) T(std::move(x));
+        } else new (m_data + m_size) T(std::forward<Ts>(xs)...);
+        return m_data[m_size++];
+    }
+
+    //! @brief Appends an element by copy.
+    inline void push_back(T const& v) {
+        emplace_back(v);
+    }
+
+    //! @brief Appends an element by move.
+    inline void push_back(T&& v) {
+        emplace_back(std::move(v));
+    }
+
+    //! @brief Removes the last element.
+    void pop_back() {
+        m_data[--m_size].~T();
+    }
+
+    //! @brief Inserts an element before a position.
+    iterator insert(const_iterator pos, T v) {
+        size_t i = pos - m_data;
+        if (m_size == m_capacity) grow(m_size + 1);
+        if (i == m_size) {
+            new (m_data + m_size) T(std::move(v));
+        } else {
+            new (m_data + m_size) T(std::move(m_data[m_size-1]));
+            std::move_backward(m_data + i, m_data + m_size - 1, m_data + m_size);
+            m_data[i] = std::move(v);
+        }
+        ++m_size;
+        return m_data + i;
+    }
+
+    //! @brief Inserts a range of elements before a position.
+    template <typename I, typename = typename std::iterator_traits<I>::iterator_category>
+    iterator insert(const_iterator pos, I first, I last) {
+        size_t i = pos - m_data;
+        size_t k = m_size;
+        for (; first != last; ++first) emplace_back(*first);
+        std::rotate(m_data + i, m_data + k, m_data + m_size);
+        return m_data + i;
+    }
+
+    //! @brief Removes the elements in a range.
+    iterator erase(const_iterator first, const_iterator last) {
+        size_t i = first - m_data, j = last - m_data;
+        std::move(m_data + j, m_data + m_size, m_data + i);
+        destroy(m_data + m_size - (j - i), m_data + m_size);
+        m_size -= j - i;
+        return m_data + i;
+    }
+
+    //! @brief Removes the element at a position.
+    inline iterator erase(const_iterator pos) {
+        return erase(pos, pos + 1);
+    }
+    //! @}
+
+  private:
+    //! @brief Pointer to the inline storage.
+    inline T* inline_data() {
+        return reinterpret_cast<T*>(&m_inline);
+    }
+
+    //! @brief Const pointer to the inline storage.
+    inline T const* inline_data() const {
+        return reinterpret_cast<T const*>(&m_inline);
+    }
+
+    //! @brief Destroys the elements in a range.
+    static void destroy(T* first, T* last) {
+        for (; first != last; ++first) first->~T();
+    }
+
+    //! @brief Releases heap storage, if any.
+    void deallocate() {
+        if (not is_inline()) ::operator delete(m_data);
+        m_data = inline_data();
+        m_capacity = N;
+    }
+
+    //! @brief Moves the elements into a new storage of a given capacity.
+    void reallocate(size_t n) {
+        T* data = n <= N ? inline_data() : static_cast<T*>(::operator new(n * sizeof(T)));
+        if (data == m_data) return;
+        for (size_t i = 0; i < m_size; ++i) {
+            new (data + i) T(std::move(m_data[i]));
+            m_data[i].~T();
+        }
+        if (not is_inline()) ::operator delete(m_data);
+        m_data = data;
+        m_capacity = std::max(n, N);
+    }
+
+    //! @brief Increases the capacity geometrically to fit at least `n` elements.
+    inline void grow(size_t n) {
+        reallocate(std::max(n, 2 * m_capacity));
+    }
+
+    //! @brief Takes the content of another (empty-after) vector, when this is empty (without allocating, as inline content fits any storage).
+    void steal(small_vector& o) {
+        if (o.is_inline()) {
+            reserve(o.m_size);
+            for (size_t i = 0; i < o.m_size; ++i)
+                new (m_data + i) T(std::move(o.m_data[i]));
+            m_size = o.m_size;
+            o.clear();
+        } else {
+            deallocate();
+            m_data = o.m_data;
+            m_size = o.m_size;
+            m_capacity = o.m_capacity;
+            o.m_data = o.inline_data();
+            o.m_size = 0;
+            o.m_capacity = N;
+        }
+    }
+
+    //! @brief Pointer to the elements.
+    T* m_data;
+    //! @brief Number of elements.
+    size_t m_size;
+    //! @brief Number of elements that fit in the current storage.
+    size_t m_capacity;
+    //! @brief Inline storage.
+    typename std::aligned_storage<sizeof(T) * (N > 0 ? N : 1), alignof(T)>::type m_inline;
+};
+
+
+}
+
+
+}
+
+#endif // FCPP_COMMON_SMALL_VECTOR_H_
@@ -0,0 +1,321 @@
+// Copyright © 2021 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file thread_pool.hpp
+ * @brief Implementation of the `thread_pool` class, a persistent work-stealing pool of threads backing parallel algorithms.
+ */
+
+#ifndef FCPP_COMMON_THREAD_POOL_H_
+#define FCPP_COMMON_THREAD_POOL_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#ifndef FCPP_DISABLE_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#endif
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+/**
+ * @brief Namespace containing objects of common use.
+ */
+namespace common {
+
+
+#ifdef FCPP_DISABLE_THREADS
+//! @brief Single-threaded thread pool interface, executing tasks sequentially.
+class thread_pool {
+  public:
+    //! @brief The maximum number of worker threads.
+    constexpr static size_t capacity = 0;
+
+    //! @brief Constructor with a given number of workers (ignored).
+    thread_pool(size_t = 0) {}
+
+    //! @brief Deleted copy constructor.
+    thread_pool(thread_pool const&) = delete;
+
+    //! @brief The process-wide pool shared by all parallel algorithms.
+    static thread_pool& instance() {
+        static thread_pool pool;
+        return pool;
+    }
+
+    //! @brief The number of worker threads available.
+    inline size_t size() const {
+        return 0;
+    }
+
+    //! @brief Ensures that at least `n` worker threads are available (ignored).
+    inline void reserve(size_t) {}
+
+    //! @brief Executes `f(t)` for every `t` in `0 ... n-1`, returning when all are done.
+    template <typename F>
+    void run(size_t n, F&& f) {
+        for (size_t t=0; t<n; ++t) f(t);
+    }
+};
+#else
+/**
+ * @brief Persistent pool of worker threads, with per-worker task deques and work stealing.
+ *
+ * Workers are created lazily (up to @ref capacity) and kept alive until the pool is destroyed.
+ * A call to @ref run splits a job into tasks: the calling thread executes the first one,
+ * while the others are queued on the workers' deques. Idle workers steal tasks from the
+ * front of other deques, while tasks pushed by a worker are popped from the back of its own.
+ * Threads waiting for a job to complete execute pending tasks in the meantime, so that nested
+ * calls to @ref run never deadlock.
+ */
+class thread_pool {
+  public:
+    //! @brief The maximum number of worker threads.
+    constexpr static size_t capacity = 256;
+
+    //! @brief Constructor with a given number of workers.
+    thread_pool(size_t n = 0) : m_size(0), m_queued(0), m_next(0), m_stop(false) {
+        m_queues.resize(capacity);
+        m_threads.reserve(capacity);
+        reserve(n);
+    }
+
+    //! @brief Deleted copy constructor.
+    thread_pool(thread_pool const&) = delete;
+
+    //! @brief Destructor stopping and joining all workers.
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> l(m_sleep_mutex);
+            m_stop = true;
+        }
+        m_sleep.notify_all();
+        for (std::thread& t : m_threads) t.join();
+    }
+
+    //! @brief The process-wide pool shared by all parallel algorithms.
+    static thread_pool& instance() {
+        static thread_pool pool;
+        return pool;
+    }
+
+    //! @brief The number of worker threads available.
+    inline size_t size() const {
+        return m_size.load(std::memory_order_acquire);
+    }
+
+    //! @brief Ensures that at least `n` worker threads are available (up to @ref capacity).
+    void reserve(size_t n) {
+        if (n > capacity) n = capacity;
+        if (size() >= n) return;
+        std::lock_guard<std::mutex> l(m_grow_mutex);
+        for (size_t i = size(); i < n; ++i) {
+            m_queues[i].reset(new queue_type());
+            m_threads.emplace_back(&thread_pool::work, this, i);
+            m_size.store(i+1, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Executes `f(t)` for every `t` in `0 ... n-1`, returning when all are done.
+     *
+     * Calls with different values of `t` may be executed in parallel, while
+     * the calling thread executes `f(0)` and helps with pending tasks.
+     */
+    template <typename F>
+    void run(size_t n, F&& f) {
+        if (n == 0) return;
+        if (n == 1) {
+            f(0);
+            return;
+        }
+        using G = std::remove_reference_t<F>;
+        job_type j(n, [](void* g, size_t t) {
+            (*static_cast<G*>(g))(t);
+        }, (void*)&f);
+        reserve(n-1);
+        push(j, n);
+        execute(task_type{&j, 0});
+        wait(j);
+    }
+
+  private:
+    //! @brief A job, split into a number of tasks.
+    struct job_type {
+        //! @brief Member constructor.
+        job_type(size_t n, void (*c)(void*, size_t), void* f) : call(c), func(f), pending(n) {}
+
+        //! @brief Type-erased call to the job function.
+        void (*call)(void*, size_t);
+        //! @brief Pointer to the job function.
+        void* func;
+        //! @brief Number of tasks not yet completed.
+        std::atomic<size_t> pending;
+        //! @brief Mutex guarding job completion.
+        std::mutex mutex;
+        //! @brief Condition variable signalling job completion.
+        std::condition_variable done;
+    };
+
+    //! @brief A task, as a job with a given index.
+    struct task_type {
+        //! @brief The job of the task.
+        job_type* job;
+        //! @brief The index of the task within the job.
+        size_t index;
+    };
+
+    //! @brief A task deque owned by a worker.
+    struct queue_type {
+        //! @brief The tasks queued.
+        std::deque<task_type> tasks;
+        //! @brief Mutex guarding the deque.
+        std::mutex mutex;
+    };
+
+    //! @brief Index of the worker running in the current thread (or `capacity` if none).
+    static size_t& worker_index() {
+        thread_local size_t index = capacity;
+        return index;
+    }
+
+    //! @brief Pool owning the worker running in the current thread (if any).
+    static thread_pool*& worker_pool() {
+        thread_local thread_pool* pool = nullptr;
+        return pool;
+    }
+
+    //! @brief Index of the current worker in this pool (or `capacity` if none).
+    inline size_t self() const {
+        return worker_pool() == this ? worker_index() : capacity;
+    }
+
+    //! @brief Queues tasks `1 ... n-1` of a job.
+    void push(job_type& j, size_t n) {
+        size_t w = self();
+        if (w < capacity) {
+            std::lock_guard<std::mutex> l(m_queues[w]->mutex);
+            for (size_t t = 1; t < n; ++t)
+                m_queues[w]->tasks.push_back(task_type{&j, t});
+        } else {
+            size_t s = size();
+            size_t k = m_next.fetch_add(n-1, std::memory_order_relaxed);
+            for (size_t t = 1; t < n; ++t) {
+                queue_type& q = *m_queues[(k+t) % s];
+                std::lock_guard<std::mutex> l(q.mutex);
+                q.tasks.push_back(task_type{&j, t});
+            }
+        }
+        m_queued.fetch_add(n-1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> l(m_sleep_mutex);
+        }
+        m_sleep.notify_all();
+    }
+
+    //! @brief Takes a task from the back of the own deque, or from the front of other deques.
+    bool acquire(task_type& t) {
+        if (m_queued.load(std::memory_order_acquire) == 0) return false;
+        size_t s = size();
+        size_t w = self();
+        if (w < capacity) {
+            queue_type& q = *m_queues[w];
+            std::lock_guard<std::mutex> l(q.mutex);
+            if (not q.tasks.empty()) {
+                t = q.tasks.back();
+                q.tasks.pop_back();
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        } else w = 0;
+        for (size_t i = 1; i <= s; ++i) {
+            queue_type& q = *m_queues[(w+i) % s];
+            std::lock_guard<std::mutex> l(q.mutex);
+            if (not q.tasks.empty()) {
+                t = q.tasks.front();
+                q.tasks.pop_front();
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //! @brief Executes a task, signalling job completion if it is the last one.
+    static void execute(task_type t) {
+        job_type& j = *t.job;
+        j.call(j.func, t.index);
+        std::lock_guard<std::mutex> l(j.mutex);
+        if (j.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            j.done.notify_all();
+    }
+
+    //! @brief Waits for the completion of a job, executing pending tasks in the meantime.
+    void wait(job_type& j) {
+        task_type t;
+        while (j.pending.load(std::memory_order_acquire) > 0 and acquire(t))
+            execute(t);
+        // no task of the job is still queued: the remaining ones are in execution
+        std::unique_lock<std::mutex> l(j.mutex);
+        j.done.wait(l, [&j](){
+            return j.pending.load(std::memory_order_acquire) == 0;
+        });
+    }
+
+    //! @brief Main loop of a worker thread.
+    void work(size_t w) {
+        worker_pool() = this;
+        worker_index() = w;
+        task_type t;
+        while (true) {
+            if (acquire(t)) {
+                execute(t);
+                continue;
+            }
+            std::unique_lock<std::mutex> l(m_sleep_mutex);
+            m_sleep.wait(l, [this](){
+                return m_stop or m_queued.load(std::memory_order_acquire) > 0;
+            });
+            if (m_stop) return;
+        }
+    }
+
+    //! @brief The task deques, one for each worker.
+    std::vector<std::unique_ptr<queue_type>> m_queues;
+    //! @brief The worker threads.
+    std::vector<std::thread> m_threads;
+    //! @brief The number of workers created.
+    std::atomic<size_t> m_size;
+    //! @brief The number of tasks currently queued.
+    std::atomic<size_t> m_queued;
+    //! @brief Round-robin counter for distributing tasks from outside the pool.
+    std::atomic<size_t> m_next;
+    //! @brief Whether the workers should stop.
+    bool m_stop;
+    //! @brief Mutex regulating the creation of workers.
+    std::mutex m_grow_mutex;
+    //! @brief Mutex regulating idle workers.
+    std::mutex m_sleep_mutex;
+    //! @brief Condition variable waking idle workers.
+    std::condition_variable m_sleep;
+};
+#endif
+
+
+}
+
+
+}
+
+#endif // FCPP_COMMON_THREAD_POOL_H_
@@ -554,22 +554,22 @@ using partial_decay = typename details::partial_decay<T>::type;
 
 //! @cond INTERNAL
 namespace details {
-    //! @brief Type referencing vector values (value type case).
+    //! @brief Type referencing field values (value type case).
     template <typename T>
     struct vectorize {
-        using type = typename std::vector<T>::value_type;
+        using type = T;
     };
 
-    //! @brief Type referencing vector values (reference case).
+    //! @brief Type referencing field values (reference case).
     template <typename T>
     struct vectorize<T&> {
-        using type = typename std::vector<T>::reference;
+        using type = T&;
     };
 
-    //! @brief Type referencing vector values (const reference case).
+    //! @brief Type referencing field values (const reference case).
     template <typename T>
     struct vectorize<T const&> {
-        using type = typename std::vector<T>::const_reference;
+        using type = T const&;
     };
 
     //! @brief General form.
@@ -12,6 +12,7 @@
 #include <chrono>
 #include <iostream>
 #include <limits>
+#include <vector>
 
 #include "lib/settings.hpp"
 #include "lib/common/mutex.hpp"
@@ -165,6 +166,9 @@ struct base {
             //! @brief Performs computations at round end with current time `t`.
             void round_end(times_t) {}
 
+            //! @brief Restricts data about neighbours to a sorted domain of devices (called when the domain is frozen).
+            void align_neighbours(std::vector<device_t> const&) {}
+
             //! @brief Receives an incoming message (possibly reading values from sensors).
             template <typename S, typename T>
             void receive(times_t, device_t, const common::tagged_tuple<S,T>&) {}
@@ -178,9 +182,15 @@ struct base {
             //! @brief The unique identifier of the device.
             const device_t uid;
 
-            //! @brief A mutex for regulating access to the node.
+            //! @brief Padding separating the mutex from the previous data in parallel (not to be used).
+            common::cache_padding<parallel> mutex_padding_before;
+
+            //! @brief A mutex for regulating access to the node (on its own cache line in parallel).
             mutex_type mutex;
 
+            //! @brief Padding separating the mutex from the following data in parallel (not to be used).
+            common::cache_padding<parallel> mutex_padding_after;
+
             //! @brief A reference to the corresponding net object.
             typename F::net& net;
 
@@ -11,6 +11,7 @@
 #include <cassert>
 
 #include <limits>
+#include <memory>
 #include <unordered_map>
 
 #include "lib/internal/context.hpp"
@@ -69,10 +70,30 @@ namespace tags {
     template <bool b>
     struct export_split {};
 
+    //! @brief Declaration flag associating to whether exports are stored in flat sorted arrays instead of hash maps.
+    template <bool b>
+    struct export_flat {};
+
+    //! @brief Declaration flag associating to whether exports are stored at dense slots assigned per network.
+    template <bool b>
+    struct export_schema {};
+
+    //! @brief Declaration flag associating to whether references to exports in pointers are counted at the end of epochs (requires rounds executed through an identifier).
+    template <bool b>
+    struct export_epoch {};
+
     //! @brief Declaration flag associating to whether messages are dropped as they arrive (reduces memory footprint).
     template <bool b>
     struct online_drop {};
 
+    //! @brief Declaration flag associating to whether neighbours are indexed by trace at round start.
+    template <bool b>
+    struct trace_index {};
+
+    //! @brief Declaration flag associating to whether exports with metrics growing linearly in time expire through a timing wheel.
+    template <bool b>
+    struct expiry_wheel {};
+
     //! @brief Node initialisation tag associating to the maximum size for a neighbourhood.
     struct hoodsize {};
 
@@ -92,7 +113,12 @@ namespace tags {
  * <b>Declaration flags:</b>
  * - \ref tags::export_pointer defines whether exports are wrapped in smart pointers (defaults to \ref FCPP_EXPORT_PTR).
  * - \ref tags::export_split defines whether exports for neighbours are split from those for self (defaults to \ref FCPP_EXPORT_NUM `== 2`).
+ * - \ref tags::export_flat defines whether exports are stored in flat sorted arrays instead of hash maps (defaults to \ref FCPP_EXPORT_FLAT).
+ * - \ref tags::export_schema defines whether exports are stored at dense slots assigned per network, for programs with a fixed call structure (defaults to \ref FCPP_EXPORT_SCHEMA).
+ * - \ref tags::export_epoch defines whether references to exports in pointers are counted at the end of epochs instead of atomically, for simulations through an identifier (defaults to \ref FCPP_EXPORT_EPOCH).
  * - \ref tags::online_drop defines whether messages are dropped as they arrive (defaults to \ref FCPP_ONLINE_DROP).
+ * - \ref tags::trace_index defines whether neighbours are indexed by trace at round start, for programs querying traces repeatedly (defaults to \ref FCPP_TRACE_INDEX).
+ * - \ref tags::expiry_wheel defines whether exports with metrics growing linearly in time (as \ref metric::retain) expire through a timing wheel, without \ref tags::online_drop (defaults to \ref FCPP_EXPIRY_WHEEL).
  *
  * <b>Node initialisation tags:</b>
  * - \ref tags::hoodsize associates to the maximum number of neighbours allowed (defaults to `std::numeric_limits<device_t>::%max()`).
@@ -148,9 +174,24 @@ struct calculus {
     //! @brief Whether exports for neighbours are split from those for self.
     constexpr static bool export_split = common::option_flag<tags::export_split, FCPP_EXPORT_NUM == 2, Ts...>;
 
+    //! @brief Whether exports are stored in flat sorted arrays instead of hash maps.
+    constexpr static bool export_flat = common::option_flag<tags::export_flat, FCPP_EXPORT_FLAT, Ts...>;
+
+    //! @brief Whether exports are stored at dense slots assigned per network.
+    constexpr static bool export_schema = common::option_flag<tags::export_schema, FCPP_EXPORT_SCHEMA, Ts...>;
+
+    //! @brief Whether references to exports in pointers are counted at the end of epochs.
+    constexpr static bool export_epoch = common::option_flag<tags::export_epoch, FCPP_EXPORT_EPOCH, Ts...>;
+
     //! @brief Whether messages are dropped as they arrive.
     constexpr static bool online_drop = common::option_flag<tags::online_drop, FCPP_ONLINE_DROP, Ts...>;
 
+    //! @brief Whether neighbours are indexed by trace at round start.
+    constexpr static bool trace_index = common::option_flag<tags::trace_index, FCPP_TRACE_INDEX, Ts...>;
+
+    //! @brief Whether exports with metrics growing linearly in time expire through a timing wheel.
+    constexpr static bool expiry_wheel = common::option_flag<tags::expiry_wheel, FCPP_EXPIRY_WHEEL, Ts...>;
+
     /**
      * @brief The actual component.
      *
@@ -179,7 +220,7 @@ struct calculus {
             using metric_type = typename retain_type::result_type;
 
             //! @brief The type of the context of exports from other devices.
-            using context_type = internal::context_t<online_drop, export_pointer, metric_type, exports_type>;
+            using context_type = internal::context_t<online_drop, export_pointer, export_flat, export_schema, export_epoch, trace_index, expiry_wheel, metric_type, exports_type>;
 
             //! @brief The type of the exports of the current device.
             using export_type = typename context_type::export_type;
@@ -207,7 +248,9 @@ struct calculus {
                 P::node::round_start(t);
                 assert(stack_trace.empty());
                 m_context.second().freeze(m_hoodsize, P::node::uid);
+                P::node::as_final().align_neighbours(m_context.second().align(P::node::uid));
                 m_export = {};
+                attach_schema(common::bool_pack<export_schema>{});
             }
 
             //! @brief Performs computations at round middle with current time `t`.
@@ -244,6 +287,16 @@ struct calculus {
             internal::trace stack_trace;
 
           private: // implementation details
+            //! @brief Attaches the exports to the schema of the net.
+            void attach_schema(common::bool_pack<true>) {
+                auto schema = P::node::net.export_slots();
+                m_export.first()->attach(schema);
+                m_export.second()->attach(schema);
+            }
+
+            //! @brief Attaches the exports to the schema of the net (disabled).
+            void attach_schema(common::bool_pack<false>) {}
+
             //! @brief Map associating devices to their exports (`first` for local device, `second` for others).
             internal::twin<context_type, not export_split> m_context;
 
@@ -264,7 +317,24 @@ struct calculus {
         };
 
         //! @brief The global part of the component.
-        using net = typename P::net;
+        class net : public P::net {
+          public: // visible by node objects and the main program
+            //! @brief The type of the schema assigning dense slots to the traces of exports.
+            using schema_type = internal::export_schema_t<exports_type>;
+
+            //! @brief Constructor from a tagged tuple.
+            template <typename S, typename T>
+            net(common::tagged_tuple<S,T> const& t) : P::net(t), m_schema(export_schema ? std::make_shared<schema_type>() : nullptr) {}
+
+            //! @brief The schema assigning dense slots to the traces of exports, shared by the nodes of the net (null if \ref tags::export_schema is false).
+            std::shared_ptr<schema_type> export_slots() const {
+                return m_schema.front();
+            }
+
+          private: // implementation details
+            //! @brief The schema assigning dense slots to the traces of exports.
+            common::option<std::shared_ptr<schema_type>, export_schema> m_schema;
+        };
     };
 };
 
@@ -402,10 +472,11 @@ field<device_t> nbr_uid(node_t& node, trace_t call_point) {
     trace_t t = node.stack_trace.hash(call_point);
     details::get_export(node).second()->insert(t);
     std::vector<device_t> ids = details::get_context(node).second().align(t, node.uid);
-    std::vector<device_t> vals;
+    details::field_vals<device_t> vals;
+    vals.reserve(ids.size()+1);
     vals.emplace_back();
     vals.insert(vals.end(), ids.begin(), ids.end());
-    return details::make_field(std::move(ids), std::move(vals));
+    return details::make_field(details::field_ids(ids), std::move(vals));
 }
 //! @}
 
@@ -8,13 +8,21 @@
 #ifndef FCPP_COMPONENT_IDENTIFIER_H_
 #define FCPP_COMPONENT_IDENTIFIER_H_
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <map>
 #include <queue>
 #include <type_traits>
+#include <vector>
 
 #include "lib/common/algorithm.hpp"
-#include "lib/common/random_access_map.hpp"
+#include "lib/common/slab_map.hpp"
 #include "lib/component/base.hpp"
+#include "lib/internal/flat_ptr.hpp"
 
 
 /**
@@ -104,6 +112,258 @@ namespace details {
         //! @brief The actual priority queue.
         std::priority_queue<type, std::vector<type>, std::greater<type>> m_queue;
     };
+
+    /**
+     * @brief Calendar queue of pairs `(times_t, device_t)`, with amortised constant time operations on near-periodic schedules.
+     *
+     * Times are hashed into a circular array of buckets of a given width, so that finding the next
+     * events only scans the buckets following the current one. The number of buckets is kept
+     * proportional to the number of elements, and the width is estimated from the spread of times
+     * whenever the array is resized.
+     */
+    class calendar_queue {
+      public:
+        //! @brief Default constructor.
+        calendar_queue() : m_buckets(min_buckets), m_width(1), m_slot(0), m_size(0), m_next(TIME_MAX) {}
+
+        //! @brief The smallest time in the queue.
+        inline times_t next() const {
+            return m_next;
+        }
+
+        //! @brief Adds a new pair to the queue.
+        void push(times_t t, device_t uid) {
+            if (not (t < TIME_MAX)) {
+                m_never.push_back(uid);
+                return;
+            }
+            m_buckets[slot(t) & (m_buckets.size()-1)].emplace_back(t, uid);
+            ++m_size;
+            if (t < m_next) {
+                m_next = t;
+                m_slot = slot(t);
+            }
+            if (m_size > 2*m_buckets.size()) resize(2*m_buckets.size());
+        }
+
+        //! @brief Pops elements with times up to `t`, in increasing order.
+        std::vector<device_t> pop(times_t t) {
+            std::vector<device_t> v;
+            if (m_next > t) return v;
+            if (m_size > 0) {
+                m_popped.clear();
+                int64_t last = slot(t);
+                size_t mask = m_buckets.size()-1;
+                for (int64_t s = m_slot; s <= last and s < m_slot + int64_t(m_buckets.size()); ++s) {
+                    std::vector<type>& b = m_buckets[s & mask];
+                    for (size_t i = 0; i < b.size(); ) {
+                        if (b[i].first <= t) {
+                            m_popped.push_back(b[i]);
+                            b[i] = b.back();
+                            b.pop_back();
+                        } else ++i;
+                    }
+                }
+                m_size -= m_popped.size();
+                m_slot = std::max(m_slot, last);
+                std::sort(m_popped.begin(), m_popped.end());
+                v.reserve(m_popped.size());
+                for (type const& x : m_popped) v.push_back(x.second);
+            }
+            if (not (t < TIME_MAX)) {
+                v.insert(v.end(), m_never.begin(), m_never.end());
+                m_never.clear();
+            }
+            if (m_size < m_buckets.size()/4 and m_buckets.size() > min_buckets) resize(m_buckets.size()/2);
+            else find();
+            return v;
+        }
+
+      private:
+        //! @brief The type of queue elements.
+        using type = std::pair<times_t, device_t>;
+
+        //! @brief The minimum number of buckets.
+        constexpr static size_t min_buckets = 16;
+
+        //! @brief The slot of a time (clamped to avoid overflows).
+        inline int64_t slot(times_t t) const {
+            times_t s = t / m_width;
+            return s < times_t(int64_t(1) << 62) ? int64_t(std::floor(s)) : int64_t(1) << 62;
+        }
+
+        //! @brief Finds the smallest time in the queue, starting from the current slot.
+        void find() {
+            m_next = TIME_MAX;
+            if (m_size == 0) return;
+            size_t mask = m_buckets.size()-1;
+            for (size_t k = 0; k < m_buckets.size(); ++k, ++m_slot) {
+                for (type const& x : m_buckets[m_slot & mask])
+                    if (x.first < m_next and slot(x.first) == m_slot) m_next = x.first;
+                if (m_next < TIME_MAX) return;
+            }
+            // a whole turn of the calendar is empty: the width is re-estimated
+            resize(m_buckets.size());
+        }
+
+        //! @brief Rebuilds the calendar with a given number of buckets, estimating the width of buckets.
+        void resize(size_t n) {
+            std::vector<type> v;
+            v.reserve(m_size);
+            for (std::vector<type>& b : m_buckets)
+                v.insert(v.end(), b.begin(), b.end());
+            if (v.size() >= 2) {
+                // three times the average separation of times, ignoring the extremes
+                size_t lo = v.size() / 10, hi = v.size() - 1 - lo;
+                auto cmp = [](type const& x, type const& y) { return x.first < y.first; };
+                std::nth_element(v.begin(), v.begin() + lo, v.end(), cmp);
+                std::nth_element(v.begin() + lo, v.begin() + hi, v.end(), cmp);
+                times_t w = 3 * (v[hi].first - v[lo].first) / (hi - lo);
+                if (w > 0) m_width = w;
+            }
+            m_buckets.clear();
+            m_buckets.resize(n);
+            m_next = TIME_MAX;
+            for (type const& x : v) {
+                m_buckets[slot(x.first) & (n-1)].push_back(x);
+                m_next = std::min(m_next, x.first);
+            }
+            m_slot = slot(m_next);
+        }
+
+        //! @brief The buckets, as a circular array of slots.
+        std::vector<std::vector<type>> m_buckets;
+
+        //! @brief Elements which are never to be popped (before the end of time).
+        std::vector<device_t> m_never;
+
+        //! @brief Buffer of popped elements, for sorting them.
+        std::vector<type> m_popped;
+
+        //! @brief The width of buckets.
+        times_t m_width;
+
+        //! @brief The slot of the smallest time (no element has a smaller slot).
+        int64_t m_slot;
+
+        //! @brief The number of elements in buckets.
+        size_t m_size;
+
+        //! @brief The smallest time in the queue.
+        times_t m_next;
+    };
+
+    /**
+     * @brief Radix heap of pairs `(T, device_t)` for an integral time type `T`, with amortised constant time operations.
+     *
+     * Elements are kept in buckets by the highest bit in which their time differs from the last time popped,
+     * so that every element moves to a lower bucket at most once for every bit. Times earlier than the
+     * last time popped are postponed to it (times popped never decrease).
+     */
+    template <typename T>
+    class radix_queue {
+        static_assert(std::numeric_limits<T>::is_integer, "the radix queue requires integral times");
+
+      public:
+        //! @brief Default constructor.
+        radix_queue() : m_last(0), m_min(0), m_size(0) {}
+
+        //! @brief The smallest time in the queue.
+        inline T next() const {
+            return m_size > 0 ? from_key(m_min) : std::numeric_limits<T>::max();
+        }
+
+        //! @brief Adds a new pair to the queue.
+        void push(T t, device_t uid) {
+            key_type k = std::max(to_key(t), m_last);
+            if (k == m_last) m_front.push_back(uid);
+            else m_buckets[bit_width(k ^ m_last)-1].emplace_back(k, uid);
+            if (m_size == 0 or k < m_min) m_min = k;
+            ++m_size;
+        }
+
+        //! @brief Pops elements with times up to `t`, in increasing order.
+        std::vector<device_t> pop(T t) {
+            std::vector<device_t> v;
+            key_type k = to_key(t);
+            while (m_size > 0 and m_min <= k) {
+                if (m_front.empty()) refill();
+                m_size -= m_front.size();
+                v.insert(v.end(), m_front.begin(), m_front.end());
+                m_front.clear();
+                // the smallest key is in the first non-empty bucket
+                size_t i = first();
+                if (i < bits) {
+                    m_min = m_buckets[i][0].first;
+                    for (type const& x : m_buckets[i]) m_min = std::min(m_min, x.first);
+                }
+            }
+            return v;
+        }
+
+      private:
+        //! @brief The unsigned type of keys.
+        using key_type = std::make_unsigned_t<T>;
+
+        //! @brief The type of queue elements.
+        using type = std::pair<key_type, device_t>;
+
+        //! @brief The number of bits of keys.
+        constexpr static size_t bits = std::numeric_limits<key_type>::digits;
+
+        //! @brief Converts a time into a key with the same order.
+        static inline key_type to_key(T t) {
+            return key_type(t) ^ (std::numeric_limits<T>::is_signed ? key_type(1) << (bits-1) : 0);
+        }
+
+        //! @brief Converts a key back into a time.
+        static inline T from_key(key_type k) {
+            return T(k ^ (std::numeric_limits<T>::is_signed ? key_type(1) << (bits-1) : 0));
+        }
+
+        //! @brief The number of bits needed to represent a number.
+        static inline size_t bit_width(key_type x) {
+            size_t b = 0;
+            for (size_t s = bits/2; s > 0; s /= 2) if (x >> s) {
+                x >>= s;
+                b += s;
+            }
+            return b + (x > 0);
+        }
+
+        //! @brief The first non-empty bucket (`bits` if none).
+        inline size_t first() const {
+            size_t i = 0;
+            while (i < bits and m_buckets[i].empty()) ++i;
+            return i;
+        }
+
+        //! @brief Moves the elements with the smallest key to the front, splitting the first non-empty bucket.
+        void refill() {
+            std::vector<type>& b = m_buckets[first()];
+            m_last = m_min;
+            for (type const& x : b) {
+                if (x.first == m_last) m_front.push_back(x.second);
+                else m_buckets[bit_width(x.first ^ m_last)-1].push_back(x);
+            }
+            b.clear();
+        }
+
+        //! @brief The last key popped (no key in the queue is smaller).
+        key_type m_last;
+
+        //! @brief The smallest key in the queue.
+        key_type m_min;
+
+        //! @brief The number of elements in the queue.
+        size_t m_size;
+
+        //! @brief The elements with the last key popped.
+        std::vector<device_t> m_front;
+
+        //! @brief The other elements, by the highest bit in which they differ from the last key popped.
+        std::array<std::vector<type>, bits> m_buckets;
+    };
 }
 //! @endcond
 
@@ -118,6 +378,14 @@ namespace tags {
     template <bool b>
     struct synchronised {};
 
+    //! @brief Declaration flag associating to whether events are scheduled through a calendar queue.
+    template <bool b>
+    struct calendar {};
+
+    //! @brief Declaration flag associating to whether references to exports in pointers are counted at the end of epochs.
+    template <bool b>
+    struct export_epoch;
+
     //! @brief Node initialisation tag associating to the unique identifier of an object.
     struct uid;
 
@@ -137,12 +405,19 @@ namespace tags {
  * <b>Declaration flags:</b>
  * - \ref tags::parallel defines whether parallelism is enabled (defaults to \ref FCPP_PARALLEL).
  * - \ref tags::synchronised defines whether many events are expected to happen at the same time (defaults to \ref FCPP_SYNCHRONISED).
+ * - \ref tags::calendar defines whether events are scheduled through a calendar queue, which pays off with many nodes on near-periodic schedules (defaults to \ref FCPP_CALENDAR).
+ * - \ref tags::export_epoch defines whether epochs of exports shared through pointers end after every batch of rounds (defaults to \ref FCPP_EXPORT_EPOCH, see \ref calculus).
+ *   Exports are then shared in an epoch domain of the net, logging changes without synchronisation while nodes are created, updated and erased.
+ *
+ * Otherwise, events are scheduled through a radix heap if times are integral (see \ref FCPP_TIME_TYPE), and through a priority queue depending on \ref tags::synchronised if not.
  *
  * <b>Net initialisation tags:</b>
  * - \ref tags::epsilon associates to the time sensitivity, allowing indeterminacy below it (defaults to \ref FCPP_TIME_EPSILON).
- * - \ref tags::threads associates to the number of threads that can be created (defaults to \ref FCPP_THREADS).
+ * - \ref tags::threads associates to the number of threads that can be used (defaults to \ref FCPP_THREADS), taken from the persistent \ref common::thread_pool.
  *
  * Whenever \ref tags::parallel is false, \ref tags::threads is ignored and \ref tags::epsilon has only a minor effect (it is recommended to set it to zero).
+ * Otherwise, every node keeps a moving average of the time taken by its updates, so that nodes due at the same time
+ * are assigned dynamically to threads heaviest first; the resulting utilisation of threads is reported by `thread_utilisation()`.
  */
 template <class... Ts>
 struct identifier {
@@ -152,6 +427,12 @@ struct identifier {
     //! @brief Whether new values are pushed to aggregators or pulled when needed.
     constexpr static bool synchronised = common::option_flag<tags::synchronised, FCPP_SYNCHRONISED, Ts...>;
 
+    //! @brief Whether events are scheduled through a calendar queue.
+    constexpr static bool calendar = common::option_flag<tags::calendar, FCPP_CALENDAR, Ts...>;
+
+    //! @brief Whether epochs of exports shared through pointers end after every batch of rounds.
+    constexpr static bool export_epoch = common::option_flag<tags::export_epoch, FCPP_EXPORT_EPOCH, Ts...>;
+
     /**
      * @brief The actual component.
      *
@@ -166,8 +447,20 @@ struct identifier {
         DECLARE_COMPONENT(identifier);
         AVOID_COMPONENT(identifier,timer);
 
+        class net;
+
         //! @brief The local part of the component.
-        using node = typename P::node;
+        class node : public P::node {
+            friend class net;
+
+          public: // visible by net objects and the main program
+            //! @brief Inherited constructors.
+            using P::node::node;
+
+          private: // implementation details
+            //! @brief Moving average of the time taken by updates (zero if unknown).
+            real_t m_cost = 0;
+        };
 
         //! @brief The global part of the component.
         class net : public P::net {
@@ -176,14 +469,22 @@ struct identifier {
             using node_type = typename F::node;
 
             //! @brief The map type used internally for storing nodes.
-            using map_type = common::random_access_map<device_t, node_type>;
+            using map_type = common::slab_map<device_t, node_type>;
 
             //! @brief The type of node locks.
             using lock_type = common::unique_lock<parallel>;
 
             //! @brief Constructor from a tagged tuple.
             template <typename S, typename T>
-            net(common::tagged_tuple<S,T> const& t) : P::net(t), m_next_uid(0), m_epsilon(common::get_or<tags::epsilon>(t, FCPP_TIME_EPSILON)), m_threads(common::get_or<tags::threads>(t, FCPP_THREADS)) {}
+            net(common::tagged_tuple<S,T> const& t) : P::net(t), m_epoch(export_epoch ? std::max<size_t>(parallel ? common::get_or<tags::threads>(t, FCPP_THREADS) : 1, 1) : 0), m_next_uid(0), m_epsilon(common::get_or<tags::epsilon>(t, FCPP_TIME_EPSILON)), m_threads(common::get_or<tags::threads>(t, FCPP_THREADS)) {
+                if (parallel and m_threads > 1) common::thread_pool::instance().reserve(m_threads-1);
+                if (parallel) m_busy.resize(m_threads * busy_stride, 0);
+            }
+
+            //! @brief Destructor ensuring that nodes are deleted within the epoch domain.
+            ~net() {
+                node_clear();
+            }
 
             /**
              * @brief Returns next event to schedule for the net component.
@@ -198,9 +499,11 @@ struct identifier {
             void update() {
                 if (m_queue.next() < P::net::next()) {
                     std::vector<device_t> nv = m_queue.pop(m_queue.next() + m_epsilon);
-                    common::parallel_for(common::tags::general_execution<parallel>(m_threads), nv.size(), [&nv,this](size_t i, size_t){
+                    if (parallel and m_threads > 1 and nv.size() > 1) balanced_update(nv);
+                    else common::parallel_for(common::tags::general_execution<parallel>(m_threads), nv.size(), [&nv,this](size_t i, size_t t){
                         if (m_nodes.count(nv[i]) > 0) {
                             node_type& n = m_nodes.at(nv[i]);
+                            internal::epoch_scope<export_epoch> scope(m_epoch, t);
                             common::lock_guard<parallel> device_lock(n.mutex);
                             n.update();
                         }
@@ -210,9 +513,23 @@ struct identifier {
                         if (nxt < TIME_MAX) m_queue.push(nxt, uid);
                         else node_erase(uid);
                     }
+                    // no node is running, so that exports no longer referenced can be reclaimed
+                    if (export_epoch) m_epoch.end_epoch();
                 } else P::net::update();
             }
 
+            /**
+             * @brief Fraction of time spent updating nodes by each thread, during parallel updates of multiple nodes.
+             *
+             * Empty if parallelism is disabled, zero before the first parallel update.
+             */
+            std::vector<real_t> thread_utilisation() const {
+                std::vector<real_t> u;
+                for (size_t t = 0; t < m_busy.size(); t += busy_stride)
+                    u.push_back(m_elapsed > 0 ? m_busy[t] / m_elapsed : 0);
+                return u;
+            }
+
             //! @brief Returns the total number of nodes.
             inline size_t node_size() const {
                 return m_nodes.size();
@@ -260,6 +577,7 @@ struct identifier {
             device_t node_emplace(common::tagged_tuple<S,T> const& t) {
                 auto tt = push_uid(t, typename S::template intersect<tags::uid>());
                 device_t const& id = common::get<tags::uid>(tt);
+                internal::epoch_scope<export_epoch> scope(m_epoch);
                 m_nodes.emplace(std::piecewise_construct, std::make_tuple(id), std::tuple<typename F::net&, decltype(tt)>(P::net::as_final(), tt));
                 m_queue.push(m_nodes.at(id).next(), id);
                 return id;
@@ -267,15 +585,59 @@ struct identifier {
 
             //! @brief Erases the node with a given identifier.
             inline size_t node_erase(device_t uid) {
+                internal::epoch_scope<export_epoch> scope(m_epoch);
                 return m_nodes.erase(uid);
             }
 
-            //! @brief Erases all nodes.
+            //! @brief Erases all nodes, reclaiming their exports.
             inline void node_clear() {
-                m_nodes.clear();
+                {
+                    internal::epoch_scope<export_epoch> scope(m_epoch);
+                    m_nodes.clear();
+                }
+                if (export_epoch) m_epoch.end_epoch();
             }
 
           private: // implementation details
+            //! @brief The clock used for measuring update costs.
+            using clock_type = std::chrono::steady_clock;
+
+            //! @brief The type of durations.
+            using duration_type = std::chrono::duration<real_t>;
+
+            //! @brief The distance between busy times of different threads (avoiding false sharing).
+            constexpr static size_t busy_stride = (common::cache_line + sizeof(real_t) - 1) / sizeof(real_t);
+
+            //! @brief Updates a batch of nodes, assigning them dynamically to threads heaviest first and measuring their cost.
+            void balanced_update(std::vector<device_t> const& nv) {
+                std::vector<std::pair<real_t, node_type*>> jobs;
+                jobs.reserve(nv.size());
+                for (device_t uid : nv) {
+                    auto it = m_nodes.find(uid);
+                    if (it != m_nodes.end()) jobs.emplace_back(it->second.m_cost, &it->second);
+                }
+                std::sort(jobs.begin(), jobs.end(), [](auto const& a, auto const& b){
+                    return a.first > b.first;
+                });
+                auto start = clock_type::now();
+                common::parallel_for(common::tags::dynamic_execution(m_threads), jobs.size(), [&jobs,this](size_t i, size_t t){
+                    node_type& n = *jobs[i].second;
+                    auto begin = clock_type::now();
+                    {
+                        internal::epoch_scope<export_epoch> scope(m_epoch, t);
+                        common::lock_guard<parallel> device_lock(n.mutex);
+                        n.update();
+                    }
+                    jobs[i].first = std::chrono::duration_cast<duration_type>(clock_type::now() - begin).count();
+                    m_busy[t * busy_stride] += jobs[i].first;
+                });
+                m_elapsed += std::chrono::duration_cast<duration_type>(clock_type::now() - start).count();
+                for (auto const& j : jobs) {
+                    real_t& c = j.second->m_cost;
+                    c = c > 0 ? c + (j.first - c) / 4 : j.first;
+                }
+            }
+
             //! @brief Returns the next device UID to be created (without request).
             template <typename T>
             inline auto push_uid(T const& t, common::type_sequence<>) {
@@ -293,11 +655,14 @@ struct identifier {
                 return t;
             }
 
+            //! @brief The domain of exports shared by nodes, whose epochs end after every batch of rounds (empty if disabled).
+            internal::epoch_domain m_epoch;
+
             //! @brief The set of nodes, indexed by identifier.
             map_type m_nodes;
 
             //! @brief The queue of identifiers by next event.
-            details::times_queue<synchronised> m_queue;
+            std::conditional_t<calendar, details::calendar_queue, std::conditional_t<std::numeric_limits<times_t>::is_integer, details::radix_queue<times_t>, details::times_queue<synchronised>>> m_queue;
 
             //! @brief The next free identifier.
             device_t m_next_uid;
@@ -307,6 +672,12 @@ struct identifier {
 
             //! @brief The number of threads to be used.
             const size_t m_threads;
+
+            //! @brief The time spent updating nodes by each thread (every `busy_stride` positions).
+            std::vector<real_t> m_busy;
+
+            //! @brief The time spent in parallel updates.
+            real_t m_elapsed = 0;
         };
     };
 };
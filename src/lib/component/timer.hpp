@@ -13,6 +13,7 @@
 
 #include "lib/component/base.hpp"
 #include "lib/data/field.hpp"
+#include "lib/internal/field_builder.hpp"
 
 
 /**
@@ -93,14 +94,14 @@ struct timer {
              * Should correspond to the next time also during updates.
              */
             times_t next() const {
-                return m_next < TIME_MAX ? m_next : m_offs < TIME_MAX and P::node::next() < TIME_MAX ? P::node::next()/m_fact + m_offs : TIME_MAX;
+                return m_next < TIME_MAX ? m_next : m_offs < TIME_MAX and P::node::next() < TIME_MAX ? time_ceil(P::node::next()/m_fact) + m_offs : TIME_MAX;
             }
 
             //! @brief Updates the internal status of node component.
             void update() {
                 m_prev = m_cur;
                 m_cur = next();
-                fcpp::details::self(m_neigh, P::node::uid) = m_prev;
+                m_neigh.set(P::node::uid, m_prev);
                 if (m_next < TIME_MAX) {
                     // next round was planned
                     m_next = TIME_MAX;
@@ -115,7 +116,19 @@ struct timer {
             template <typename S, typename T>
             void receive(times_t t, device_t d, common::tagged_tuple<S,T> const& m) {
                 P::node::receive(t, d, m);
-                fcpp::details::self(m_neigh, d) = t;
+                m_neigh.set(d, t);
+            }
+
+            //! @brief Performs computations at round start with current time `t`.
+            void round_start(times_t t) {
+                m_neigh.merge();
+                P::node::round_start(t);
+            }
+
+            //! @brief Restricts data about neighbours to a sorted domain of devices (called when the domain is frozen).
+            void align_neighbours(std::vector<device_t> const& dom) {
+                m_neigh.align(dom);
+                P::node::align_neighbours(dom);
             }
 
             //! @brief Returns the time of the second most recent round (previous during rounds).
@@ -149,12 +162,12 @@ struct timer {
 
             //! @brief Returns the time stamps of the most recent messages from neighbours.
             field<times_t> const& message_time() const {
-                return m_neigh;
+                return m_neigh.get();
             }
 
             //! @brief Returns the time difference with neighbours.
             field<times_t> nbr_lag() const {
-                return m_cur - m_neigh;
+                return m_cur - m_neigh.get();
             }
 
             //! @brief Returns the warping factor applied to following schedulers.
@@ -164,7 +177,7 @@ struct timer {
 
             //! @brief Sets the warping factor applied to following schedulers.
             void frequency(real_t f) {
-                if (m_offs < TIME_MAX) m_offs = m_cur - times_t(m_fact*(m_cur - m_offs)/f);
+                if (m_offs < TIME_MAX) m_offs = m_cur - time_ceil(m_fact*(m_cur - m_offs)/f);
                 m_fact = f;
             }
 
@@ -173,7 +186,7 @@ struct timer {
             times_t m_prev, m_cur, m_next;
 
             //! @brief Times of neighbours.
-            field<times_t> m_neigh;
+            internal::field_builder<times_t> m_neigh;
 
             //! @brief Offset between the following schedule and actual times.
             times_t m_offs;
@@ -204,7 +217,7 @@ struct timer {
              */
             times_t next() const {
                 m_next_update = P::net::next();
-                return m_offs < TIME_MAX and m_fact > 0 and m_next_update < TIME_MAX ? m_next_update * m_inv + m_offs : TIME_MAX;
+                return m_offs < TIME_MAX and m_fact > 0 and m_next_update < TIME_MAX ? time_ceil(m_next_update * m_inv) + m_offs : TIME_MAX;
             }
 
             //! @brief Updates the internal status of net component.
@@ -216,7 +229,7 @@ struct timer {
             //! @brief A measure of the internal time clock.
             times_t internal_time() const {
                 if (not realtime or m_last_update == m_next_update or m_fact == 0 or m_inv == 0 or m_offs == TIME_MAX) return m_last_update;
-                times_t t = (P::net::real_time() - m_offs) * m_fact;
+                times_t t = time_ceil((P::net::real_time() - m_offs) * m_fact);
                 return std::max(std::min(t, m_next_update), m_last_update);
             }
 
@@ -235,9 +248,9 @@ struct timer {
                 assert(f >= 0);
                 if (m_offs == TIME_MAX) return; // execution terminated, nothing to do
                 if (f > 0 and m_fact > 0)
-                    m_offs += m_last_update * (m_inv - 1/f);
+                    m_offs += time_ceil(m_last_update * (m_inv - 1/f));
                 else if (f > 0) // resume
-                    m_offs = P::net::as_final().next() - m_next_update / f;
+                    m_offs = P::net::as_final().next() - time_ceil(m_next_update / f);
                 m_fact = f;
                 m_inv = 1/f;
             }
@@ -9,6 +9,8 @@
 #define FCPP_COORDINATION_COLLECTION_H_
 
 #include <cmath>
+
+#include <algorithm>
 #include <limits>
 
 #include "lib/coordination/utils.hpp"
@@ -76,7 +78,10 @@ T sp_collection(node_t& node, trace_t call_point, P const& distance, T const& va
 
     return nbr(node, 0, (T)null, [&](field<T> x){
         device_t parent = get<1>(min_hood( node, 0, make_tuple(nbr(node, 1, distance), nbr_uid(node, 0)) ));
-        return fold_hood(node, 0, accumulate, mux(nbr(node, 2, parent) == node.uid, x, (T)null), value);
+        // fused in the folding, without building the field of selected values
+        return fold_hood(node, 0, accumulate, fcpp::details::map_lazy([&] (device_t p, T const& v) -> T {
+            return p == node.uid ? v : (T)null;
+        }, nbr(node, 2, parent), x), value);
     });
 }
 
@@ -90,8 +95,13 @@ T mp_collection(node_t& node, trace_t call_point, P const& distance, T const& va
 
     return nbr(node, 0, (T)null, [&](field<T> x){
         field<P> nbrdist = nbr(node, 1, distance);
-        T v = fold_hood(node, 0, accumulate, mux(nbrdist > distance, x, (T)null), value);
-        int n = sum_hood(node, 0, mux(nbrdist < distance, 1, 0), 0);
+        // fused in the reductions, without building the fields of selected values
+        T v = fold_hood(node, 0, accumulate, fcpp::details::map_lazy([&] (P const& d, T const& v) -> T {
+            return d > distance ? v : (T)null;
+        }, nbrdist, x), value);
+        int n = sum_hood(node, 0, fcpp::details::map_lazy([&] (P const& d) {
+            return d < distance ? 1 : 0;
+        }, nbrdist), 0);
         return make_tuple(divide(v, max(n, 1)), v);
     });
 }
@@ -105,14 +115,17 @@ T wmp_collection(node_t& node, trace_t call_point, real_t distance, real_t radiu
     internal::trace_call trace_caller(node.stack_trace, call_point);
 
     field<real_t> nbrdist = nbr(node, 0, distance);
-    field<real_t> d = max(radius - node.nbr_dist(), field<real_t>{0});
-    field<real_t> p = mux(isinf(distance) or isinf(nbrdist), field<real_t>{0},  distance - nbrdist);
-    field<real_t> out_w = max(d * p, field<real_t>{0});
+    // weights computed in a single pass, without building the intermediate fields
+    field<real_t> out_w = fcpp::details::map_lazy([radius, distance] (real_t m, real_t n) {
+        real_t d = std::max(radius - m, real_t{0});
+        real_t p = std::isinf(distance) or std::isinf(n) ? real_t{0} : distance - n;
+        return std::max(d * p, real_t{0});
+    }, node.nbr_dist(), nbrdist);
     real_t factor = sum_hood(node, 0, out_w, real_t{0});
     if (factor == 0) factor = 1;
     field<real_t> in_w = nbr(node, 0, out_w / factor);
     return nbr(node, 1, value, [&](field<T> x){
-        return fold_hood(node, 0, accumulate, map_hood(multiply, x, in_w), value);
+        return fold_hood(node, 0, accumulate, fcpp::details::map_lazy(multiply, x, in_w), value);
     });
 }
 
@@ -11,6 +11,7 @@
 #include <cmath>
 
 #include <algorithm>
+#include <functional>
 #include <limits>
 
 #include "lib/coordination/utils.hpp"
@@ -56,7 +57,8 @@ real_t abf_distance(node_t& node, trace_t call_point, bool source, G&& metric) {
     internal::trace_call trace_caller(node.stack_trace, call_point);
 
     return nbr(node, 0, INF, [&] (field<real_t> d) {
-        return min_hood(node, 0, d + metric(), source ? 0 : INF);
+        // fused in the minimisation, without building the field of sums
+        return min_hood(node, 0, fcpp::details::map_lazy(std::plus<real_t>{}, d, metric()), source ? 0 : INF);
     });
 }
 
@@ -79,9 +81,12 @@ real_t bis_distance(node_t& node, trace_t call_point, bool source, times_t perio
 
     tuple<real_t,times_t> loc = source ? tuple<real_t,times_t>(0, 0) : make_tuple(INF, TIME_MAX);
     return get<0>(nbr(node, 0, loc, [&] (field<tuple<real_t,times_t>> x) {
-        field<real_t> d = get<0>(x) + metric();
-        field<times_t> t = get<1>(x) + node.nbr_lag();
-        return min_hood(node, 0, make_tuple(max(d, (t-period)*speed), t), loc);
+        // fused in the minimisation, without building the fields of distances and times
+        return min_hood(node, 0, fcpp::details::map_lazy([period, speed] (tuple<real_t,times_t> const& x, real_t m, times_t l) {
+            real_t d = get<0>(x) + m;
+            times_t t = get<1>(x) + l;
+            return make_tuple(std::max(d, real_t((t-period)*speed)), t);
+        }, x, metric(), node.nbr_lag()), loc);
     }));
 }
 
@@ -107,8 +112,13 @@ real_t flex_distance(node_t& node, trace_t call_point, bool source, real_t epsil
         field<real_t> dist = max(metric(), field<real_t>{distortion*radius});
         real_t old_d = get<0>(self(node, 0, x));
         int    old_c = get<1>(self(node, 0, x));
-        real_t new_d = min_hood(node, 0, get<0>(x) + dist, loc);
-        tuple<real_t,real_t,real_t> slopeinfo = max_hood(node, 0, make_tuple((old_d - get<0>(x))/dist, get<0>(x), dist), make_tuple(-INF, INF, 0));
+        // fused in the reductions, without building the fields of distances and slopes
+        real_t new_d = min_hood(node, 0, fcpp::details::map_lazy([] (tuple<real_t,int> const& x, real_t d) {
+            return get<0>(x) + d;
+        }, x, dist), loc);
+        tuple<real_t,real_t,real_t> slopeinfo = max_hood(node, 0, fcpp::details::map_lazy([old_d] (tuple<real_t,int> const& x, real_t d) {
+            return make_tuple((old_d - get<0>(x))/d, get<0>(x), d);
+        }, x, dist), make_tuple(-INF, INF, 0));
         if (old_d == new_d or new_d == 0 or old_c == frequency or
             old_d > max(2*new_d, radius) or new_d > max(2*old_d, radius))
             return make_tuple(new_d, 0);
@@ -14,6 +14,7 @@
 #include <limits>
 
 #include "lib/common/algorithm.hpp"
+#include "lib/common/simd.hpp"
 #include "lib/data/field.hpp"
 #include "lib/internal/trace.hpp"
 
@@ -224,102 +225,78 @@ namespace coordination {
 //! @brief Reduces a field to a single value by minimum.
 template <typename node_t, typename A>
 inline to_local<A> all_hood(node_t& node, trace_t call_point, A const& a) {
-    return fold_hood(node, call_point, [] (to_local<A> const& x, to_local<A> const& y) -> to_local<A> {
-        return x and y;
-    }, a);
+    return fold_hood(node, call_point, common::fold_all<to_local<A>>{}, a);
 }
 
 //! @brief Reduces a field to a single value by minimum with a default value for self.
 template <typename node_t, typename A, typename B>
 inline to_local<A> all_hood(node_t& node, trace_t call_point, A const& a, B const& b) {
-    return fold_hood(node, call_point, [] (to_local<A> const& x, to_local<A> const& y) -> to_local<A> {
-        return x and y;
-    }, a, b);
+    return fold_hood(node, call_point, common::fold_all<to_local<A>>{}, a, b);
 }
 
 
 //! @brief Reduces a field to a single value by maximum.
 template <typename node_t, typename A>
 inline to_local<A> any_hood(node_t& node, trace_t call_point, A const& a) {
-    return fold_hood(node, call_point, [] (to_local<A> const& x, to_local<A> const& y) -> to_local<A> {
-        return x or y;
-    }, a);
+    return fold_hood(node, call_point, common::fold_any<to_local<A>>{}, a);
 }
 
 //! @brief Reduces a field to a single value by maximum with a default value for self.
 template <typename node_t, typename A, typename B>
 inline to_local<A> any_hood(node_t& node, trace_t call_point, A const& a, B const& b) {
-    return fold_hood(node, call_point, [] (to_local<A> const& x, to_local<A> const& y) -> to_local<A> {
-        return x or y;
-    }, a, b);
+    return fold_hood(node, call_point, common::fold_any<to_local<A>>{}, a, b);
 }
 
 
 //! @brief Reduces a field to a single value by minimum.
 template <typename node_t, typename A>
 inline to_local<A> min_hood(node_t& node, trace_t call_point, A const& a) {
-    return fold_hood(node, call_point, [] (to_local<A> const& x, to_local<A> const& y) -> to_local<A> {
-        return std::min(x, y);
-    }, a);
+    return fold_hood(node, call_point, common::fold_min<to_local<A>>{}, a);
 }
 
 //! @brief Reduces a field to a single value by minimum with a default value for self.
 template <typename node_t, typename A, typename B>
 inline to_local<A> min_hood(node_t& node, trace_t call_point, A const& a, B const& b) {
-    return fold_hood(node, call_point, [] (to_local<A> const& x, to_local<A> const& y) -> to_local<A> {
-        return std::min(x, y);
-    }, a, b);
+    return fold_hood(node, call_point, common::fold_min<to_local<A>>{}, a, b);
 }
 
 
 //! @brief Reduces a field to a single value by maximum.
 template <typename node_t, typename A>
 inline to_local<A> max_hood(node_t& node, trace_t call_point, A const& a) {
-    return fold_hood(node, call_point, [] (to_local<A> const& x, to_local<A> const& y) -> to_local<A> {
-        return std::max(x, y);
-    }, a);
+    return fold_hood(node, call_point, common::fold_max<to_local<A>>{}, a);
 }
 
 //! @brief Reduces a field to a single value by maximum with a default value for self.
 template <typename node_t, typename A, typename B>
 inline to_local<A> max_hood(node_t& node, trace_t call_point, A const& a, B const& b) {
-    return fold_hood(node, call_point, [] (to_local<A> const& x, to_local<A> const& y) -> to_local<A> {
-        return std::max(x, y);
-    }, a, b);
+    return fold_hood(node, call_point, common::fold_max<to_local<A>>{}, a, b);
 }
 
 
 //! @brief Reduces a field to a single value by addition.
 template <typename node_t, typename A>
 inline to_local<A> sum_hood(node_t& node, trace_t call_point, A const& a) {
-    return fold_hood(node, call_point, [] (to_local<A> const& x, to_local<A> const& y) -> to_local<A> {
-        return x + y;
-    }, a);
+    return fold_hood(node, call_point, common::fold_sum<to_local<A>>{}, a);
 }
 
 //! @brief Reduces a field to a single value by addition with a default value for self.
 template <typename node_t, typename A, typename B>
 inline to_local<A> sum_hood(node_t& node, trace_t call_point, A const& a, B const& b) {
-    return fold_hood(node, call_point, [] (to_local<A> const& x, to_local<A> const& y) -> to_local<A> {
-        return x + y;
-    }, a, b);
+    return fold_hood(node, call_point, common::fold_sum<to_local<A>>{}, a, b);
 }
 
 
 //! @brief Reduces a field to a single value by averaging.
 template <typename node_t, typename A>
 inline to_local<A> mean_hood(node_t& node, trace_t call_point, A const& a) {
-    return fold_hood(node, call_point, [] (to_local<A> const& x, to_local<A> const& y) -> to_local<A> {
-        return x + y;
-    }, a) / count_hood(node, call_point);
+    return fold_hood(node, call_point, common::fold_sum<to_local<A>>{}, a) / count_hood(node, call_point);
 }
 
 //! @brief Reduces a field to a single value by averaging with a default value for self.
 template <typename node_t, typename A, typename B>
 inline to_local<A> mean_hood(node_t& node, trace_t call_point, A const& a, B const& b) {
-    return fold_hood(node, call_point, [] (to_local<A> const& x, to_local<A> const& y) -> to_local<A> {
-        return x + y;
-    }, a, b) / count_hood(node, call_point);
+    return fold_hood(node, call_point, common::fold_sum<to_local<A>>{}, a, b) / count_hood(node, call_point);
 }
 
 
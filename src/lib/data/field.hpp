@@ -15,6 +15,8 @@
 
 #include "lib/settings.hpp"
 #include "lib/common/serialize.hpp"
+#include "lib/common/simd.hpp"
+#include "lib/common/small_vector.hpp"
 #include "lib/data/tuple.hpp"
 
 
@@ -26,6 +28,33 @@ namespace fcpp {
 
 //! @cond INTERNAL
 template <typename T> class field;
+
+namespace details {
+    template <typename F, typename... As>
+    class field_expr;
+}
+
+namespace common {
+namespace details {
+    //! @brief Field expressions are collapsed to their value type.
+    template <typename F, typename... As>
+    struct extract_template<field, fcpp::details::field_expr<F, As...>, true> {
+        using type = typename fcpp::details::field_expr<F, As...>::value_type;
+    };
+
+    //! @brief Field expressions are collapsed to their value type (also through references).
+    template <typename F, typename... As>
+    struct extract_template<field, fcpp::details::field_expr<F, As...>&, true> {
+        using type = typename fcpp::details::field_expr<F, As...>::value_type;
+    };
+
+    //! @brief Field expressions are collapsed to their value type (also through const references).
+    template <typename F, typename... As>
+    struct extract_template<field, fcpp::details::field_expr<F, As...> const&, true> {
+        using type = typename fcpp::details::field_expr<F, As...>::value_type;
+    };
+}
+}
 //! @endcond
 
 
@@ -65,22 +94,31 @@ namespace details {
     template <bool b>
     struct field_base {};
 
+    //! @brief Container of the ids of exceptions in a field.
+    using field_ids = common::small_vector<device_t, FCPP_FIELD_INLINE>;
+
+    //! @brief Container of the values in a field (default value included).
+    template <typename A>
+    using field_vals = common::small_vector<A, FCPP_FIELD_INLINE+1>;
+
+    template <typename A>
+    field<A> make_field(field_ids&&, field_vals<A>&&);
     template <typename A>
     field<A> make_field(std::vector<device_t>&&, std::vector<A>&&);
 
     template <typename A>
-    std::vector<device_t>& get_ids(field<A>&);
+    field_ids& get_ids(field<A>&);
     template <typename A>
-    std::vector<device_t> get_ids(field<A>&&);
+    field_ids get_ids(field<A>&&);
     template <typename A>
-    std::vector<device_t> const& get_ids(field<A> const&);
+    field_ids const& get_ids(field<A> const&);
 
     template <typename A>
-    std::vector<A>& get_vals(field<A>&);
+    field_vals<A>& get_vals(field<A>&);
     template <typename A>
-    std::vector<A> get_vals(field<A>&&);
+    field_vals<A> get_vals(field<A>&&);
     template <typename A>
-    std::vector<A> const& get_vals(field<A> const&);
+    field_vals<A> const& get_vals(field<A> const&);
 
     template <typename A>
     if_local<A, to_local<A&&>> other(A&&);
@@ -88,6 +126,8 @@ namespace details {
     to_local<A&&> other(A&&);
     template <typename A, typename = if_field<A>, typename = common::if_class_template<tuple, A>>
     to_local<A&&> other(A&&);
+    template <typename F, typename... As>
+    to_local<field_expr<F, As...>> other(field_expr<F, As...> const&);
 
     template <typename A>
     if_local<A, to_local<A&&>> self(A&&, device_t);
@@ -95,6 +135,8 @@ namespace details {
     to_local<A&&> self(A&&, device_t);
     template <typename A, typename = if_field<A>, typename = common::if_class_template<tuple, A>>
     to_local<A&&> self(A&&, device_t);
+    template <typename F, typename... As>
+    to_local<field_expr<F, As...>> self(field_expr<F, As...> const&, device_t);
 
     template <typename A, typename = if_local<A>>
     inline A align(A&&, std::vector<device_t> const&);
@@ -106,6 +148,8 @@ namespace details {
     field<A> align(field<A> const&, std::vector<device_t> const&);
     template <typename A, typename = if_field<A>, typename = common::if_class_template<tuple, A>>
     decltype(auto) align(A&&, std::vector<device_t> const&);
+    template <typename F, typename... As>
+    to_field<field_expr<F, As...>> align(field_expr<F, As...> const&, std::vector<device_t> const&);
 
     template <typename A>
     field<A>& align_inplace(field<A>&, std::vector<device_t>&&);
@@ -133,21 +177,21 @@ class field : public details::field_base<std::is_same<T, bool>::value> {
     //! @brief Function friendships
     //! @{
     template <typename A>
-    friend field<A> details::make_field(std::vector<device_t>&&, std::vector<A>&&);
+    friend field<A> details::make_field(details::field_ids&&, details::field_vals<A>&&);
 
     template <typename A>
-    friend std::vector<device_t>& details::get_ids(field<A>&);
+    friend details::field_ids& details::get_ids(field<A>&);
     template <typename A>
-    friend std::vector<device_t> details::get_ids(field<A>&&);
+    friend details::field_ids details::get_ids(field<A>&&);
     template <typename A>
-    friend std::vector<device_t> const& details::get_ids(field<A> const&);
+    friend details::field_ids const& details::get_ids(field<A> const&);
 
     template <typename A>
-    friend std::vector<A>& details::get_vals(field<A>&);
+    friend details::field_vals<A>& details::get_vals(field<A>&);
     template <typename A>
-    friend std::vector<A> details::get_vals(field<A>&&);
+    friend details::field_vals<A> details::get_vals(field<A>&&);
     template <typename A>
-    friend std::vector<A> const& details::get_vals(field<A> const&);
+    friend details::field_vals<A> const& details::get_vals(field<A> const&);
     //! @}
     //! @endcond
 
@@ -182,7 +226,7 @@ class field : public details::field_base<std::is_same<T, bool>::value> {
 
     //! @brief Implicit conversion move constructor.
     template <typename A, typename = std::enable_if_t<std::is_convertible<A,T>::value>>
-    field(field<A>&& f) : m_ids(std::move(f.m_ids)), m_vals{make_move_iterator(f.m_vals.begin()), make_move_iterator(f.m_vals.end())} {}
+    field(field<A>&& f) : m_ids(std::move(f.m_ids)), m_vals{std::make_move_iterator(f.m_vals.begin()), std::make_move_iterator(f.m_vals.end())} {}
 
     //! @brief Implicit conversion copy constructor from field-like structures.
     template <typename A, typename = std::enable_if_t<std::is_convertible<to_local<A>,T>::value and (not common::is_class_template<fcpp::field,A>) and not std::is_convertible<A,T>::value>>
@@ -217,15 +261,15 @@ class field : public details::field_base<std::is_same<T, bool>::value> {
     field& operator=(field<A>&& f) {
         m_ids = std::move(f.m_ids);
         m_vals.clear();
-        m_vals.insert(m_vals.end(), make_move_iterator(f.m_vals.begin()), make_move_iterator(f.m_vals.end()));
+        m_vals.insert(m_vals.end(), std::make_move_iterator(f.m_vals.begin()), std::make_move_iterator(f.m_vals.end()));
         return *this;
     }
     //! @}
 
     //! @brief Exchanges the content of the `field` objects.
     void swap(field& f) {
-        swap(m_ids,  f.m_ids);
-        swap(m_vals, f.m_vals);
+        std::swap(m_ids,  f.m_ids);
+        std::swap(m_vals, f.m_vals);
     }
 
     //! @brief Serialises the content from/to a given input/output stream.
@@ -281,13 +325,13 @@ class field : public details::field_base<std::is_same<T, bool>::value> {
     }
 
     //! @brief Ordered IDs of exceptions.
-    std::vector<device_t> m_ids;
+    details::field_ids m_ids;
 
     //! @brief Corresponding values of exceptions (default value in position 0).
-    std::vector<T> m_vals;
+    details::field_vals<T> m_vals;
 
     //! @brief Member constructor, for internal use only.
-    field(std::vector<device_t>&& ids, std::vector<T>&& vals) : m_ids(std::move(ids)), m_vals(std::move(vals)) {}
+    field(details::field_ids&& ids, details::field_vals<T>&& vals) : m_ids(std::move(ids)), m_vals(std::move(vals)) {}
 };
 
 
@@ -305,22 +349,28 @@ namespace details {
 
     //! @brief Builds a field from member values.
     template <typename A>
-    field<A> make_field(std::vector<device_t>&& ids, std::vector<A>&& vals) {
+    field<A> make_field(field_ids&& ids, field_vals<A>&& vals) {
         return {std::move(ids), std::move(vals)};
     }
 
+    //! @brief Builds a field from member values in standard vectors.
+    template <typename A>
+    field<A> make_field(std::vector<device_t>&& ids, std::vector<A>&& vals) {
+        return make_field(field_ids(ids), field_vals<A>(std::make_move_iterator(vals.begin()), std::make_move_iterator(vals.end())));
+    }
+
     //! @brief Accesses the private field `m_ids` of a field.
     //! @{
     template <typename A>
-    std::vector<device_t>& get_ids(field<A>& f) {
+    field_ids& get_ids(field<A>& f) {
         return f.m_ids;
     }
     template <typename A>
-    std::vector<device_t> get_ids(field<A>&& f) {
+    field_ids get_ids(field<A>&& f) {
         return std::move(f.m_ids);
     }
     template <typename A>
-    std::vector<device_t> const& get_ids(field<A> const& f) {
+    field_ids const& get_ids(field<A> const& f) {
         return f.m_ids;
     }
     //! @}
@@ -328,15 +378,15 @@ namespace details {
     //! @brief Accesses the private field `m_vals` of a field.
     //! @{
     template <typename A>
-    std::vector<A>& get_vals(field<A>& f) {
+    field_vals<A>& get_vals(field<A>& f) {
         return f.m_vals;
     }
     template <typename A>
-    std::vector<A> get_vals(field<A>&& f) {
+    field_vals<A> get_vals(field<A>&& f) {
         return std::move(f.m_vals);
     }
     template <typename A>
-    std::vector<A> const& get_vals(field<A> const& f) {
+    field_vals<A> const& get_vals(field<A> const& f) {
         return f.m_vals;
     }
     //! @}
@@ -461,8 +511,8 @@ namespace details {
     }
     template <typename A>
     field<A> align(field<A> const& x, std::vector<device_t> const& s) {
-        std::vector<device_t> ids;
-        std::vector<A> vals;
+        field_ids ids;
+        field_vals<A> vals;
         ids.reserve(get_ids(x).size());
         vals.reserve(get_vals(x).size());
         vals.push_back(get_vals(x)[0]);
@@ -853,6 +903,229 @@ namespace details {
     }
     //! @}
 
+    /**
+     * @name field expressions
+     *
+     * Lazy pointwise application of an operator to field-like arguments.
+     */
+    //! @{
+    //! @brief Whether a type is a field expression.
+    template <typename A>
+    constexpr bool is_field_expr = common::is_class_template<field_expr, A>;
+
+    //! @brief How an argument of type `A` (as forwarded) is stored in a field expression.
+    template <typename A, bool = std::is_lvalue_reference<A>::value and (common::has_template<field, A> or is_field_expr<A>)>
+    struct expr_operand {
+        using type = std::decay_t<A>;
+    };
+
+    //! @brief Field-like lvalues (including expressions) are stored by reference.
+    template <typename A>
+    struct expr_operand<A, true> {
+        using type = std::decay_t<A> const&;
+    };
+
+    //! @brief Holder of an argument of a field expression (possibly a reference).
+    template <typename A>
+    struct expr_storage {
+        //! @brief Constructor from the argument (also from a temporary expression).
+        template <typename B>
+        expr_storage(B&& x) : value(std::forward<B>(x)) {}
+
+        //! @brief The stored argument.
+        A value;
+    };
+
+    //! @brief The type of a field expression applying `F` to arguments of types `A...` (as forwarded).
+    template <typename F, typename... A>
+    struct expr_type {
+        using type = field_expr<std::decay_t<F>, typename expr_operand<A>::type...>;
+    };
+
+    //! @brief Shorthand for the type of a field expression.
+    template <typename F, typename... A>
+    using expr_type_t = typename expr_type<F, A...>::type;
+
+    /**
+     * @brief Pointwise application of an operator to field-like arguments, evaluated lazily.
+     *
+     * Field-like lvalues are referenced, while temporaries (including nested expressions) are stored.
+     * The expression is a field-like structure: it is evaluated in a single pass over the merged
+     * domains of its arguments when converted to a field, iterated or folded.
+     * Expressions cannot be copied, and can be moved only privately into enclosing expressions, so that
+     * they do not outlive the full-expression building them (and the fields they reference): convert
+     * them to a `field` in order to store them.
+     */
+    template <typename F, typename... As>
+    class field_expr {
+        //! @cond INTERNAL
+        template <typename T, typename>
+        friend class field_iterator;
+        template <typename T>
+        friend struct expr_storage;
+        //! @endcond
+
+      public:
+        //! @brief The type of the content.
+        using value_type = std::decay_t<std::result_of_t<F const&(to_local<As const&>...)>>;
+
+        //! @brief Member constructor.
+        template <typename... Bs>
+        field_expr(F const& op, Bs&&... args) : m_op(op), m_args(std::forward<Bs>(args)...) {}
+
+        //! @brief Deleted copy constructor.
+        field_expr(field_expr const&) = delete;
+
+        //! @brief Deleted copy assignment.
+        field_expr& operator=(field_expr const&) = delete;
+
+        //! @brief The default value.
+        inline value_type other() const {
+            return other(std::make_index_sequence<sizeof...(As)>{});
+        }
+
+        //! @brief The value for a given device.
+        inline value_type self(device_t i) const {
+            return self(i, std::make_index_sequence<sizeof...(As)>{});
+        }
+
+        //! @brief Explicit cast to bool for expressions of bool (true if every value is true).
+        explicit operator bool() const {
+            if (not other()) return false;
+            for (field_iterator<field_expr const> it(*this); not it.end(); ++it)
+                if (not it.value()) return false;
+            return true;
+        }
+
+      private:
+        //! @brief Move constructor (only for storing temporary expressions into enclosing ones).
+        field_expr(field_expr&&) = default;
+
+        //! @brief The default value (with index sequence).
+        template <size_t... is>
+        inline value_type other(std::index_sequence<is...>) const {
+            return m_op(details::other(std::get<is>(m_args).value)...);
+        }
+
+        //! @brief The value for a given device (with index sequence).
+        template <size_t... is>
+        inline value_type self(device_t i, std::index_sequence<is...>) const {
+            return m_op(details::self(std::get<is>(m_args).value, i)...);
+        }
+
+        //! @brief The operator.
+        F m_op;
+        //! @brief The arguments.
+        std::tuple<expr_storage<As>...> m_args;
+    };
+
+    //! @brief Field expression case of field iterators.
+    template <typename F, typename... As>
+    class field_iterator<field_expr<F, As...> const, void> {
+      public:
+        //! @brief Constructor.
+        field_iterator(field_expr<F, As...> const& ref) : field_iterator(ref, std::make_index_sequence<sizeof...(As)>{}) {}
+
+        //! @brief Deleted constructor on temporary values.
+        field_iterator(field_expr<F, As...> const&&) = delete;
+
+        //! @brief Checks if the iterator reached the end.
+        inline bool end() const {
+            return m_id == std::numeric_limits<device_t>::max();
+        }
+
+        //! @brief Accesses the device id.
+        inline device_t id() const {
+            return m_id;
+        }
+
+        //! @brief Accesses the value.
+        inline to_local<field_expr<F, As...>> value() const {
+            return value(m_id, std::make_index_sequence<sizeof...(As)>{});
+        }
+
+        //! @brief Accesses the value (given a device id).
+        inline to_local<field_expr<F, As...>> value(device_t i) const {
+            return value(i, std::make_index_sequence<sizeof...(As)>{});
+        }
+
+        //! @brief Increments the iterator.
+        inline field_iterator& operator++() {
+            increment(std::make_index_sequence<sizeof...(As)>{});
+            return *this;
+        }
+
+      private:
+        //! @brief Constructor (with index sequence).
+        template <size_t... is>
+        field_iterator(field_expr<F, As...> const& ref, std::index_sequence<is...>) : m_ref(ref), m_its(field_iterator<std::remove_reference_t<As> const>{std::get<is>(ref.m_args).value}...) {
+            init(std::make_index_sequence<sizeof...(As)>{});
+        }
+
+        //! @brief Initialises the current iterated id.
+        template <size_t... is>
+        inline void init(std::index_sequence<is...>) {
+            device_t ids[] = {get<is>(m_its).id()...};
+            m_id = *std::min_element(ids, ids + sizeof...(As));
+        }
+
+        //! @brief Accesses the value (with index sequence).
+        template <size_t... is>
+        inline to_local<field_expr<F, As...>> value(device_t i, std::index_sequence<is...>) const {
+            return m_ref.m_op(get<is>(m_its).value(i)...);
+        }
+
+        //! @brief Increments the iterator (with index sequence).
+        template <size_t... is>
+        inline void increment(std::index_sequence<is...>) {
+            device_t ids[] = {(get<is>(m_its).id() == m_id ? ++get<is>(m_its) : get<is>(m_its)).id()...};
+            m_id = *std::min_element(ids, ids + sizeof...(As));
+        }
+
+        //! @brief Reference to the base expression.
+        field_expr<F, As...> const& m_ref;
+        //! @brief A tuple of iterators to the arguments.
+        tuple<field_iterator<std::remove_reference_t<As> const>...> m_its;
+        //! @brief The current iterated id.
+        device_t m_id;
+    };
+
+    //! @brief Field expression case of field iterators (non-const reference).
+    template <typename F, typename... As>
+    class field_iterator<field_expr<F, As...>, void> : public field_iterator<field_expr<F, As...> const, void> {
+        using field_iterator<field_expr<F, As...> const, void>::field_iterator;
+    };
+
+    //! @brief Default value of a field expression.
+    template <typename F, typename... As>
+    to_local<field_expr<F, As...>> other(field_expr<F, As...> const& x) {
+        return x.other();
+    }
+
+    //! @brief Value of a field expression for a given device.
+    template <typename F, typename... As>
+    to_local<field_expr<F, As...>> self(field_expr<F, As...> const& x, device_t i) {
+        return x.self(i);
+    }
+
+    //! @brief Restriction of a field expression to a given domain.
+    template <typename F, typename... As>
+    to_field<field_expr<F, As...>> align(field_expr<F, As...> const& x, std::vector<device_t> const& s) {
+        return align(to_field<field_expr<F, As...>>(x), s);
+    }
+
+    /**
+     * @brief Lazy version of `map_hood`, for internal use on values that are consumed right away.
+     *
+     * The result should be passed to a field constructor, a fold or a map in the same
+     * full-expression, and never be stored: field operators are always evaluated eagerly.
+     */
+    template <typename F, typename... A>
+    inline expr_type_t<F, A&&...> map_lazy(F&& op, A&&... a) {
+        return {op, std::forward<A>(a)...};
+    }
+    //! @}
+
     /**
      * @name align_inplace
      *
@@ -862,7 +1135,7 @@ namespace details {
     //! @brief Field case.
     template <typename A>
     field<A>& align_inplace(field<A>& x, std::vector<device_t>&& s) {
-        std::vector<A> vals;
+        field_vals<A> vals;
         vals.reserve(s.size()+1);
         vals.push_back(other(x));
         field_iterator<field<A> const> it(x);
@@ -888,10 +1161,23 @@ namespace details {
     }
     //! @{
 
+    //! @brief Size of the union of two domains (without computing it if small enough to fit inline).
+    inline size_t merged_size(field_ids const& x, field_ids const& y) {
+        if (x.size() + y.size() <= FCPP_FIELD_INLINE) return x.size() + y.size();
+        size_t n = 0, i = 0, j = 0;
+        while (i < x.size() and j < y.size()) {
+            if      (x[i] < y[j]) ++i;
+            else if (x[i] > y[j]) ++j;
+            else ++i, ++j;
+            ++n;
+        }
+        return n + (x.size() - i) + (y.size() - j);
+    }
+
     //! @brief Returns a fully aligned field with the default value modified.
     template <typename A, typename B>
     to_field<A> mod_other(A const& x, B const& y, std::vector<device_t>&& s) {
-        std::vector<to_local<A>> vals;
+        field_vals<to_local<A>> vals;
         vals.reserve(s.size()+1);
         vals.push_back(other(y));
         field_iterator<A const> it(x);
@@ -899,7 +1185,7 @@ namespace details {
             while (it.id() < i) ++it;
             vals.push_back(it.value(i));
         }
-        return make_field(std::move(s), std::move(vals));
+        return make_field(field_ids(s), std::move(vals));
     }
 
     /**
@@ -911,8 +1197,8 @@ namespace details {
     //! @brief General case.
     template <typename A, typename B>
     to_field<A> mod_self(A const& x, B const& y, device_t i) {
-        std::vector<device_t> ids;
-        std::vector<to_local<A>> vals;
+        field_ids ids;
+        field_vals<to_local<A>> vals;
         vals.push_back(other(x));
         field_iterator<A const> it(x);
         for (; it.id() < i; ++it) {
@@ -1015,6 +1301,62 @@ namespace details {
         }
         return res;
     }
+    //! @brief Folds the values of a field on a sorted range of devices into an accumulator, by vectorised reductions.
+    template <typename O, typename A>
+    void reduce_hood(O const& op, field<A> const& f, device_t const* first, device_t const* last, A& res, bool& init) {
+        field_ids const& ids = get_ids(f);
+        A const* vals = get_vals(f).data() + 1;
+        size_t n = last - first;
+        size_t j = std::lower_bound(ids.begin(), ids.end(), *first) - ids.begin();
+        if (ids.size() - j >= n and std::equal(first, last, ids.begin() + j)) {
+            // the field is aligned to the range: a single contiguous reduction
+            A r = common::reduce(op, vals + j, n);
+            res = init ? op(r, res) : r;
+            init = true;
+            return;
+        }
+        size_t missing = 0;
+        while (first != last) {
+            while (j < ids.size() and ids[j] < *first) ++j;
+            size_t k = 0;
+            while (first + k != last and j + k < ids.size() and ids[j+k] == first[k]) ++k;
+            if (k > 0) {
+                A r = common::reduce(op, vals + j, k);
+                res = init ? op(r, res) : r;
+                init = true;
+                first += k;
+                j += k;
+            } else {
+                ++missing;
+                ++first;
+            }
+        }
+        if (missing > 0) {
+            A r = O::repeat(get_vals(f)[0], missing);
+            res = init ? op(r, res) : r;
+            init = true;
+        }
+    }
+    //! @brief Inclusive folding (vectorised for arithmetic fields).
+    template <typename O, typename A, typename = std::enable_if_t<common::is_fold_op<std::decay_t<O>, A>>>
+    A fold_hood(O&& op, field<A> const& f, std::vector<device_t> const& dom) {
+        assert(dom.size() > 0);
+        A res;
+        bool init = false;
+        reduce_hood(op, f, dom.data(), dom.data() + dom.size(), res, init);
+        return res;
+    }
+    //! @brief Exclusive folding (vectorised for arithmetic fields).
+    template <typename O, typename A, typename B, typename = std::enable_if_t<common::is_fold_op<std::decay_t<O>, A>>>
+    A fold_hood(O&& op, field<A> const& f, B const& b, std::vector<device_t> const& dom, device_t i) {
+        assert(std::binary_search(dom.begin(), dom.end(), i));
+        A res = self(b, i);
+        bool init = true;
+        device_t const* mid = std::lower_bound(dom.data(), dom.data() + dom.size(), i);
+        if (mid != dom.data()) reduce_hood(op, f, dom.data(), mid, res, init);
+        if (mid+1 != dom.data() + dom.size()) reduce_hood(op, f, mid+1, dom.data() + dom.size(), res, init);
+        return res;
+    }
     //! @}
 }
 //! @endcond
@@ -1048,7 +1390,7 @@ field_result<F,field<T>,L...> map_hood(F&& op, field<T>&& f, L&&... l) {
     details::get_ids(r) = details::get_ids(std::move(f));
     details::get_vals(r).resize(details::get_vals(f).size());
     for (size_t i = 0; i < details::get_vals(f).size(); ++i)
-            details::get_vals(r)[i] = op(details::get_vals(std::move(f))[i], l...);
+            details::get_vals(r)[i] = op(std::move(details::get_vals(f)[i]), l...);
     return r;
 }
 //! @brief Optimisation for a single immutable field argument in first position.
@@ -1068,7 +1410,7 @@ field_result<F,A,field<T>,L...> map_hood(F&& op, A&& a, field<T>&& f, L&&... l)
     details::get_ids(r) = details::get_ids(std::move(f));
     details::get_vals(r).resize(details::get_vals(f).size());
     for (size_t i = 0; i < details::get_vals(f).size(); ++i)
-            details::get_vals(r)[i] = op(a, details::get_vals(std::move(f))[i], l...);
+            details::get_vals(r)[i] = op(a, std::move(details::get_vals(f)[i]), l...);
     return r;
 }
 //! @brief Optimisation for a single immutable field argument in second position.
@@ -1088,7 +1430,7 @@ field_result<F,A,B,field<T>,L...> map_hood(F&& op, A&& a, B&& b, field<T>&& f, L
     details::get_ids(r) = details::get_ids(std::move(f));
     details::get_vals(r).resize(details::get_vals(f).size());
     for (size_t i = 0; i < details::get_vals(f).size(); ++i)
-            details::get_vals(r)[i] = op(a, b, details::get_vals(std::move(f))[i], l...);
+            details::get_vals(r)[i] = op(a, b, std::move(details::get_vals(f)[i]), l...);
     return r;
 }
 //! @brief Optimisation for a single immutable field argument in third position.
@@ -1105,8 +1447,9 @@ field_result<F,A,B,field<T>,L...> map_hood(F&& op, A&& a, B&& b, field<T> const&
 template <typename F, typename T, typename U, typename... L, typename = if_local<tuple<L...>>>
 field_result<F,field<T>,field<U>,L...> map_hood(F&& op, field<T> const& f, field<U> const& g, L&&... l) {
     field_result<F,field<T>,field<U>,L...> r;
-    details::get_ids(r).reserve(details::get_ids(f).size() + details::get_ids(g).size());
-    details::get_vals(r).reserve(details::get_ids(f).size() + details::get_ids(g).size() + 1);
+    size_t n = details::merged_size(details::get_ids(f), details::get_ids(g));
+    details::get_ids(r).reserve(n);
+    details::get_vals(r).reserve(n + 1);
     details::get_vals(r).push_back(op(details::get_vals(f)[0], details::get_vals(g)[0], l...));
     size_t i = 0, j = 0;
     while (i < details::get_ids(f).size() or j < details::get_ids(g).size()) {
@@ -1150,7 +1493,7 @@ if_local<tuple<A,L...>, A&> mod_hood(F&& op, A& a, L&&... l) {
 //! @brief Optimisation for a single field argument in first position.
 template <typename F, typename A, typename... L>
 if_local<tuple<L...>, field<A>&> mod_hood(F&& op, field<A>& a, L const&... l) {
-    for (typename std::vector<A>::reference x : details::get_vals(a)) x = op(x, l...);
+    for (A& x : details::get_vals(a)) x = op(x, l...);
     return a;
 }
 //! @}
@@ -1175,7 +1518,7 @@ field<A> operator op(field<A> const& x) {
 template <typename A>                                                               \
 field<A> operator op(field<A>&& x) {                                                \
     mod_hood([] (A const& a) {return op std::move(a);}, x);                         \
-    return x;                                                                       \
+    return std::move(x);                                                            \
 }
 
 /**
@@ -1191,7 +1534,7 @@ _BOP_TYPE(field<A>,op,B) operator op(field<A> const& x, B const& y) {
 }                                                                                                       \
 template <typename A, typename B>                                                                       \
 _BOP_TYPE(field<A>,op,B) operator op(field<A>&& x, B const& y) {                                        \
-    return mod_hood([](A const& a, to_local<B> const& b) { return std::move(a) op b; }, x, y);          \
+    return std::move(mod_hood([](A const& a, to_local<B> const& b) { return std::move(a) op b; }, x, y)); \
 }                                                                                                       \
 template <typename A, typename B>                                                                       \
 common::ifn_class_template<field, A, _BOP_TYPE(A,op,field<B>)>                                          \
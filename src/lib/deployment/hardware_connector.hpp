@@ -19,6 +19,7 @@
 #include "lib/component/base.hpp"
 #include "lib/data/field.hpp"
 #include "lib/deployment/os.hpp"
+#include "lib/internal/field_builder.hpp"
 #include "lib/option/distribution.hpp"
 
 
@@ -157,7 +158,7 @@ struct hardware_connector {
                     common::osstream os;
                     typename F::node::message_t m;
                     os << P::node::as_final().send(m_send, m);
-                    fcpp::details::self(m_nbr_msg_size, P::node::uid) = os.size();
+                    m_nbr_msg_size.set(P::node::uid, os.size());
                     m_network.send(std::move(os));
                     P::node::as_final().receive(m_send, P::node::uid, m);
                     m_send = TIME_MAX;
@@ -172,9 +173,18 @@ struct hardware_connector {
                     common::unlock_guard<parallel> l(P::node::mutex);
                     for (message_type& m : mv) receive(m);
                 }
+                m_nbr_dist.merge();
+                m_nbr_msg_size.merge();
                 P::node::round_start(t);
             }
 
+            //! @brief Restricts data about neighbours to a sorted domain of devices (called when the domain is frozen).
+            void align_neighbours(std::vector<device_t> const& dom) {
+                m_nbr_dist.align(dom);
+                m_nbr_msg_size.align(dom);
+                P::node::align_neighbours(dom);
+            }
+
             //! @brief Receives an incoming message (possibly reading values from sensors).
             using P::node::receive;
 
@@ -182,8 +192,8 @@ struct hardware_connector {
             void receive(message_type& m) {
                 PROFILE_COUNT("connector");
                 common::lock_guard<parallel> l(P::node::mutex);
-                fcpp::details::self(m_nbr_dist, m.device) = m.power;
-                fcpp::details::self(m_nbr_msg_size, m.device) = m.content.size();
+                m_nbr_dist.set(m.device, m.power);
+                m_nbr_msg_size.set(m.device, m.content.size());
                 common::isstream is(std::move(m.content));
                 typename F::node::message_t mt;
                 #if __cpp_exceptions
@@ -199,17 +209,17 @@ struct hardware_connector {
 
             //! @brief Perceived distances from neighbours.
             field<real_t> const& nbr_dist() const {
-                return m_nbr_dist;
+                return m_nbr_dist.get();
             }
 
             //! @brief Size of last message sent.
             size_t msg_size() const {
-                return fcpp::details::self(m_nbr_msg_size, P::node::uid);
+                return fcpp::details::self(m_nbr_msg_size.get(), P::node::uid);
             }
 
             //! @brief Sizes of messages received from neighbours.
             field<size_t> const& nbr_msg_size() const {
-                return m_nbr_msg_size;
+                return m_nbr_msg_size.get();
             }
 
           private: // implementation details
@@ -232,10 +242,10 @@ struct hardware_connector {
             times_t m_send;
 
             //! @brief Perceived distances from neighbours.
-            field<real_t> m_nbr_dist;
+            internal::field_builder<real_t> m_nbr_dist;
 
             //! @brief Sizes of messages received from neighbours.
-            field<size_t> m_nbr_msg_size;
+            internal::field_builder<size_t> m_nbr_msg_size;
 
             //! @brief Backend regulating and performing the connection.
             connector_type m_network;
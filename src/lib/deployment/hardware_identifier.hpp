@@ -27,6 +27,14 @@ namespace component {
 
 //! @brief Namespace of tags to be used for initialising components.
 namespace tags {
+    //! @brief Declaration flag associating to whether references to exports in pointers are counted at the end of epochs.
+    template <bool b>
+    struct export_epoch;
+
+    //! @brief Declaration flag associating to whether exports are wrapped in smart pointers.
+    template <bool b>
+    struct export_pointer;
+
     //! @brief Declaration flag associating to whether parallelism is enabled.
     template <bool b>
     struct parallel;
@@ -49,12 +57,17 @@ namespace tags {
  *
  * <b>Declaration flags:</b>
  * - \ref tags::parallel defines whether parallelism is enabled (defaults to \ref FCPP_PARALLEL).
+ *
+ * Exports in pointers cannot be counted at the end of epochs (see \ref tags::export_epoch), since no epoch would
+ * ever end and changes to references would be logged with no bound.
  */
 template <class... Ts>
 struct hardware_identifier {
     //! @brief Whether parallelism is enabled.
     constexpr static bool parallel = common::option_flag<tags::parallel, FCPP_PARALLEL, Ts...>;
 
+    static_assert(not (common::option_flag<tags::export_pointer, FCPP_EXPORT_PTR, Ts...> and common::option_flag<tags::export_epoch, FCPP_EXPORT_EPOCH, Ts...>), "export epochs are not ended by a hardware identifier");
+
     /**
      * @brief The actual component.
      *
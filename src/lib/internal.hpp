@@ -9,6 +9,7 @@
 #define FCPP_INTERNAL_H_
 
 #include "lib/internal/context.hpp"
+#include "lib/internal/field_builder.hpp"
 #include "lib/internal/flat_ptr.hpp"
 #include "lib/internal/trace.hpp"
 #include "lib/internal/twin.hpp"
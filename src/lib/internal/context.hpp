@@ -10,12 +10,15 @@
 
 #include <algorithm>
 #include <ostream>
-#include <queue>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "lib/settings.hpp"
 #include "lib/common/multitype_map.hpp"
+#include "lib/common/option.hpp"
 #include "lib/data/field.hpp"
 #include "lib/internal/flat_ptr.hpp"
 #include "lib/internal/trace.hpp"
@@ -31,6 +34,233 @@ namespace fcpp {
 namespace internal {
 
 
+//! @cond INTERNAL
+namespace details {
+    //! @brief Checks whether a metric class has a `shift` method for nodes of type N (declaring growth linear in time).
+    template <typename C, typename N>
+    struct has_shift_method {
+      private:
+        template <typename T>
+        static constexpr auto check(T*) -> decltype(std::declval<T const&>().shift(std::declval<N const&>()), std::true_type{});
+
+        template <typename>
+        static constexpr std::false_type check(...);
+
+        typedef decltype(check<C>(0)) type;
+
+      public:
+        static constexpr bool value = type::value;
+    };
+}
+//! @endcond
+
+
+//! @brief Map type holding the content of exports, either with dense slots, flat storage or hash maps.
+template <bool flat, bool schema, typename T, typename... Ts>
+using export_map_t = std::conditional_t<schema, common::schema_multitype_map<T, Ts...>, std::conditional_t<flat, common::flat_multitype_map<T, Ts...>, common::multitype_map<T, Ts...>>>;
+
+
+/**
+ * @brief Inverted index from traces to the neighbours carrying them, built on frozen contexts.
+ *
+ * Every trace found in the exports is assigned a slot, and the devices (and values) associated
+ * with each slot are stored contiguously through a counting sort, preserving the order in which
+ * exports are inserted. Gathering the neighbours of a trace is then a single lookup followed by
+ * a linear copy, instead of a probe into every neighbour's export.
+ *
+ * @param Ts Types included in the exports.
+ */
+template <typename... Ts>
+class trace_index {
+    //! @brief Checks whether a type is supported by the index.
+    template <typename A>
+    constexpr static bool type_supported = common::type_count<std::remove_reference_t<A>, Ts...> != 0;
+
+    //! @brief Entries of the index for a given type, grouped by slot.
+    template <typename A>
+    struct table {
+        //! @brief Slots, devices and values in insertion order.
+        std::vector<std::tuple<size_t, device_t, A const*>> pending;
+        //! @brief Devices and values grouped by slot.
+        std::vector<std::pair<device_t, A const*>> entries;
+        //! @brief Starting position in `entries` of every slot.
+        std::vector<size_t> start;
+    };
+
+    //! @brief The type of the table for values of a given type.
+    template <typename A>
+    using table_type = table<std::remove_reference_t<A>>;
+
+  public:
+    //! @brief List of admissible types (without repetitions).
+    using value_types = common::type_uniq<Ts...>;
+
+    //! @brief List of table types (without repetitions).
+    using table_types = common::type_uniq<table<Ts>...>;
+
+    //! @brief Removes all entries (keeping most of the memory allocated).
+    void clear() {
+        m_slots.clear();
+        m_traces.clear();
+        m_hint.clear();
+        m_keys.pending.clear();
+        clear_tables(value_types{});
+    }
+
+    //! @brief Adds the keys in the export of a device (to be followed by a call to @ref sort).
+    template <typename E>
+    void insert(device_t d, E const& e) {
+        size_t i = 0;
+        e.for_keys([this, d, &i](trace_t t) {
+            m_keys.pending.emplace_back(slot(t, i), d, nullptr);
+        });
+        insert_tables(d, e, i, value_types{});
+    }
+
+    //! @brief Groups the entries by trace, making the index ready for queries.
+    void sort() {
+        group(m_keys);
+        sort_tables(value_types{});
+    }
+
+    //! @brief Returns list of devices with specified trace, including self.
+    std::vector<device_t> align(trace_t trace, device_t self) const {
+        std::vector<device_t> v;
+        auto it = m_slots.find(trace);
+        if (it == m_slots.end()) {
+            v.push_back(self);
+            return v;
+        }
+        auto x = m_keys.entries.begin() + m_keys.start[it->second];
+        auto end = m_keys.entries.begin() + m_keys.start[it->second+1];
+        v.reserve(end - x + 1);
+        for (; x != end and x->first < self; ++x)
+            v.push_back(x->first);
+        v.push_back(self);
+        if (x != end and x->first == self) ++x;
+        for (; x != end; ++x)
+            v.push_back(x->first);
+        return v;
+    }
+
+    //! @brief Returns neighbours' values for a certain trace (default from `def`, and also self if not present).
+    template <typename A>
+    to_field<A> nbr(trace_t trace, A const& def, device_t self) const {
+        fcpp::details::field_ids ids;
+        fcpp::details::field_vals<to_local<A>> vals;
+        auto it = m_slots.find(trace);
+        auto const& t = get_table<A>(common::bool_pack<type_supported<A>>{});
+        if (it == m_slots.end() or it->second+1 >= t.start.size()) {
+            vals.push_back(fcpp::details::other(def));
+            return fcpp::details::make_field(std::move(ids), std::move(vals));
+        }
+        auto x = t.entries.begin() + t.start[it->second];
+        auto end = t.entries.begin() + t.start[it->second+1];
+        ids.reserve(end - x);
+        vals.reserve(end - x + 1);
+        vals.push_back(fcpp::details::other(def));
+        for (; x != end; ++x) {
+            ids.push_back(x->first);
+            vals.push_back(fcpp::details::self(*x->second, self));
+        }
+        return fcpp::details::make_field(std::move(ids), std::move(vals));
+    }
+
+  private:
+    //! @brief The slot of the `i`-th key of an export with trace `t` (assigning a new one if missing).
+    size_t slot(trace_t t, size_t& i) {
+        // exports of devices running the same program usually list keys in the same order
+        if (i < m_hint.size() and m_traces[m_hint[i]] == t) return m_hint[i++];
+        auto it = m_slots.find(t);
+        size_t s;
+        if (it != m_slots.end()) s = it->second;
+        else {
+            s = m_traces.size();
+            m_slots.emplace(t, s);
+            m_traces.push_back(t);
+        }
+        if (i < m_hint.size()) m_hint[i] = s;
+        else m_hint.push_back(s);
+        ++i;
+        return s;
+    }
+
+    //! @brief Groups the pending entries of a table by slot through a counting sort.
+    template <typename A>
+    void group(table<A>& t) {
+        t.start.assign(m_traces.size()+1, 0);
+        for (auto const& x : t.pending)
+            ++t.start[std::get<0>(x)+1];
+        for (size_t i = 1; i < t.start.size(); ++i)
+            t.start[i] += t.start[i-1];
+        t.entries.resize(t.pending.size());
+        // the last slot start is used as insertion cursor for the previous slot
+        for (auto const& x : t.pending)
+            t.entries[t.start[std::get<0>(x)]++] = {std::get<1>(x), std::get<2>(x)};
+        for (size_t i = t.start.size()-1; i > 0; --i)
+            t.start[i] = t.start[i-1];
+        t.start[0] = 0;
+    }
+
+    //! @brief Access to the table corresponding to a type.
+    template <typename A>
+    table_type<A> const& get_table(common::bool_pack<true>) const {
+        return common::get<std::remove_reference_t<A>>(m_tables);
+    }
+
+    //! @brief Access to a table corresponding to a missing type.
+    template <typename A>
+    table_type<A> get_table(common::bool_pack<false>) const {
+        return {};
+    }
+
+    //! @brief Clears the tables (no types).
+    void clear_tables(common::type_sequence<>) {}
+
+    //! @brief Clears the tables (some types).
+    template <typename S, typename... Ss>
+    void clear_tables(common::type_sequence<S, Ss...>) {
+        common::get<S>(m_tables).pending.clear();
+        clear_tables(common::type_sequence<Ss...>{});
+    }
+
+    //! @brief Adds the values in the export of a device (no types).
+    template <typename E>
+    void insert_tables(device_t, E const&, size_t&, common::type_sequence<>) {}
+
+    //! @brief Adds the values in the export of a device (some types).
+    template <typename E, typename S, typename... Ss>
+    void insert_tables(device_t d, E const& e, size_t& i, common::type_sequence<S, Ss...>) {
+        auto& t = common::get<S>(m_tables);
+        e.template for_values<S>([this, &t, d, &i](trace_t k, S const& x) {
+            t.pending.emplace_back(slot(k, i), d, &x);
+        });
+        insert_tables(d, e, i, common::type_sequence<Ss...>{});
+    }
+
+    //! @brief Groups the tables (no types).
+    void sort_tables(common::type_sequence<>) {}
+
+    //! @brief Groups the tables (some types).
+    template <typename S, typename... Ss>
+    void sort_tables(common::type_sequence<S, Ss...>) {
+        group(common::get<S>(m_tables));
+        sort_tables(common::type_sequence<Ss...>{});
+    }
+
+    //! @brief Map associating traces to slots.
+    std::unordered_map<trace_t, size_t> m_slots;
+    //! @brief Traces associated with each slot.
+    std::vector<trace_t> m_traces;
+    //! @brief Slots of the keys in the last export inserted, in order.
+    std::vector<size_t> m_hint;
+    //! @brief Entries for void values.
+    table<void> m_keys;
+    //! @brief Entries for each value type.
+    common::tagged_tuple<value_types, table_types> m_tables;
+};
+
+
 /**
  * @brief Keeps associations between devices and export received.
  *
@@ -39,10 +269,15 @@ namespace internal {
  *
  * @param online Whether the number of stored exports should be kept cleaned as exports are inserted.
  * @param pointer Whether the exports should be stored in pointers or not.
+ * @param flat Whether the exports should be stored in flat sorted arrays or in hash maps.
+ * @param schema Whether the exports should be stored at dense slots (overriding `flat`).
+ * @param epoch Whether the references to exports stored in pointers should be counted at the end of epochs.
+ * @param indexed Whether neighbours should be indexed by trace when the context is frozen.
+ * @param wheel Whether exports with metrics growing linearly in time should expire through a timing wheel (without online cleaning only).
  * @param M Type of the export metrics.
  * @param Ts Types included in the exports.
  */
-template <bool online, bool pointer, typename M, typename... Ts>
+template <bool online, bool pointer, bool flat, bool schema, bool epoch, bool indexed, bool wheel, typename M, typename... Ts>
 class context;
 
 
@@ -50,12 +285,18 @@ class context;
  * @brief Keeps associations between devices and export received.
  *
  * Specialisation for online cleaning of export as they are inserted.
+ * Exports are kept contiguously, together with an array of devices in increasing order
+ * (which is queried directly once frozen, without rebuilding) and an indexed heap over them
+ * for replacing or erasing the worst export (built only when `hoodsize` is reached).
+ * Updating the export of a known device costs O(log n) heap maintenance, while inserting a new
+ * device or erasing one also shifts the (device, position) pairs after it, in O(n) time
+ * (though no exports are moved).
  */
-template <bool pointer, typename M, typename... Ts>
-class context<true, pointer, M, Ts...> {
+template <bool pointer, bool flat, bool schema, bool epoch, bool indexed, bool wheel, typename M, typename... Ts>
+class context<true, pointer, flat, schema, epoch, indexed, wheel, M, Ts...> {
   public:
     //! @brief The type of the exports contained in the context.
-    typedef internal::flat_ptr<common::multitype_map<trace_t, Ts...>, not pointer> export_type;
+    typedef internal::flat_ptr<export_map_t<flat, schema, trace_t, Ts...>, not pointer, epoch> export_type;
 
     //! @brief The type of the metric on exports.
     typedef M metric_type;
@@ -83,142 +324,230 @@ class context<true, pointer, M, Ts...> {
 
     //! @brief Equality operator.
     bool operator==(context const& o) const {
-        return m_data == o.m_data && m_metrics == o.m_metrics;
+        if (m_order.size() != o.m_order.size()) return false;
+        for (size_t i = 0; i < m_order.size(); ++i)
+            if (m_data[m_order[i].second] != o.m_data[o.m_order[i].second]) return false;
+        return true;
     }
 
     //! @brief Number of exports contained.
     size_t size(device_t self) const {
-        return m_data.size() + 1-m_data.count(self);
+        size_t i = find(self);
+        return m_order.size() + 1-(i < m_order.size() and m_order[i].first == self);
     }
 
     //! @brief Inserts an export for a device with a certain metric, possibly cleaning up.
     void insert(device_t d, export_type e, metric_type m, metric_type threshold, device_t hoodsize) {
         if (m <= threshold) {
-            if (m_metrics.count(d) == 0 or m_metrics[d] != m)
-                m_queue.emplace(m, d);
-            m_metrics[d] = m;
-            m_data[d] = std::move(e);
-            if (m_data.size() > hoodsize) pop();
-            else clean();
+            size_t i = find(d);
+            if (i < m_order.size() and m_order[i].first == d) {
+                size_t k = m_order[i].second;
+                get<1>(m_data[k]) = m;
+                get<2>(m_data[k]) = std::move(e);
+                if (m_heaped) {
+                    sift_up(m_where[k]);
+                    sift_down(m_where[k]);
+                }
+                return;
+            }
+            size_t k = m_data.size();
+            m_data.emplace_back(d, m, std::move(e));
+            m_order.emplace(m_order.begin() + i, d, k);
+            if (m_heaped) {
+                m_where.push_back(m_heap.size());
+                m_heap.push_back(k);
+                sift_up(m_where[k]);
+            }
+            if (m_order.size() > hoodsize) pop();
         }
     }
 
     //! @brief The worst export currently in context.
     device_t top() {
-        clean();
-        return m_queue.top().second;
+        heapify();
+        return get<0>(m_data[m_heap[0]]);
     }
 
-    //! @brief Erases the worst export.
+    //! @brief Erases the worst export (shifting the devices after it in @ref m_order).
     void pop() {
-        clean();
-        m_data.erase(m_queue.top().second);
-        m_metrics.erase(m_queue.top().second);
-        m_queue.pop();
+        heapify();
+        size_t k = m_heap[0];
+        place(0, m_heap.back());
+        m_heap.pop_back();
+        if (m_heap.size() > 0) sift_down(0);
+        m_order.erase(m_order.begin() + find(get<0>(m_data[k])));
+        // the last export fills the hole, so that exports stay contiguous
+        size_t l = m_data.size() - 1;
+        if (k < l) {
+            m_data[k] = std::move(m_data[l]);
+            m_order[find(get<0>(m_data[k]))].second = k;
+            place(m_where[l], k);
+        }
+        m_data.pop_back();
+        m_where.pop_back();
     }
 
     //! @brief Changes the status of the context from "modify" to "query".
     void freeze(device_t, device_t) {
-        for (auto const& x : m_data)
-            m_sorted_data.emplace_back(x.first, &x.second);
-        std::sort(m_sorted_data.begin(), m_sorted_data.end());
+        if (indexed) {
+            for (auto const& x : m_order)
+                m_index.front().insert(x.first, *get<2>(m_data[x.second]));
+            m_index.front().sort();
+        }
     }
 
     //! @brief Changes the status of the context from "query" to "modify", updating metrics.
     template <typename N, typename T>
     void unfreeze(N const& node, T const& metric, metric_type threshold) {
-        m_sorted_data.clear();
-        m_queue = {};
-        for (auto it = m_metrics.begin(); it != m_metrics.end(); ) {
-            it->second = metric.update(it->second, node);
-            if (it->second > threshold) {
-                m_data.erase(it->first);
-                it = m_metrics.erase(it);
-            } else {
-                m_queue.emplace(it->second, it->first);
-                ++it;
-            }
+        if (indexed) m_index.front().clear();
+        // exports are rearranged in device order, for sequential access in the next round
+        m_buffer.clear();
+        for (auto const& x : m_order) {
+            data_type& y = m_data[x.second];
+            get<1>(y) = metric.update(get<1>(y), node);
+            if (not (get<1>(y) > threshold)) m_buffer.push_back(std::move(y));
         }
+        std::swap(m_data, m_buffer);
+        m_order.resize(m_data.size());
+        for (size_t k = 0; k < m_data.size(); ++k)
+            m_order[k] = {get<0>(m_data[k]), k};
+        m_heaped = false;
     }
 
     //! @brief Returns list of all devices.
     std::vector<device_t> align(device_t self) const {
         std::vector<device_t> v;
-        auto it = m_sorted_data.begin();
-        for (; it != m_sorted_data.end() and it->first < self; ++it)
+        auto it = m_order.begin();
+        for (; it != m_order.end() and it->first < self; ++it)
             v.push_back(it->first);
         v.push_back(self);
-        if (it != m_sorted_data.end() and it->first == self) ++it;
-        for (; it != m_sorted_data.end(); ++it)
+        if (it != m_order.end() and it->first == self) ++it;
+        for (; it != m_order.end(); ++it)
             v.push_back(it->first);
         return v;
     }
 
     //! @brief Returns list of devices with specified trace.
     std::vector<device_t> align(trace_t trace, device_t self) const {
+        if (indexed) return m_index.front().align(trace, self);
         std::vector<device_t> v;
-        auto it = m_sorted_data.begin();
-        for (; it != m_sorted_data.end() and it->first < self; ++it)
-            if ((*(it->second))->contains(trace)) {
+        auto it = m_order.begin();
+        for (; it != m_order.end() and it->first < self; ++it)
+            if (get<2>(m_data[it->second])->contains(trace))
                 v.push_back(it->first);
-            }
         v.push_back(self);
-        if (it != m_sorted_data.end() and it->first == self) ++it;
-        for (; it != m_sorted_data.end(); ++it)
-            if ((*(it->second))->contains(trace)) {
+        if (it != m_order.end() and it->first == self) ++it;
+        for (; it != m_order.end(); ++it)
+            if (get<2>(m_data[it->second])->contains(trace))
                 v.push_back(it->first);
-            }
         return v;
     }
 
     //! @brief Returns the old value for a certain trace (unaligned).
     template <typename A>
     A const& old(trace_t trace, A const& def, device_t self) const {
-        if (m_data.count(self) and m_data.at(self)->template count<A>(trace))
-            return m_data.at(self)->template at<A>(trace);
+        size_t i = find(self);
+        if (i < m_order.size() and m_order[i].first == self and get<2>(m_data[m_order[i].second])->template count<A>(trace))
+            return get<2>(m_data[m_order[i].second])->template at<A>(trace);
         return def;
     }
 
     //! @brief Returns neighbours' values for a certain trace (default from `def`, and also self if not present).
     template <typename A>
     to_field<A> nbr(trace_t trace, A const& def, device_t self) const {
-        std::vector<device_t> ids;
-        std::vector<to_local<A>> vals;
-        vals.push_back(details::other(def));
-        for (auto const& x : m_sorted_data)
-            if ((*x.second)->template count<A>(trace)) {
+        if (indexed) return m_index.front().nbr(trace, def, self);
+        fcpp::details::field_ids ids;
+        fcpp::details::field_vals<to_local<A>> vals;
+        vals.push_back(fcpp::details::other(def));
+        for (auto const& x : m_order) {
+            export_type const& e = get<2>(m_data[x.second]);
+            if (e->template count<A>(trace)) {
                 ids.push_back(x.first);
-                vals.push_back(details::self(static_cast<A const&>((*x.second)->template at<A>(trace)), self));
+                vals.push_back(fcpp::details::self(static_cast<A const&>(e->template at<A>(trace)), self));
             }
-        return details::make_field(std::move(ids), std::move(vals));
+        }
+        return fcpp::details::make_field(std::move(ids), std::move(vals));
     }
 
     //! @brief Prints the context in a stream.
     template <typename O>
     void print(O& o) const {
         bool first = true;
-        for (auto const& x : m_metrics) {
+        for (auto const& x : m_order) {
             if (first) first = false;
             else o << ", ";
-            o << x.first << ":" << m_data.at(x.first) << "@" << 0+x.second;
+            o << x.first << ":" << get<2>(m_data[x.second]) << "@" << 0+get<1>(m_data[x.second]);
         }
     }
 
   private:
-    //! @brief Erases invalid values from the queue.
-    void clean() {
-        while (m_metrics.count(m_queue.top().second) == 0 or m_metrics.at(m_queue.top().second) != m_queue.top().first)
-            m_queue.pop();
-    }
-
-    //! @brief Map associating devices to exports.
-    std::unordered_map<device_t, export_type> m_data;
-    //! @brief Map associating devices to metric results.
-    std::unordered_map<device_t, metric_type> m_metrics;
-    //! @brief Exports ordered by metric results.
-    std::priority_queue<std::pair<metric_type, device_t>> m_queue;
-    //! @brief Exports ordered by device.
-    std::vector<std::pair<device_t, export_type const*>> m_sorted_data;
+    //! @brief The type of elements stored.
+    using data_type = std::tuple<device_t, metric_type, export_type>;
+
+    //! @brief Position of a device in @ref m_order (or where it should be inserted).
+    size_t find(device_t d) const {
+        return std::lower_bound(m_order.begin(), m_order.end(), d, [](std::pair<device_t, size_t> const& x, device_t y) {
+            return x.first < y;
+        }) - m_order.begin();
+    }
+
+    //! @brief Builds the heap, if it is not maintained already.
+    void heapify() {
+        if (m_heaped) return;
+        size_t n = m_data.size();
+        m_where.resize(n);
+        m_heap.resize(n);
+        for (size_t k = 0; k < n; ++k) place(k, k);
+        for (size_t h = n/2; h > 0; --h) sift_down(h-1);
+        m_heaped = true;
+    }
+
+    //! @brief Whether the k-th export is better than the l-th (by metric, then device), thus to be erased later.
+    bool better(size_t k, size_t l) const {
+        if (get<1>(m_data[k]) < get<1>(m_data[l])) return true;
+        if (get<1>(m_data[l]) < get<1>(m_data[k])) return false;
+        return get<0>(m_data[k]) < get<0>(m_data[l]);
+    }
+
+    //! @brief Places the k-th export at position h of the heap.
+    inline void place(size_t h, size_t k) {
+        m_heap[h] = k;
+        m_where[k] = h;
+    }
+
+    //! @brief Moves the export at position h of the heap towards the top, while it is worse than its parent.
+    void sift_up(size_t h) {
+        size_t k = m_heap[h];
+        for (; h > 0 and better(m_heap[(h-1)/2], k); h = (h-1)/2)
+            place(h, m_heap[(h-1)/2]);
+        place(h, k);
+    }
+
+    //! @brief Moves the export at position h of the heap towards the bottom, while it is better than a child.
+    void sift_down(size_t h) {
+        size_t k = m_heap[h];
+        for (size_t c = 2*h+1; c < m_heap.size(); h = c, c = 2*h+1) {
+            if (c+1 < m_heap.size() and better(m_heap[c], m_heap[c+1])) ++c;
+            if (not better(k, m_heap[c])) break;
+            place(h, m_heap[c]);
+        }
+        place(h, k);
+    }
+
+    //! @brief Contiguous exports (ordered by device after unfreezing, new devices appended).
+    std::vector<data_type> m_data;
+    //! @brief Exports being rearranged (kept to reuse memory).
+    std::vector<data_type> m_buffer;
+    //! @brief Devices in increasing order, with the position of their export in @ref m_data.
+    std::vector<std::pair<device_t, size_t>> m_order;
+    //! @brief Position in @ref m_heap of every export in @ref m_data.
+    std::vector<size_t> m_where;
+    //! @brief Max-heap of positions in @ref m_data, with the worst export on top.
+    std::vector<size_t> m_heap;
+    //! @brief Whether @ref m_heap is maintained (it is built only once needed after unfreezing).
+    bool m_heaped = false;
+    //! @brief Index from traces to devices and values.
+    common::option<trace_index<Ts...>, indexed> m_index;
 };
 
 
@@ -227,11 +556,11 @@ class context<true, pointer, M, Ts...> {
  *
  * Specialisation for cleaning of exports only at round start.
  */
-template <bool pointer, typename M, typename... Ts>
-class context<false, pointer, M, Ts...> {
+template <bool pointer, bool flat, bool schema, bool epoch, bool indexed, bool wheel, typename M, typename... Ts>
+class context<false, pointer, flat, schema, epoch, indexed, wheel, M, Ts...> {
   public:
     //! @brief The type of the exports contained in the context.
-    typedef internal::flat_ptr<common::multitype_map<trace_t, Ts...>, not pointer> export_type;
+    typedef internal::flat_ptr<export_map_t<flat, schema, trace_t, Ts...>, not pointer, epoch> export_type;
 
     //! @brief The type of the metric on exports.
     typedef M metric_type;
@@ -270,58 +599,73 @@ class context<false, pointer, M, Ts...> {
     //! @brief Inserts an export for a device with a certain metric, possibly cleaning up.
     void insert(device_t d, export_type e, metric_type m, metric_type threshold, device_t) {
         if (m <= threshold) {
-            if (m_data.size() > 0 and get<0>(m_data.back()) == d)
-                m_data.back() = data_type{d, m, e};
-            else m_data.emplace_back(d, m, e);
+            size_t i = find(d);
+            if (not (i < m_sorted and get<0>(m_data[i]) == d)) {
+                if (m_data.size() > m_sorted and get<0>(m_data.back()) == d)
+                    i = m_data.size() - 1;
+                else {
+                    m_data.push_back(make_data(d, m, std::move(e), common::bool_pack<wheel>{}));
+                    stamp(m_data.back(), threshold, false, common::bool_pack<wheel>{});
+                    return;
+                }
+            }
+            bool queued = get<1>(m_data[i]) != 0;
+            get<1>(m_data[i]) = m;
+            get<2>(m_data[i]) = std::move(e);
+            stamp(m_data[i], threshold, queued, common::bool_pack<wheel>{});
         }
     }
 
     //! @brief Changes the status of the context from "modify" to "query".
     void freeze(device_t hoodsize, device_t self) {
-        std::stable_sort(m_data.begin(), m_data.end(), [](data_type const& x, data_type const& y){
-            return get<0>(x) < get<0>(y);
-        });
-        size_t w = 0;
-        for (size_t r = 0; r+1 < m_data.size(); ++r) {
-            if (get<0>(m_data[r]) < get<0>(m_data[r+1])) {
-                if (r > w) m_data[w] = std::move(m_data[r]);
-                ++w;
+        // exports from known devices are replaced in place, so only new devices need to be sorted
+        if (m_data.size() > m_sorted) {
+            // with high churn, a full sort is cheaper than a merge
+            if (m_data.size() - m_sorted > m_sorted) m_sorted = 0;
+            std::stable_sort(m_data.begin() + m_sorted, m_data.end(), [](data_type const& x, data_type const& y){
+                return get<0>(x) < get<0>(y);
+            });
+            size_t w = m_sorted;
+            for (size_t r = m_sorted; r < m_data.size(); ++r) {
+                if (r+1 == m_data.size() or get<0>(m_data[r]) < get<0>(m_data[r+1])) {
+                    if (r > w) m_data[w] = std::move(m_data[r]);
+                    ++w;
+                }
             }
+            m_data.resize(w);
+            if (m_sorted > 0) merge();
         }
-        if (m_data.size() > w+1) m_data[w] = std::move(m_data.back());
-        m_data.resize(w+1);
         if (m_data.size() > hoodsize) {
             std::vector<size_t> v(m_data.size());
             for (size_t i=0; i<m_data.size(); ++i) v[i] = i;
             std::nth_element(v.begin(), v.begin()+hoodsize, v.end(), [this](size_t i, size_t j){
-                if (get<1>(m_data[i]) < get<1>(m_data[j])) return true;
-                if (get<1>(m_data[i]) > get<1>(m_data[j])) return false;
+                if (metric_of(m_data[i]) < metric_of(m_data[j])) return true;
+                if (metric_of(m_data[i]) > metric_of(m_data[j])) return false;
                 return get<0>(m_data[i]) < get<0>(m_data[j]);
             });
-            size_t i = v[hoodsize];
-            m_data.resize(std::remove_if(m_data.begin(), m_data.end(), [this, i](data_type const& x){
-                if (get<1>(x) > get<1>(m_data[i])) return true;
-                if (get<1>(x) < get<1>(m_data[i])) return false;
-                return get<0>(x) >= get<0>(m_data[i]);
+            device_t d = get<0>(m_data[v[hoodsize]]);
+            metric_type m = metric_of(m_data[v[hoodsize]]);
+            m_data.resize(std::remove_if(m_data.begin(), m_data.end(), [this, d, m](data_type const& x){
+                if (metric_of(x) > m) return true;
+                if (metric_of(x) < m) return false;
+                return get<0>(x) >= d;
             }) - m_data.begin());
         }
-        m_self = std::lower_bound(m_data.begin(), m_data.end(), data_type{self, metric_type{}, export_type{}}, [](data_type const& x, data_type const& y) {
-            return get<0>(x) < get<0>(y);
-        }) - m_data.begin();
+        m_sorted = m_data.size();
+        m_self = find(self);
+        if (indexed) {
+            for (auto const& x : m_data)
+                m_index.front().insert(get<0>(x), *get<2>(x));
+            m_index.front().sort();
+        }
     }
 
     //! @brief Changes the status of the context from "query" to "modify", updating metrics.
     template <typename N, typename T>
     void unfreeze(N const& node, T const& metric, metric_type threshold) {
-        size_t w = 0;
-        for (size_t r = 0; r < m_data.size(); ++r) {
-            get<1>(m_data[r]) = metric.update(get<1>(m_data[r]), node);
-            if (get<1>(m_data[r]) < threshold) {
-                if (r > w) m_data[w] = std::move(m_data[r]);
-                ++w;
-            }
-        }
-        m_data.resize(w);
+        if (indexed) m_index.front().clear();
+        unfreeze(node, metric, threshold, common::bool_pack<wheel and details::has_shift_method<T, N>::value>{});
+        m_sorted = m_data.size();
     }
 
     //! @brief Returns list of all devices.
@@ -339,6 +683,7 @@ class context<false, pointer, M, Ts...> {
 
     //! @brief Returns list of devices with specified trace.
     std::vector<device_t> align(trace_t trace, device_t self) const {
+        if (indexed) return m_index.front().align(trace, self);
         std::vector<device_t> v;
         size_t i = 0;
         for (; i < m_self; ++i)
@@ -363,15 +708,16 @@ class context<false, pointer, M, Ts...> {
     //! @brief Returns neighbours' values for a certain trace (default from `def`, and also self if not present).
     template <typename A>
     to_field<A> nbr(trace_t trace, A const& def, device_t self) const {
-        std::vector<device_t> ids;
-        std::vector<to_local<A>> vals;
-        vals.push_back(details::other(def));
+        if (indexed) return m_index.front().nbr(trace, def, self);
+        fcpp::details::field_ids ids;
+        fcpp::details::field_vals<to_local<A>> vals;
+        vals.push_back(fcpp::details::other(def));
         for (auto const& x : m_data)
             if (get<2>(x)->template count<A>(trace)) {
                 ids.push_back(get<0>(x));
-                vals.push_back(details::self(static_cast<A const&>(get<2>(x)->template at<A>(trace)), self));
+                vals.push_back(fcpp::details::self(static_cast<A const&>(get<2>(x)->template at<A>(trace)), self));
             }
-        return details::make_field(std::move(ids), std::move(vals));
+        return fcpp::details::make_field(std::move(ids), std::move(vals));
     }
 
     //! @brief Prints the context in a stream.
@@ -381,39 +727,222 @@ class context<false, pointer, M, Ts...> {
         for (auto const& x : m_data) {
             if (first) first = false;
             else o << ", ";
-            o << get<0>(x) << ":" << get<2>(x) << "@" << 0+get<1>(x);
+            o << get<0>(x) << ":" << get<2>(x) << "@" << 0+metric_of(x);
         }
     }
 
   private:
-    //! @brief The type of elements stored.
-    using data_type = std::tuple<device_t, metric_type, export_type>;
+    //! @brief The type of elements stored (device, metric, export, and with an expiry wheel: age of the context when the metric was measured, queued expiry).
+    using data_type = std::conditional_t<wheel, std::tuple<device_t, metric_type, export_type, metric_type, metric_type>, std::tuple<device_t, metric_type, export_type>>;
+
+    //! @brief Builds an element to be stored (without expiry wheel).
+    std::tuple<device_t, metric_type, export_type> make_data(device_t d, metric_type m, export_type&& e, common::bool_pack<false>) const {
+        return std::make_tuple(d, m, std::move(e));
+    }
+
+    //! @brief Builds an element to be stored (with expiry wheel).
+    std::tuple<device_t, metric_type, export_type, metric_type, metric_type> make_data(device_t d, metric_type m, export_type&& e, common::bool_pack<true>) const {
+        return std::make_tuple(d, m, std::move(e), m_age, metric_type{});
+    }
+
+    //! @brief Records the age of the context at which a metric is measured (without expiry wheel).
+    inline void stamp(data_type&, metric_type, bool, common::bool_pack<false>) {}
+
+    //! @brief Records the age of the context at which a metric is measured (with expiry wheel), queueing the export if needed.
+    void stamp(data_type& x, metric_type threshold, bool queued, common::bool_pack<true>) {
+        get<3>(x) = m_age;
+        // the export needs to be queued again only if it expires earlier than the queued one
+        if (m_linear and get<1>(x) != 0 and (not queued or expiry(x, threshold) < get<4>(x)))
+            enqueue(x, threshold);
+    }
+
+    //! @brief Updates metrics one by one, dropping exports over the threshold.
+    template <typename N, typename T>
+    void unfreeze(N const& node, T const& metric, metric_type threshold, common::bool_pack<false>) {
+        size_t w = 0;
+        for (size_t r = 0; r < m_data.size(); ++r) {
+            get<1>(m_data[r]) = metric.update(get<1>(m_data[r]), node);
+            if (get<1>(m_data[r]) < threshold) {
+                if (r > w) m_data[w] = std::move(m_data[r]);
+                ++w;
+            }
+        }
+        m_data.resize(w);
+    }
+
+    //! @brief Ages metrics growing linearly all at once, dropping only the exports reaching the threshold.
+    template <typename N, typename T>
+    void unfreeze(N const& node, T const& metric, metric_type threshold, common::bool_pack<true>) {
+        metric_type shift = metric.shift(node);
+        if (not m_linear) {
+            // the first growth sets the granularity of the wheel
+            if (not (shift > 0)) return unfreeze(node, metric, threshold, common::bool_pack<false>{});
+            m_linear = true;
+            m_tick = shift;
+            m_turn = tick(m_age);
+            m_wheel.resize(wheel_size);
+            for (auto& x : m_data)
+                if (get<1>(x) != 0) enqueue(x, threshold);
+        }
+        m_age += shift;
+        size_t now = tick(m_age);
+        // exports refreshed since they were queued are queued again, instead of being updated at every refresh
+        std::vector<size_t>& expired = m_expired;
+        expired.clear();
+        for (size_t t = m_turn; t <= now and t < m_turn + wheel_size; ++t) {
+            auto& bucket = m_wheel[t % wheel_size];
+            size_t w = 0;
+            for (size_t r = 0; r < bucket.size(); ++r) {
+                metric_type q = bucket[r].first;
+                device_t d = bucket[r].second;
+                if (m_age < q) {
+                    // expiring in a later turn of the wheel
+                    bucket[w++] = bucket[r];
+                    continue;
+                }
+                size_t i = find(d);
+                // entries of devices no longer in context, or whose export was queued again, are stale
+                if (i == m_data.size() or get<0>(m_data[i]) != d or get<1>(m_data[i]) == 0 or get<4>(m_data[i]) != q) continue;
+                if (m_age < expiry(m_data[i], threshold)) enqueue(m_data[i], threshold);
+                else expired.push_back(i);
+            }
+            bucket.resize(w);
+        }
+        m_turn = now;
+        if (expired.empty()) return;
+        std::sort(expired.begin(), expired.end());
+        size_t w = expired[0];
+        for (size_t r = w, i = 0; r < m_data.size(); ++r) {
+            if (i < expired.size() and expired[i] == r) {
+                while (i < expired.size() and expired[i] == r) ++i;
+                continue;
+            }
+            m_data[w++] = std::move(m_data[r]);
+        }
+        m_data.resize(w);
+    }
+
+    //! @brief The age of the context at which an export expires.
+    inline metric_type expiry(data_type const& x, metric_type threshold) const {
+        return threshold - get<1>(x) + get<3>(x);
+    }
+
+    //! @brief The turn of the wheel corresponding to an age of the context.
+    inline size_t tick(metric_type age) const {
+        return size_t(age / m_tick);
+    }
+
+    //! @brief Queues an export in the wheel, by the age of the context at which it expires.
+    inline void enqueue(data_type& x, metric_type threshold) {
+        get<4>(x) = expiry(x, threshold);
+        m_wheel[tick(get<4>(x)) % wheel_size].emplace_back(get<4>(x), get<0>(x));
+    }
+
+    //! @brief The current metric of an export.
+    inline metric_type metric_of(data_type const& x) const {
+        return metric_of(x, common::bool_pack<wheel>{});
+    }
+
+    //! @brief The current metric of an export (without expiry wheel).
+    inline metric_type metric_of(data_type const& x, common::bool_pack<false>) const {
+        return get<1>(x);
+    }
+
+    //! @brief The current metric of an export (with expiry wheel).
+    inline metric_type metric_of(data_type const& x, common::bool_pack<true>) const {
+        return get<1>(x) == 0 ? get<1>(x) : metric_type(get<1>(x) + (m_age - get<3>(x)));
+    }
+
+    //! @brief Position of a device among the sorted exports (or where it should be inserted).
+    size_t find(device_t d) const {
+        return std::lower_bound(m_data.begin(), m_data.begin() + m_sorted, d, [](data_type const& x, device_t y) {
+            return get<0>(x) < y;
+        }) - m_data.begin();
+    }
+
+    //! @brief Merges the sorted exports of new devices after position `m_sorted` into the ones before it.
+    void merge() {
+        for (size_t r = m_sorted; r < m_data.size(); ++r)
+            m_delta.push_back(std::move(m_data[r]));
+        size_t i = m_sorted, j = m_delta.size(), w = m_data.size();
+        // the devices are distinct, so that merging backwards moves only the exports after the first new device
+        while (j > 0) {
+            if (i > 0 and get<0>(m_data[i-1]) > get<0>(m_delta[j-1]))
+                m_data[--w] = std::move(m_data[--i]);
+            else m_data[--w] = std::move(m_delta[--j]);
+        }
+        m_delta.clear();
+    }
 
     //! @brief Sequence of exports stored.
     std::vector<data_type> m_data;
 
+    //! @brief Exports of new devices being merged (kept to reuse memory).
+    std::vector<data_type> m_delta;
+
+    //! @brief Number of exports in @ref m_data sorted by device (the others are from new devices).
+    size_t m_sorted = 0;
+
     //! @brief Index of self in @ref m_data.
     size_t m_self;
+
+    //! @brief Total growth of metrics linear in time, since the context was created.
+    metric_type m_age{};
+
+    //! @brief Whether metrics grow linearly in time, so that exports are aged through @ref m_age.
+    bool m_linear = false;
+
+    //! @brief Number of buckets in @ref m_wheel.
+    constexpr static size_t wheel_size = 64;
+
+    //! @brief Growth of metrics corresponding to a bucket of @ref m_wheel.
+    metric_type m_tick{};
+
+    //! @brief Last turn of @ref m_wheel processed.
+    size_t m_turn = 0;
+
+    //! @brief Positions of the exports expiring (kept to reuse memory).
+    std::vector<size_t> m_expired;
+
+    //! @brief Devices with the age at which their export expires, bucketed by turn (stale entries do not match the queued expiry of the export).
+    std::vector<std::vector<std::pair<metric_type, device_t>>> m_wheel;
+
+    //! @brief Index from traces to devices and values.
+    common::option<trace_index<Ts...>, indexed> m_index;
 };
 
 
 //! @cond INTERNAL
 namespace details {
     // General form.
-    template <bool online, bool pointer, typename M, typename T>
+    template <bool online, bool pointer, bool flat, bool schema, bool epoch, bool indexed, bool wheel, typename M, typename T>
     struct context_t;
 
     // Unpacking form.
-    template <bool online, bool pointer, typename M, typename... Ts>
-    struct context_t<online, pointer, M, common::type_sequence<Ts...>> {
-        using type = context<online, pointer, M, Ts...>;
+    template <bool online, bool pointer, bool flat, bool schema, bool epoch, bool indexed, bool wheel, typename M, typename... Ts>
+    struct context_t<online, pointer, flat, schema, epoch, indexed, wheel, M, common::type_sequence<Ts...>> {
+        using type = context<online, pointer, flat, schema, epoch, indexed, wheel, M, Ts...>;
+    };
+
+    // General form.
+    template <typename T>
+    struct export_schema_t;
+
+    // Unpacking form.
+    template <typename... Ts>
+    struct export_schema_t<common::type_sequence<Ts...>> {
+        using type = common::slot_schema<trace_t, Ts...>;
     };
 }
 //! @endcond
 
 //! @brief Context built with a type sequence of types.
-template <bool online, bool pointer, typename M, typename T>
-using context_t = typename details::context_t<online,pointer,M,T>::type;
+template <bool online, bool pointer, bool flat, bool schema, bool epoch, bool indexed, bool wheel, typename M, typename T>
+using context_t = typename details::context_t<online,pointer,flat,schema,epoch,indexed,wheel,M,T>::type;
+
+//! @brief Schema assigning dense slots to the traces of exports, built with a type sequence of types.
+template <typename T>
+using export_schema_t = typename details::export_schema_t<T>::type;
 
 
 }
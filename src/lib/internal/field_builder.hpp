@@ -0,0 +1,137 @@
+// Copyright © 2021 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file field_builder.hpp
+ * @brief Implementation of the `field_builder` class for collecting values from neighbours into a field.
+ */
+
+#ifndef FCPP_INTERNAL_FIELD_BUILDER_H_
+#define FCPP_INTERNAL_FIELD_BUILDER_H_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "lib/settings.hpp"
+#include "lib/data/field.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Namespace containing objects of internal use.
+namespace internal {
+
+
+/**
+ * @brief Field whose values for single devices are collected and merged in batches.
+ *
+ * Setting a value only appends it to a buffer, which is merged into the field through a single
+ * sorted pass when the field is next accessed (or explicitly through `merge()`, e.g. at round start).
+ * This makes setting the values of every neighbour in a round linear, instead of quadratic.
+ * If the same device is set multiple times, the last value is kept.
+ *
+ * @param A The type of the values.
+ */
+template <typename A>
+class field_builder {
+  public:
+    //! @brief The type of the content.
+    using value_type = A;
+
+    //! @name constructors
+    //! @{
+    //! @brief Default constructor.
+    field_builder() = default;
+
+    //! @brief Constructor from the default value.
+    field_builder(A const& def) : m_field(def) {}
+    //! @}
+
+    //! @brief Sets the value of a device (after pending values).
+    inline void set(device_t d, A const& v) {
+        m_pending.emplace_back(d, v);
+    }
+
+    //! @brief Sets the value of a device (after pending values, moving).
+    inline void set(device_t d, A&& v) {
+        m_pending.emplace_back(d, std::move(v));
+    }
+
+    //! @brief Accesses the field (merging pending values).
+    field<A>& get() {
+        merge();
+        return m_field;
+    }
+
+    //! @brief Accesses the field (merging pending values).
+    field<A> const& get() const {
+        merge();
+        return m_field;
+    }
+
+    //! @brief Restricts the field to a sorted domain of devices (merging pending values).
+    void align(std::vector<device_t> const& dom) {
+        merge();
+        fcpp::details::align(m_field, dom);
+    }
+
+    //! @brief Merges the pending values into the field.
+    void merge() const {
+        if (m_pending.empty()) return;
+        if (m_pending.size() == 1) {
+            fcpp::details::self(m_field, m_pending[0].first) = std::move(m_pending[0].second);
+            m_pending.clear();
+            return;
+        }
+        std::stable_sort(m_pending.begin(), m_pending.end(), [](pending_type const& x, pending_type const& y) {
+            return x.first < y.first;
+        });
+        fcpp::details::field_ids const& ids = fcpp::details::get_ids(m_field);
+        fcpp::details::field_vals<A>& vals = fcpp::details::get_vals(m_field);
+        fcpp::details::field_ids new_ids;
+        fcpp::details::field_vals<A> new_vals;
+        new_ids.reserve(ids.size() + m_pending.size());
+        new_vals.reserve(ids.size() + m_pending.size() + 1);
+        new_vals.push_back(std::move(vals[0]));
+        size_t i = 0;
+        for (size_t j = 0; j < m_pending.size(); ++j) {
+            device_t d = m_pending[j].first;
+            if (j+1 < m_pending.size() and m_pending[j+1].first == d) continue;
+            for (; i < ids.size() and ids[i] < d; ++i) {
+                new_ids.push_back(ids[i]);
+                new_vals.push_back(std::move(vals[i+1]));
+            }
+            if (i < ids.size() and ids[i] == d) ++i;
+            new_ids.push_back(d);
+            new_vals.push_back(std::move(m_pending[j].second));
+        }
+        for (; i < ids.size(); ++i) {
+            new_ids.push_back(ids[i]);
+            new_vals.push_back(std::move(vals[i+1]));
+        }
+        m_field = fcpp::details::make_field(std::move(new_ids), std::move(new_vals));
+        m_pending.clear();
+    }
+
+  private:
+    //! @brief The type of pending values.
+    using pending_type = std::pair<device_t, A>;
+
+    //! @brief The field of merged values.
+    mutable field<A> m_field;
+
+    //! @brief The values set since the last merge.
+    mutable std::vector<pending_type> m_pending;
+};
+
+
+}
+
+
+}
+
+#endif // FCPP_INTERNAL_FIELD_BUILDER_H_
@@ -2,13 +2,21 @@
 
 /**
  * @file flat_ptr.hpp
- * @brief Implementation of the `flat_ptr` class for handling either a `shared_ptr` or a flat data.
+ * @brief Implementation of the `flat_ptr` class for handling either a pooled shared pointer or a flat data.
  */
 
 #ifndef FCPP_INTERNAL_FLAT_PTR_H_
 #define FCPP_INTERNAL_FLAT_PTR_H_
 
-#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lib/settings.hpp"
+#include "lib/common/mutex.hpp"
 
 
 /**
@@ -22,104 +30,685 @@ namespace internal {
 
 
 //! @cond INTERNAL
-template <typename T, bool is_flat>
+template <typename T, bool is_flat, bool is_epoch = false>
 class flat_ptr;
 //! @endcond
 
 
-//! @brief Class managing a `T` object exactly as a `shared_ptr`.
+//! @cond INTERNAL
+namespace details {
+    //! @brief Checks whether a type has a `clear()` method.
+    template <typename T>
+    struct has_clear_method {
+      private:
+        template <typename U>
+        static constexpr auto check(U*) -> decltype(std::declval<U&>().clear(), std::true_type{});
+
+        template <typename>
+        static constexpr std::false_type check(...);
+
+      public:
+        static constexpr bool value = decltype(check<T>(0))::value;
+    };
+
+    //! @brief Empties an object with a `clear()` method (which may keep its allocated memory).
+    template <typename T>
+    inline std::enable_if_t<has_clear_method<T>::value> reset(T& x) {
+        x.clear();
+    }
+
+    //! @brief Empties an object without a `clear()` method.
+    template <typename T>
+    inline std::enable_if_t<not has_clear_method<T>::value> reset(T& x) {
+        x = T();
+    }
+
+    //! @brief A reference counted `T` object.
+    template <typename T>
+    struct counted {
+        //! @brief Number of references to the object.
+        std::atomic<size_t> refs;
+        //! @brief The object.
+        T data;
+    };
+
+    /**
+     * @brief Per-thread pools of reference counted `T` objects.
+     *
+     * Objects whose last reference is dropped are emptied and kept in the pool of the thread dropping
+     * them (up to @ref FCPP_EXPORT_POOL objects), and are handed out again with whatever memory emptying kept.
+     */
+    template <typename T>
+    class pool {
+      public:
+        //! @brief Gets an empty object with a single reference.
+        static counted<T>* acquire() {
+            counted<T>* c;
+            if (destroyed() or local().empty()) c = new counted<T>();
+            else {
+                c = local().back();
+                local().pop_back();
+            }
+            c->refs.store(1, std::memory_order_relaxed);
+            return c;
+        }
+
+        //! @brief Gives back an object with no more references.
+        static void release(counted<T>* c) {
+            if (destroyed() or local().size() >= FCPP_EXPORT_POOL) {
+                delete c;
+                return;
+            }
+            reset(c->data);
+            local().push_back(c);
+        }
+
+      private:
+        //! @brief The list of free objects of a thread (deleting them when the thread ends).
+        struct free_list : public std::vector<counted<T>*> {
+            ~free_list() {
+                destroyed() = true;
+                for (counted<T>* c : *this) delete c;
+            }
+        };
+
+        //! @brief The list of free objects of the current thread.
+        static free_list& local() {
+            thread_local free_list l;
+            return l;
+        }
+
+        //! @brief Whether the list of the current thread has been destroyed (at thread exit).
+        static bool& destroyed() {
+            thread_local bool d = false;
+            return d;
+        }
+    };
+
+    //! @brief An object whose references are counted at the end of epochs.
+    struct epoch_base {
+        //! @brief Number of references to the object (up to the end of the last epoch).
+        ptrdiff_t refs;
+        //! @brief Recycles the object when it has no more references.
+        void (*recycle)(epoch_base*);
+    };
+
+    //! @brief A `T` object whose references are counted at the end of epochs.
+    template <typename T>
+    struct epoch_counted : public epoch_base {
+        //! @brief The object.
+        T data;
+    };
+
+    /**
+     * @brief Reference counting deferred to the end of epochs.
+     *
+     * Within a scope of an epoch domain, threads log the changes to references in a list of the
+     * domain reserved to them, with no synchronisation. Outside of scopes, threads log the changes
+     * in a list of their own, guarded by a mutex which is only contended while the changes are
+     * collected. Consecutive changes to the same object (as when a device broadcasts its export) are
+     * merged. At the end of an epoch outside of domains, the lists of every thread are locked together
+     * and the changes applied, so that they reflect a single instant even if other threads are running:
+     * the objects with no more references at that instant are then recycled.
+     */
+    class epoch {
+      public:
+        //! @brief A list of changes in the references to objects.
+        using change_list = std::vector<std::pair<epoch_base*, ptrdiff_t>>;
+
+        //! @brief Logs a change in the references to an object.
+        static inline void log(epoch_base* c, ptrdiff_t d) {
+            change_list* s = scoped();
+            if (s != nullptr) {
+                merge(*s, c, d);
+                return;
+            }
+            change_log& l = local();
+            common::lock_guard<true> lock(l.mutex);
+            merge(l.changes, c, d);
+        }
+
+        //! @brief Applies the changes logged by every thread outside of scopes, recycling objects with no more references.
+        static void collect() {
+            registry& r = instance();
+            if (not r.used.load(std::memory_order_acquire)) return;
+            common::lock_guard<true> l(r.mutex);
+            for (change_log* v : r.logs) v->mutex.lock();
+            apply(r.logs, [](change_log* v) -> change_list& {
+                return v->changes;
+            }, r.dead);
+            for (change_log* v : r.logs) v->mutex.unlock();
+            recycle(r.dead);
+        }
+
+        /**
+         * @brief Applies lists of changes, clearing them and gathering the objects with no more references.
+         *
+         * @param lists A sequence of objects containing lists of changes.
+         * @param get   A function accessing the list of changes in an object of the sequence.
+         * @param dead  Where the objects with no more references are appended.
+         */
+        template <typename L, typename G>
+        static void apply(L& lists, G&& get, std::vector<epoch_base*>& dead) {
+            for (auto& v : lists)
+                for (auto const& x : get(v)) x.first->refs += x.second;
+            for (auto& v : lists) {
+                for (auto const& x : get(v))
+                    if (x.first->refs == 0) {
+                        x.first->refs = -1;
+                        dead.push_back(x.first);
+                    }
+                get(v).clear();
+            }
+        }
+
+        //! @brief Recycles objects with no more references, clearing their list.
+        static void recycle(std::vector<epoch_base*>& dead) {
+            for (epoch_base* c : dead) c->recycle(c);
+            dead.clear();
+        }
+
+        //! @brief The list where the current thread logs changes without synchronisation (null outside of scopes).
+        static change_list*& scoped() {
+            thread_local change_list* s = nullptr;
+            return s;
+        }
+
+      private:
+        //! @brief Adds a change to a list, merging it with the last one if about the same object.
+        static inline void merge(change_list& l, epoch_base* c, ptrdiff_t d) {
+            if (not l.empty() and l.back().first == c) l.back().second += d;
+            else l.emplace_back(c, d);
+        }
+
+        //! @brief The changes logged by a thread outside of scopes.
+        struct change_log {
+            //! @brief Mutex regulating access to the changes.
+            common::mutex<true> mutex;
+            //! @brief The logged changes.
+            change_list changes;
+        };
+
+        //! @brief The logs of every thread.
+        struct registry {
+            //! @brief Whether any log has been created.
+            std::atomic<bool> used{false};
+            //! @brief Mutex regulating access to the logs.
+            common::mutex<true> mutex;
+            //! @brief The logs of every thread (never deallocated, as threads may end before objects).
+            std::vector<change_log*> logs;
+            //! @brief The objects to be recycled, collected while the logs are locked.
+            std::vector<epoch_base*> dead;
+        };
+
+        //! @brief The unique registry (never deallocated, as static objects may be destroyed after it).
+        static registry& instance() {
+            static registry* r = new registry();
+            return *r;
+        }
+
+        //! @brief The log of the current thread.
+        static change_log& local() {
+            thread_local change_log* l = nullptr;
+            if (l == nullptr) {
+                registry& r = instance();
+                common::lock_guard<true> lock(r.mutex);
+                l = new change_log();
+                r.logs.push_back(l);
+                r.used.store(true, std::memory_order_release);
+            }
+            return *l;
+        }
+    };
+
+    /**
+     * @brief Pools of `T` objects whose references are counted at the end of epochs.
+     *
+     * Objects are recycled into a shared pool at the end of an epoch, and moved in batches to
+     * caches of the threads needing them.
+     */
+    template <typename T>
+    class epoch_pool {
+      public:
+        //! @brief Gets an empty object with a single reference.
+        static epoch_counted<T>* acquire() {
+            epoch_counted<T>* c = nullptr;
+            if (not destroyed()) {
+                std::vector<epoch_counted<T>*>& l = local();
+                if (l.empty()) {
+                    shared_list& g = shared();
+                    common::lock_guard<true> lock(g.mutex);
+                    size_t n = std::min(g.size(), batch);
+                    l.insert(l.end(), g.end() - n, g.end());
+                    g.resize(g.size() - n);
+                }
+                if (not l.empty()) {
+                    c = l.back();
+                    l.pop_back();
+                }
+            }
+            if (c == nullptr) {
+                c = new epoch_counted<T>();
+                c->recycle = recycle;
+            }
+            c->refs = 1;
+            return c;
+        }
+
+      private:
+        //! @brief Number of objects moved at once from the shared pool to a thread.
+        static constexpr size_t batch = 64;
+
+        //! @brief Recycles an object with no more references into the shared pool.
+        static void recycle(epoch_base* b) {
+            epoch_counted<T>* c = static_cast<epoch_counted<T>*>(b);
+            shared_list& g = shared();
+            common::lock_guard<true> lock(g.mutex);
+            if (g.size() >= FCPP_EXPORT_POOL) {
+                delete c;
+                return;
+            }
+            reset(c->data);
+            g.push_back(c);
+        }
+
+        //! @brief The shared list of free objects.
+        struct shared_list : public std::vector<epoch_counted<T>*> {
+            //! @brief Mutex regulating access to the list.
+            common::mutex<true> mutex;
+        };
+
+        //! @brief The list of free objects of a thread (deleting them when the thread ends).
+        struct free_list : public std::vector<epoch_counted<T>*> {
+            ~free_list() {
+                destroyed() = true;
+                for (epoch_counted<T>* c : *this) delete c;
+            }
+        };
+
+        //! @brief The shared list of free objects (never deallocated, as static objects may be destroyed after it).
+        static shared_list& shared() {
+            static shared_list* g = new shared_list();
+            return *g;
+        }
+
+        //! @brief The list of free objects of the current thread.
+        static free_list& local() {
+            thread_local free_list l;
+            return l;
+        }
+
+        //! @brief Whether the list of the current thread has been destroyed (at thread exit).
+        static bool& destroyed() {
+            thread_local bool d = false;
+            return d;
+        }
+    };
+}
+//! @endcond
+
+
+/**
+ * @brief Ends an epoch of objects shared through `flat_ptr<T, false, true>` outside of any @ref epoch_scope.
+ *
+ * Applies the changes to references made outside of scopes since the last epoch end, and recycles the objects
+ * that are no longer referenced. Other threads may keep handling such pointers meanwhile. Changes are logged
+ * until an epoch ends, so that their memory grows with the copies made if epochs never end.
+ */
+inline void end_epoch() {
+    details::epoch::collect();
+}
+
+
+/**
+ * @brief A domain of objects shared through `flat_ptr<T, false, true>`, whose epochs end separately.
+ *
+ * Within an @ref epoch_scope of the domain, changes to references are logged in a list of the domain
+ * reserved to a thread index, with neither locks nor atomic operations. The epoch of the domain should
+ * end only while none of its scopes is open (as for a network between batches of rounds), so that the
+ * changes are complete. Pointers shared within the domain should be copied and dropped only within its scopes.
+ */
+class epoch_domain {
+  public:
+    //! @brief Constructor, given the number of thread indices logging concurrently.
+    explicit epoch_domain(size_t threads) : m_lists(threads) {}
+
+    //! @brief Copies and moves are not allowed, as scopes refer to the lists.
+    epoch_domain(epoch_domain const&) = delete;
+
+    //! @brief Destructor, applying the changes still logged.
+    ~epoch_domain() {
+        end_epoch();
+    }
+
+    //! @brief Applies the changes logged in scopes, and recycles the objects that are no longer referenced.
+    void end_epoch() {
+        details::epoch::apply(m_lists, [](padded_list& v) -> details::epoch::change_list& {
+            return v.changes;
+        }, m_dead);
+        details::epoch::recycle(m_dead);
+    }
+
+  private:
+    //! @cond INTERNAL
+    template <bool>
+    friend class epoch_scope;
+    //! @endcond
+
+    //! @brief A list of changes, padded so that lists of different threads do not share cache lines.
+    struct padded_list {
+        //! @brief Padding before the list.
+        common::cache_padding<true> padding;
+        //! @brief The logged changes.
+        details::epoch::change_list changes;
+    };
+
+    //! @brief The lists of changes, one for each thread index.
+    std::vector<padded_list> m_lists;
+
+    //! @brief The objects to be recycled (kept to reuse memory).
+    std::vector<details::epoch_base*> m_dead;
+};
+
+
+//! @brief Scope in which the current thread logs changes in references to a list of an @ref epoch_domain (disabled).
+template <bool enabled>
+class epoch_scope {
+  public:
+    //! @brief Constructor, ignoring the domain and thread index.
+    epoch_scope(epoch_domain&, size_t = 0) {}
+};
+
+/**
+ * @brief Scope in which the current thread logs changes in references to a list of an @ref epoch_domain.
+ *
+ * Scopes with the same domain and thread index should not be open on different threads at the same time.
+ * Scopes can be nested, restoring the list of the enclosing scope when closed.
+ */
+template <>
+class epoch_scope<true> {
+  public:
+    //! @brief Constructor, given the domain and the thread index.
+    epoch_scope(epoch_domain& d, size_t t = 0) : m_outer(details::epoch::scoped()) {
+        details::epoch::scoped() = &d.m_lists[t].changes;
+    }
+
+    //! @brief Copies are not allowed.
+    epoch_scope(epoch_scope const&) = delete;
+
+    //! @brief Destructor, restoring the enclosing scope.
+    ~epoch_scope() {
+        details::epoch::scoped() = m_outer;
+    }
+
+  private:
+    //! @brief The list of the enclosing scope (null if none).
+    details::epoch::change_list* m_outer;
+};
+
+
+/**
+ * @brief Class managing a `T` object exactly as a `shared_ptr`.
+ *
+ * Objects are reference counted, and recycled through per-thread pools when the last reference is
+ * dropped, so that a new object only allocates what its emptying did not keep (nothing for flat maps).
+ */
 template <typename T>
-class flat_ptr<T, false> {
+class flat_ptr<T, false, false> {
   public:
     //! @brief The type of the content.
     typedef T value_type;
 
   private:
+    //! @brief The type of pools of objects.
+    using pool_type = details::pool<T>;
+
     //! @brief The content of the class.
-    std::shared_ptr<T> m_data;
+    details::counted<T>* m_data;
 
   public:
     //! @name constructors
     //! @{
     //! @brief Default constructor.
-    flat_ptr() {
-        m_data.reset(new T());
+    flat_ptr() : m_data(pool_type::acquire()) {}
+
+    //! @brief Default copying constructor.
+    flat_ptr(T const& d) : m_data(pool_type::acquire()) {
+        m_data->data = d;
+    };
+
+    //! @brief Default moving constructor.
+    flat_ptr(T&& d) : m_data(pool_type::acquire()) {
+        m_data->data = std::move(d);
+    };
+
+    //! @brief Copy constructor.
+    flat_ptr(const flat_ptr<T, false, false>& o) : m_data(o.m_data) {
+        if (m_data) m_data->refs.fetch_add(1, std::memory_order_relaxed);
     }
 
+    //! @brief Move constructor.
+    flat_ptr(flat_ptr<T, false, false>&& o) : m_data(o.m_data) {
+        o.m_data = nullptr;
+    }
+    //! @}
+
+    //! @brief Destructor.
+    ~flat_ptr() {
+        drop();
+    }
+
+    //! @name assignment operators
+    //! @{
+    //! @brief Default copying assignment.
+    flat_ptr<T, false, false>& operator=(T const& d) {
+        own();
+        m_data->data = d;
+        return *this;
+    };
+
+    //! @brief Default moving assignment.
+    flat_ptr<T, false, false>& operator=(T&& d) {
+        own();
+        m_data->data = std::move(d);
+        return *this;
+    };
+
+    //! @brief Copy assignment.
+    flat_ptr<T, false, false>& operator=(const flat_ptr<T, false, false>& o) {
+        if (o.m_data) o.m_data->refs.fetch_add(1, std::memory_order_relaxed);
+        drop();
+        m_data = o.m_data;
+        return *this;
+    }
+
+    //! @brief Move assignment.
+    flat_ptr<T, false, false>& operator=(flat_ptr<T, false, false>&& o) {
+        std::swap(m_data, o.m_data);
+        return *this;
+    }
+    //! @}
+
+    //! @brief Equality operator.
+    bool operator==(const flat_ptr<T, false, false>& o) const {
+        return m_data->data == o.m_data->data;
+    }
+
+    //! @brief Access to the content.
+    T& operator*() {
+        return m_data->data;
+    }
+
+    //! @brief Arrow access to the content.
+    T* operator->() {
+        return &m_data->data;
+    }
+
+    //! @brief Const access to the content.
+    T const& operator*() const {
+        return m_data->data;
+    }
+
+    //! @brief Const arrow access to the content.
+    const T* operator->() const {
+        return &m_data->data;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return s & m_data->data;
+    }
+
+  private:
+    //! @brief Drops the reference to the content, recycling it if it was the last one.
+    void drop() {
+        if (m_data and m_data->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            pool_type::release(m_data);
+        m_data = nullptr;
+    }
+
+    //! @brief Ensures that the content is not shared with other pointers (without preserving it).
+    void own() {
+        if (m_data and m_data->refs.load(std::memory_order_acquire) == 1) return;
+        drop();
+        m_data = pool_type::acquire();
+    }
+};
+
+
+/**
+ * @brief Class managing a `T` object as a shared pointer, with references counted at the end of epochs.
+ *
+ * Copies and destructions of pointers only log the change in references in a list owned by the
+ * current thread, with no atomic operations on the shared object. Logged changes are applied by @ref end_epoch, which
+ * recycles the objects with no more references through a shared pool. Suitable for simulations,
+ * where rounds are executed in batches and epochs can end between batches.
+ */
+template <typename T>
+class flat_ptr<T, false, true> {
+  public:
+    //! @brief The type of the content.
+    typedef T value_type;
+
+  private:
+    //! @brief The type of pools of objects.
+    using pool_type = details::epoch_pool<T>;
+
+    //! @brief The content of the class.
+    details::epoch_counted<T>* m_data;
+
+  public:
+    //! @name constructors
+    //! @{
+    //! @brief Default constructor.
+    flat_ptr() : m_data(pool_type::acquire()) {}
+
     //! @brief Default copying constructor.
-    flat_ptr(T const& d) {
-        m_data.reset(new T(d));
+    flat_ptr(T const& d) : m_data(pool_type::acquire()) {
+        m_data->data = d;
     };
 
     //! @brief Default moving constructor.
-    flat_ptr(T&& d) {
-        m_data.reset(new T(d));
+    flat_ptr(T&& d) : m_data(pool_type::acquire()) {
+        m_data->data = std::move(d);
     };
 
     //! @brief Copy constructor.
-    flat_ptr(const flat_ptr<T, false>&) = default;
+    flat_ptr(const flat_ptr<T, false, true>& o) : m_data(o.m_data) {
+        if (m_data) details::epoch::log(m_data, +1);
+    }
 
     //! @brief Move constructor.
-    flat_ptr(flat_ptr<T, false>&&) = default;
+    flat_ptr(flat_ptr<T, false, true>&& o) : m_data(o.m_data) {
+        o.m_data = nullptr;
+    }
     //! @}
 
+    //! @brief Destructor.
+    ~flat_ptr() {
+        drop();
+    }
+
     //! @name assignment operators
     //! @{
     //! @brief Default copying assignment.
-    flat_ptr<T, false>& operator=(T const& d) {
-        m_data.reset(new T(d));
+    flat_ptr<T, false, true>& operator=(T const& d) {
+        details::epoch_counted<T>* c = pool_type::acquire();
+        c->data = d;
+        drop();
+        m_data = c;
         return *this;
     };
 
     //! @brief Default moving assignment.
-    flat_ptr<T, false>& operator=(T&& d) {
-        m_data.reset(new T(d));
+    flat_ptr<T, false, true>& operator=(T&& d) {
+        details::epoch_counted<T>* c = pool_type::acquire();
+        c->data = std::move(d);
+        drop();
+        m_data = c;
         return *this;
     };
 
     //! @brief Copy assignment.
-    flat_ptr<T, false>& operator=(const flat_ptr<T, false>&) = default;
+    flat_ptr<T, false, true>& operator=(const flat_ptr<T, false, true>& o) {
+        if (m_data == o.m_data) return *this;
+        drop();
+        m_data = o.m_data;
+        if (m_data) details::epoch::log(m_data, +1);
+        return *this;
+    }
 
     //! @brief Move assignment.
-    flat_ptr<T, false>& operator=(flat_ptr<T, false>&&) = default;
+    flat_ptr<T, false, true>& operator=(flat_ptr<T, false, true>&& o) {
+        std::swap(m_data, o.m_data);
+        return *this;
+    }
     //! @}
 
     //! @brief Equality operator.
-    bool operator==(const flat_ptr<T, false>& o) const {
-        return *m_data == *(o.m_data);
+    bool operator==(const flat_ptr<T, false, true>& o) const {
+        return m_data->data == o.m_data->data;
     }
 
     //! @brief Access to the content.
     T& operator*() {
-        return *m_data.get();
+        return m_data->data;
     }
 
     //! @brief Arrow access to the content.
     T* operator->() {
-        return m_data.get();
+        return &m_data->data;
     }
 
     //! @brief Const access to the content.
     T const& operator*() const {
-        return *m_data.get();
+        return m_data->data;
     }
 
     //! @brief Const arrow access to the content.
     const T* operator->() const {
-        return m_data.get();
+        return &m_data->data;
     }
 
     //! @brief Serialises the content from/to a given input/output stream.
     template <typename S>
     S& serialize(S& s) {
-        return s & *m_data.get();
+        return s & m_data->data;
+    }
+
+  private:
+    //! @brief Drops the reference to the content (to be applied at the end of the epoch).
+    void drop() {
+        if (m_data) details::epoch::log(m_data, -1);
+        m_data = nullptr;
     }
 };
 
 
 //! @brief Class managing a `T` object directly.
-template <typename T>
-class flat_ptr<T, true> {
+template <typename T, bool is_epoch>
+class flat_ptr<T, true, is_epoch> {
   public:
     //! @brief The type of the content.
     typedef T value_type;
@@ -138,38 +727,38 @@ class flat_ptr<T, true> {
     flat_ptr(T const& d) : m_data(d) {};
 
     //! @brief Default moving constructor.
-    flat_ptr(T&& d) : m_data(d) {};
+    flat_ptr(T&& d) : m_data(std::move(d)) {};
 
     //! @brief Copy constructor.
-    flat_ptr(const flat_ptr<T, true>&) = default;
+    flat_ptr(const flat_ptr<T, true, is_epoch>&) = default;
 
     //! @brief Move constructor.
-    flat_ptr(flat_ptr<T, true>&&) = default;
+    flat_ptr(flat_ptr<T, true, is_epoch>&&) = default;
     //! @}
 
     //! @name assignment operators
     //! @{
     //! @brief Default copying assignment.
-    flat_ptr<T, true>& operator=(T const& d) {
+    flat_ptr<T, true, is_epoch>& operator=(T const& d) {
         m_data = d;
         return *this;
     };
 
     //! @brief Default moving assignment.
-    flat_ptr<T, true>& operator=(T&& d) {
-        m_data = d;
+    flat_ptr<T, true, is_epoch>& operator=(T&& d) {
+        m_data = std::move(d);
         return *this;
     };
 
     //! @brief Copy assignment.
-    flat_ptr<T, true>& operator=(const flat_ptr<T, true>&) = default;
+    flat_ptr<T, true, is_epoch>& operator=(const flat_ptr<T, true, is_epoch>&) = default;
 
     //! @brief Move assignment.
-    flat_ptr<T, true>& operator=(flat_ptr<T, true>&&) = default;
+    flat_ptr<T, true, is_epoch>& operator=(flat_ptr<T, true, is_epoch>&&) = default;
     //! @}
 
     //! @brief Equality operator.
-    bool operator==(const flat_ptr<T, true>& o) const {
+    bool operator==(const flat_ptr<T, true, is_epoch>& o) const {
         return m_data == o.m_data;
     }
 
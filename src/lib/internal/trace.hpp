@@ -12,9 +12,12 @@
 #define ___ __COUNTER__
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 
-#include <vector>
+#include <array>
+#include <stdexcept>
 
 #include "lib/settings.hpp"
 
@@ -103,12 +106,20 @@ class trace {
     //! @endcond
 
   public:
+    //! @brief Maximum number of nested elements in the trace.
+    static constexpr size_t capacity = FCPP_TRACE_DEPTH;
+
     //! @brief Constructs an empty trace.
-    trace() : m_stack{}, m_stack_hash{0} {};
+    trace() : m_stack{}, m_size{0}, m_stack_hash{0} {};
 
     //! @brief `true` if the trace is empty, `false` otherwise.
     bool empty() const {
-        return m_stack.size() == 0;
+        return m_size == 0;
+    }
+
+    //! @brief The number of nested elements in the trace.
+    size_t size() const {
+        return m_size;
     }
 
     //! @brief Returns the hash together with the template argument into a @ref trace_t.
@@ -121,27 +132,49 @@ class trace {
     //! @brief Clears the trace.
     void clear() {
         m_stack_hash = 0;
-        m_stack.clear();
+        m_size = 0;
     }
 
     //! @brief Add a function call to the stack trace updating the hash.
     inline void push(trace_t x) {
         assert(x <= k_hash_mod and "code points overflow: reduce code or increase FCPP_TRACE");
         assert((x < k_hash_factor or !FCPP_WARNING_TRACE) and "warning: code points may induce colliding hashes (ignore with #define FCPP_WARNING_TRACE false)");
+        if (m_size == capacity) overflow();
         m_stack_hash = (m_stack_hash * k_hash_factor + x) & k_hash_mod;
-        m_stack.push_back(x);
+        m_stack[m_size++] = x;
+    }
+
+    //! @brief Replaces the last function call in the stack trace updating the hash.
+    inline void next(trace_t x) {
+        assert(x <= k_hash_mod and "code points overflow: reduce code or increase FCPP_TRACE");
+        assert(m_size > 0 and "trace stack underflow");
+        trace_t y = m_stack[m_size-1];
+        m_stack_hash = ((m_stack_hash + k_hash_mod+1 - y) * k_hash_inverse * k_hash_factor + x) & k_hash_mod;
+        m_stack[m_size-1] = x;
     }
 
     //! @brief Remove the last function call from the stack trace updating the hash.
     inline void pop() {
-        trace_t x = m_stack.back();
-        m_stack.pop_back();
+        assert(m_size > 0 and "trace stack underflow");
+        trace_t x = m_stack[--m_size];
         m_stack_hash = ((m_stack_hash + k_hash_mod+1 - x) * k_hash_inverse) & k_hash_mod;
     }
 
   private:
-    //! @brief Stack trace.
-    std::vector<trace_t> m_stack;
+    //! @brief Reports an overflow of the stack trace (out of line, keeping pushes cheap).
+    [[noreturn]] static void overflow() {
+        #if __cpp_exceptions
+        throw std::length_error("trace stack overflow: reduce call nesting or increase FCPP_TRACE_DEPTH");
+        #else
+        assert(false and "trace stack overflow: reduce call nesting or increase FCPP_TRACE_DEPTH");
+        std::abort();
+        #endif
+    }
+
+    //! @brief Stack trace (stored inline, with no allocations).
+    std::array<trace_t, capacity> m_stack;
+    //! @brief Number of elements in the stack trace.
+    size_t m_size;
     //! @brief Summarising hash (@ref k_hash_len bits used, starting from 0).
     trace_t m_stack_hash;
 };
@@ -225,26 +258,22 @@ struct trace_cycle {
     }
     //! @brief Increment operator (increases the cycle element in the trace).
     inline trace_cycle& operator++() {
-        m_trace.pop();
-        m_trace.push(++m_i);
+        m_trace.next(++m_i);
         return *this;
     }
     //! @brief Decrement operator (decreases the cycle element in the trace).
     inline trace_cycle& operator--() {
-        m_trace.pop();
-        m_trace.push(--m_i);
+        m_trace.next(--m_i);
         return *this;
     }
     //! @brief Increasing operator (increases the cycle element in the trace).
     inline trace_cycle& operator+=(trace_t x) {
-        m_trace.pop();
-        m_trace.push(m_i+=x);
+        m_trace.next(m_i+=x);
         return *this;
     }
     //! @brief Decreasing operator (decreases the cycle element in the trace).
     inline trace_cycle& operator-=(trace_t x) {
-        m_trace.pop();
-        m_trace.push(m_i-=x);
+        m_trace.next(m_i-=x);
         return *this;
     }
     //! @brief Returns the current cycle element.
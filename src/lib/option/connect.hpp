@@ -8,9 +8,12 @@
 #ifndef FCPP_OPTION_CONNECT_H_
 #define FCPP_OPTION_CONNECT_H_
 
+#include <cstdint>
+
 #include <random>
 
 #include "lib/settings.hpp"
+#include "lib/common/simd.hpp"
 #include "lib/common/tagged_tuple.hpp"
 #include "lib/data/vec.hpp"
 
@@ -46,6 +49,71 @@ namespace tags {
 namespace connect {
 
 
+//! @brief Maximum number of devices in a batch of connection checks.
+constexpr size_t batch_size = 64;
+
+
+/**
+ * @brief Devices to be checked together for connection with a same device, with positions stored by coordinate.
+ *
+ * Connection predicates check a batch against a bitmask of devices (the `i`-th bit standing for the
+ * `i`-th device), returning the bitmask of those which are connected.
+ *
+ * @param P The position type.
+ * @param D The node data type.
+ */
+template <typename P, typename D>
+class batch {
+  public:
+    //! @brief The number of devices in the batch.
+    size_t size() const {
+        return m_size;
+    }
+
+    //! @brief Whether the batch is full.
+    bool full() const {
+        return m_size == batch_size;
+    }
+
+    //! @brief The bitmask of all devices in the batch.
+    uint64_t mask() const {
+        return m_size == batch_size ? ~uint64_t(0) : (uint64_t(1) << m_size) - 1;
+    }
+
+    //! @brief Removes all devices.
+    void clear() {
+        m_size = 0;
+    }
+
+    //! @brief Adds a device (the batch should not be full).
+    void push_back(D const& d, P const& p) {
+        m_data[m_size] = d;
+        for (size_t j = 0; j < P::dimension; ++j) m_coord[j][m_size] = p[j];
+        ++m_size;
+    }
+
+    //! @brief The data of the `i`-th device.
+    D const& data(size_t i) const {
+        return m_data[i];
+    }
+
+    //! @brief The coordinates of devices (`coord()[j*batch_size + i]` for the `j`-th coordinate of the `i`-th device).
+    real_t const* coord() const {
+        return m_coord[0];
+    }
+
+  private:
+    //! @brief The coordinates of devices.
+    real_t m_coord[P::dimension][batch_size];
+
+    //! @brief The data of devices.
+    D m_data[batch_size];
+
+    //! @brief The number of devices.
+    size_t m_size = 0;
+};
+
+
 /**
  * Connection predicate which is true between any pair of devices.
  *
@@ -60,6 +128,9 @@ class clique {
     //! @brief The node data type.
     using data_type = common::tagged_tuple_t<>;
 
+    //! @brief Whether connection checks are deterministic, given positions and data.
+    constexpr static bool deterministic = true;
+
     //! @brief Generator and tagged tuple constructor.
     template <typename G, typename S, typename T>
     clique(G&&, const common::tagged_tuple<S,T>&) {}
@@ -75,11 +146,23 @@ class clique {
         return INF;
     }
 
+    //! @brief The maximum radius of connection of a device (with any other).
+    template <typename T>
+    real_t relative_radius(T const&) const {
+        return INF;
+    }
+
     //! @brief Checks if connection is possible.
     template <typename G>
     bool operator()(G&&, const data_type&, const position_type&, const data_type&, const position_type&) const {
         return true;
     }
+
+    //! @brief Checks which devices in a bitmask of a batch can be connected.
+    template <typename G, typename T>
+    uint64_t operator()(G&&, T const&, position_type const&, batch<position_type, T> const&, uint64_t mask) const {
+        return mask;
+    }
 };
 
 
@@ -122,10 +205,24 @@ class fixed : public clique<n> {
         return m_radius;
     }
 
+    //! @brief The maximum radius of connection of a device (with any other).
+    template <typename T>
+    real_t relative_radius(T const&) const {
+        return m_radius;
+    }
+
     //! @brief Checks if connection is possible.
     template <typename G, typename T>
     bool operator()(G&&, T const& data1, position_type const& pos1, T const& data2, position_type const& pos2) const {
-        return norm(pos1 - pos2) <= relative_radius(data1, data2);
+        real_t r = relative_radius(data1, data2);
+        return abs(pos1 - pos2) <= r * r;
+    }
+
+    //! @brief Checks which devices in a bitmask of a batch can be connected.
+    template <typename G, typename T>
+    uint64_t operator()(G&&, T const&, position_type const& pos1, batch<position_type, T> const& b, uint64_t mask) const {
+        if (mask == 0) return 0;
+        return mask & common::within_radius<n>(pos1.begin(), b.coord(), batch_size, &m_radius, true, b.size());
     }
 
   private:
@@ -167,10 +264,26 @@ class powered : public fixed<num,den,n> {
         return C::relative_radius(data1, data2) * common::get<power_ratio>(data1) * common::get<power_ratio>(data2);
     }
 
+    //! @brief The maximum radius of connection of a device (with any other).
+    template <typename T>
+    real_t relative_radius(T const& data) const {
+        return C::relative_radius(data) * common::get<power_ratio>(data);
+    }
+
     //! @brief Checks if connection is possible.
     template <typename G, typename T>
     bool operator()(G&&, T const& data1, position_type const& pos1, T const& data2, position_type const& pos2) const {
-        return norm(pos1 - pos2) <= relative_radius(data1, data2);
+        real_t r = relative_radius(data1, data2);
+        return abs(pos1 - pos2) <= r * r;
+    }
+
+    //! @brief Checks which devices in a bitmask of a batch can be connected.
+    template <typename G, typename T>
+    uint64_t operator()(G&&, T const& data1, position_type const& pos1, batch<position_type, T> const& b, uint64_t mask) const {
+        if (mask == 0) return 0;
+        real_t r[batch_size];
+        for (size_t i = 0; i < b.size(); ++i) r[i] = relative_radius(data1, b.data(i));
+        return mask & common::within_radius<n>(pos1.begin(), b.coord(), batch_size, r, false, b.size());
     }
 };
 
@@ -202,6 +315,9 @@ class radial : public C {
     //! @brief The node data type.
     using typename C::data_type;
 
+    //! @brief Whether connection checks are deterministic (they are random).
+    constexpr static bool deterministic = false;
+
     //! @brief Generator and tagged tuple constructor.
     template <typename G, typename S, typename T>
     radial(G&& g, common::tagged_tuple<S,T> const& t) : C(std::forward<G>(g), t) {
@@ -219,6 +335,22 @@ class radial : public C {
         return r*r*r > 1/(7 * exp((m_r50 - norm(pos1 - pos2)/r99) * m_k) + 1);
     }
 
+    //! @brief Checks which devices in a bitmask of a batch can be connected (drawing random numbers in the same order as separate checks).
+    template <typename G, typename T>
+    uint64_t operator()(G&& g, T const& data1, position_type const& pos1, batch<position_type, T> const& b, uint64_t mask) const {
+        mask = C::operator()(g, data1, pos1, b, mask);
+        std::uniform_real_distribution<real_t> dist;
+        for (size_t i = 0; i < b.size(); ++i) if ((mask >> i) & 1) {
+            real_t r = dist(g);
+            real_t r99 = C::relative_radius(data1, b.data(i));
+            position_type pos2;
+            for (size_t j = 0; j < position_type::dimension; ++j) pos2[j] = b.coord()[j*batch_size + i];
+            if (not (r*r*r > 1/(7 * exp((m_r50 - norm(pos1 - pos2)/r99) * m_k) + 1)))
+                mask &= ~(uint64_t(1) << i);
+        }
+        return mask;
+    }
+
   private:
     //! @brief The half radius and distribution scaling factor.
     real_t m_r50, m_k;
@@ -253,6 +385,17 @@ class hierarchical : public C {
         int delta = abs(common::get<network_rank>(data1) - common::get<network_rank>(data2));
         return (delta == 1 or (delta == 0 and common::get<network_rank>(data1) <= 0)) and C::operator()(std::forward<G>(g), data1, pos1, data2, pos2);
     }
+
+    //! @brief Checks which devices in a bitmask of a batch can be connected.
+    template <typename G, typename T>
+    uint64_t operator()(G&& g, T const& data1, position_type const& pos1, batch<position_type, T> const& b, uint64_t mask) const {
+        for (size_t i = 0; i < b.size(); ++i) {
+            int delta = abs(common::get<network_rank>(data1) - common::get<network_rank>(b.data(i)));
+            if (not (delta == 1 or (delta == 0 and common::get<network_rank>(data1) <= 0)))
+                mask &= ~(uint64_t(1) << i);
+        }
+        return C::operator()(std::forward<G>(g), data1, pos1, b, mask);
+    }
 };
 
 
@@ -2,7 +2,7 @@
 
 /**
  * @file distribution.hpp
- * @brief Collection of random distributions. Similar to distributions in `<random>`, but with distribution parameters as template arguments, which are also made uniform (mean and deviation) whenever possible.
+ * @brief Collection of random distributions. Similar to distributions in `<random>`, but with distribution parameters as template arguments, which are also made uniform (mean and deviation) whenever possible. Real distributions of integral types (as integral times) generate reals rounded to the nearest value.
  */
 
 #ifndef FCPP_OPTION_DISTRIBUTION_H_
@@ -10,6 +10,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <limits>
 #include <random>
 #include <type_traits>
 #include <utility>
@@ -127,6 +128,32 @@ D<T> make(T mean, T dev) {
 
 //! @cond INTERNAL
 namespace details {
+    //! @brief The real type through which values of a type are generated (integral types are generated as reals).
+    template <typename T>
+    using real_type = std::conditional_t<std::is_floating_point<T>::value, T, real_t>;
+
+    //! @brief Converts a generated real to a floating-point type.
+    template <typename T, typename R>
+    inline std::enable_if_t<std::is_floating_point<T>::value, T> real_cast(R x) {
+        return x;
+    }
+
+    //! @brief Converts a generated real to an integral type, rounding it to the nearest value (and saturating it).
+    template <typename T, typename R>
+    inline std::enable_if_t<not std::is_floating_point<T>::value, T> real_cast(R x) {
+        if (not (x < std::numeric_limits<T>::max())) return std::numeric_limits<T>::max();
+        if (not (x > std::numeric_limits<T>::lowest())) return std::numeric_limits<T>::lowest();
+        return T(std::llround(x));
+    }
+
+    //! @brief The ratio of two integers in a given type (infinite ratios of integral types saturate).
+    template <typename T>
+    inline T ratio(intmax_t num, intmax_t den) {
+        if (den == 0 and std::numeric_limits<T>::is_integer)
+            return num > 0 ? std::numeric_limits<T>::max() : num < 0 ? std::numeric_limits<T>::lowest() : T();
+        return (T)num / (T)den;
+    }
+
     template <typename R, typename G>
     typename R::type call_distr(G&& g) {
         R dist{g};
@@ -200,10 +227,10 @@ struct constant_n {
     using type = R;
 
     template <typename G>
-    constant_n(G&&) : val((type)num / (type)den) {}
+    constant_n(G&&) : val(details::ratio<type>(num, den)) {}
 
     template <typename G, typename S, typename T>
-    constant_n(G&&, common::tagged_tuple<S,T> const& t) : val(common::get_or<val_tag>(t, (type)num / (type)den)) {}
+    constant_n(G&&, common::tagged_tuple<S,T> const& t) : val(common::get_or<val_tag>(t, details::ratio<type>(num, den))) {}
 
     template <typename G>
     type operator()(G&&) {
@@ -227,7 +254,7 @@ struct constant_n<R, num, den, void> {
 
     template <typename G>
     type operator()(G&&) {
-        return (type)num / (type)den;
+        return details::ratio<type>(num, den);
     }
 };
 //! @endcond
@@ -274,18 +301,20 @@ class uniform {
     using type = typename mean::type;
 
     template <typename G>
-    uniform(G&& g) : m_d(make<std::uniform_real_distribution>(details::call_distr<mean>(g), details::call_distr<dev>(g))) {}
+    uniform(G&& g) : m_d(make<std::uniform_real_distribution>((real_type)details::call_distr<mean>(g), (real_type)details::call_distr<dev>(g))) {}
 
     template <typename G, typename S, typename T>
-    uniform(G&& g, common::tagged_tuple<S,T> const& t) : m_d(make<std::uniform_real_distribution>((type)common::get_or<mean_tag>(t,details::call_distr<mean>(g, t)), (type)common::get_or<dev_tag>(t,details::call_distr<dev>(g, t)))) {}
+    uniform(G&& g, common::tagged_tuple<S,T> const& t) : m_d(make<std::uniform_real_distribution>((real_type)common::get_or<mean_tag>(t,details::call_distr<mean>(g, t)), (real_type)common::get_or<dev_tag>(t,details::call_distr<dev>(g, t)))) {}
 
     template <typename G>
     type operator()(G&& g) {
-        return m_d(g);
+        return details::real_cast<type>(m_d(g));
     }
 
   private:
-    std::uniform_real_distribution<type> m_d;
+    using real_type = details::real_type<type>;
+
+    std::uniform_real_distribution<real_type> m_d;
 };
 /**
  * @brief With mean and deviation as numeric template parameters.
@@ -326,18 +355,20 @@ class interval {
     using type = typename min::type;
 
     template <typename G>
-    interval(G&& g) : m_d{details::call_distr<min>(g), details::call_distr<max>(g)} {}
+    interval(G&& g) : m_d{(real_type)details::call_distr<min>(g), (real_type)details::call_distr<max>(g)} {}
 
     template <typename G, typename S, typename T>
-    interval(G&& g, common::tagged_tuple<S,T> const& t) : m_d{common::get_or<min_tag>(t,details::call_distr<min>(g, t)), common::get_or<max_tag>(t,details::call_distr<max>(g, t))} {}
+    interval(G&& g, common::tagged_tuple<S,T> const& t) : m_d{(real_type)common::get_or<min_tag>(t,details::call_distr<min>(g, t)), (real_type)common::get_or<max_tag>(t,details::call_distr<max>(g, t))} {}
 
     template <typename G>
     type operator()(G&& g) {
-        return m_d(g);
+        return details::real_cast<type>(m_d(g));
     }
 
   private:
-    std::uniform_real_distribution<type> m_d;
+    using real_type = details::real_type<type>;
+
+    std::uniform_real_distribution<real_type> m_d;
 };
 /**
  * @brief With mean and deviation as numeric template parameters.
@@ -386,11 +417,11 @@ class normal {
 
     template <typename G>
     type operator()(G&& g) {
-        return m_d(g);
+        return details::real_cast<type>(m_d(g));
     }
 
   private:
-    std::normal_distribution<type> m_d;
+    std::normal_distribution<details::real_type<type>> m_d;
 };
 /**
  * @brief With mean and deviation as numeric template parameters.
@@ -427,18 +458,20 @@ class exponential {
     using type = typename mean::type;
 
     template <typename G>
-    exponential(G&& g) : m_d(1/details::call_distr<mean>(g)) {}
+    exponential(G&& g) : m_d(1/(real_type)details::call_distr<mean>(g)) {}
 
     template <typename G, typename S, typename T>
-    exponential(G&& g, common::tagged_tuple<S,T> const& t) : m_d(1/common::get_or<mean_tag>(t, details::call_distr<mean>(g, t))) {}
+    exponential(G&& g, common::tagged_tuple<S,T> const& t) : m_d(1/(real_type)common::get_or<mean_tag>(t, details::call_distr<mean>(g, t))) {}
 
     template <typename G>
     type operator()(G&& g) {
-        return m_d(g);
+        return details::real_cast<type>(m_d(g));
     }
 
   private:
-    std::exponential_distribution<type> m_d;
+    using real_type = details::real_type<type>;
+
+    std::exponential_distribution<real_type> m_d;
 };
 /**
  * @brief With mean as numeric template parameter.
@@ -476,18 +509,20 @@ class weibull {
     using type = typename mean::type;
 
     template <typename G>
-    weibull(G&& g) : m_d(make<std::weibull_distribution>(details::call_distr<mean>(g), details::call_distr<dev>(g))) {}
+    weibull(G&& g) : m_d(make<std::weibull_distribution>((real_type)details::call_distr<mean>(g), (real_type)details::call_distr<dev>(g))) {}
 
     template <typename G, typename S, typename T>
-    weibull(G&& g, common::tagged_tuple<S,T> const& t) : m_d(make<std::weibull_distribution>((type)common::get_or<mean_tag>(t,details::call_distr<mean>(g, t)), (type)common::get_or<dev_tag>(t,details::call_distr<dev>(g, t)))) {}
+    weibull(G&& g, common::tagged_tuple<S,T> const& t) : m_d(make<std::weibull_distribution>((real_type)common::get_or<mean_tag>(t,details::call_distr<mean>(g, t)), (real_type)common::get_or<dev_tag>(t,details::call_distr<dev>(g, t)))) {}
 
     template <typename G>
     type operator()(G&& g) {
-        return m_d(g);
+        return details::real_cast<type>(m_d(g));
     }
 
   private:
-    std::weibull_distribution<type> m_d;
+    using real_type = details::real_type<type>;
+
+    std::weibull_distribution<real_type> m_d;
 };
 /**
  * @brief With mean and deviation as numeric template parameters.
@@ -53,6 +53,7 @@ struct once {
  * @brief Metric predicate which clears out values after a retain time.
  *
  * Requires nodes to have a `next_time()` and `current_time()` interface (as per the `timer` component).
+ * Measures grow linearly in time (by `shift` at every update), so that contexts can age them all at once.
  *
  * @param period The period of time after which values are discarded.
  * @param scale A scale by which `period` is divided.
@@ -76,7 +77,13 @@ struct retain {
     //! @brief Updates an existing measure.
     template <typename N>
     result_type update(result_type const& r, N const& n) const {
-        return r == 0 ? 0 : r + n.next_time() - n.current_time();
+        return r == 0 ? 0 : r + shift(n);
+    }
+
+    //! @brief Growth of non-zero measures at every update.
+    template <typename N>
+    result_type shift(N const& n) const {
+        return n.next_time() - n.current_time();
     }
 };
 
@@ -86,6 +93,7 @@ struct retain {
  * The metric is tuned to equiparate a temporal distance of `period` with a spatial distance of `radius`.
  * Requires nodes to have a `next_time()`, `current_time()` and `position(t)` interface
  * (as per the `timer` and `physical_position` components).
+ * Measures grow linearly in time (by `shift` at every update), so that contexts can age them all at once.
  *
  * @param position_tag The tag storing position data in messages.
  * @param radius The maximum communication radius.
@@ -112,7 +120,13 @@ struct minkowski {
     //! @brief Updates an existing measure.
     template <typename N>
     result_type update(result_type const& r, N const& n) const {
-        return r == 0 ? 0 : r + (n.next_time() - n.current_time()) * radius / real_t(period);
+        return r == 0 ? 0 : r + shift(n);
+    }
+
+    //! @brief Growth of non-zero measures at every update.
+    template <typename N>
+    result_type shift(N const& n) const {
+        return (n.next_time() - n.current_time()) * radius / real_t(period);
     }
 };
 
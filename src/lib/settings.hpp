@@ -8,6 +8,7 @@
 #ifndef FCPP_SETTINGS_H_
 #define FCPP_SETTINGS_H_
 
+#include <cmath>
 #include <cstdint>
 #include <limits>
 
@@ -57,6 +58,10 @@
     //! @brief Setting defining the size of trace hashes (64 for general systems, 16 for embedded systems).
     #define FCPP_TRACE 64
     #endif
+    #ifndef FCPP_TRACE_DEPTH
+    //! @brief Setting defining the maximum depth of nested calls and cycles in a trace (256 for general systems, 32 for embedded systems).
+    #define FCPP_TRACE_DEPTH 256
+    #endif
     #ifndef FCPP_DEVICE
     //! @brief Setting defining the size of device identifiers (32 for general systems, 16 for embedded systems).
     #define FCPP_DEVICE 32
@@ -74,6 +79,10 @@
     //! @brief Setting defining the size of trace hashes (64 for general systems, 16 for embedded systems).
     #define FCPP_TRACE 16
     #endif
+    #ifndef FCPP_TRACE_DEPTH
+    //! @brief Setting defining the maximum depth of nested calls and cycles in a trace (256 for general systems, 32 for embedded systems).
+    #define FCPP_TRACE_DEPTH 32
+    #endif
     #ifndef FCPP_DEVICE
     //! @brief Setting defining the size of device identifiers (32 for general systems, 16 for embedded systems).
     #define FCPP_DEVICE 16
@@ -184,6 +193,48 @@
 #endif
 
 
+#ifndef FCPP_EXPORT_FLAT
+    //! @brief Setting defining whether exports should be stored in flat sorted arrays (true) or in hash maps (false).
+    #define FCPP_EXPORT_FLAT false
+#endif
+
+
+#ifndef FCPP_EXPORT_SCHEMA
+    //! @brief Setting defining whether exports should be stored at dense slots assigned per network (true, pays off for programs with a fixed call structure) or according to @ref FCPP_EXPORT_FLAT (false).
+    #define FCPP_EXPORT_SCHEMA false
+#endif
+
+
+#ifndef FCPP_EXPORT_SLOTS
+    //! @brief Setting defining the maximum number of traces stored at dense slots for each type and network, when @ref FCPP_EXPORT_SCHEMA is true (further traces are stored in hash maps).
+    #define FCPP_EXPORT_SLOTS 256
+#endif
+
+
+#ifndef FCPP_EXPORT_POOL
+    //! @brief Setting defining the maximum number of unused exports kept by each thread for reuse, when exports are handled as pointers.
+    #define FCPP_EXPORT_POOL 1024
+#endif
+
+
+#ifndef FCPP_EXPORT_EPOCH
+    //! @brief Setting defining whether references to exports handled as pointers should be counted at the end of epochs between batches of rounds (true, avoids atomic operations in parallel simulations) or atomically (false).
+    #define FCPP_EXPORT_EPOCH false
+#endif
+
+
+#ifndef FCPP_EXPIRY_WHEEL
+    //! @brief Setting defining whether contexts should expire exports with metrics growing linearly in time (as `metric::retain`) through a timing wheel (true, pays off with retain times of many rounds and few neighbours sending in each) or by updating every metric at every round (false).
+    #define FCPP_EXPIRY_WHEEL false
+#endif
+
+
+#ifndef FCPP_TRACE_INDEX
+    //! @brief Setting defining whether contexts should index neighbours by trace at round start (true, pays off when traces are queried repeatedly) or probe every export at every query (false).
+    #define FCPP_TRACE_INDEX false
+#endif
+
+
 #ifndef FCPP_WARNING_TRACE
     //! @brief Setting defining whether hash colliding of code points is admissible.
     #define FCPP_WARNING_TRACE true
@@ -191,17 +242,23 @@
 
 
 #ifndef FCPP_TIME_TYPE
-//! @brief Setting defining the type to be used to represent times (default to \ref FCPP_REAL_TYPE).
+//! @brief Setting defining the type to be used to represent times (default to \ref FCPP_REAL_TYPE), possibly integral as a count of ticks (e.g. `int64_t` nanoseconds) for exactly reproducible schedules.
 #define FCPP_TIME_TYPE FCPP_REAL_TYPE
 #endif
 
 
 #ifndef FCPP_TIME_EPSILON
-//! @brief Setting defining which time differences are to be considered negligible.
+//! @brief Setting defining which time differences are to be considered negligible (in ticks, truncated, for integral times).
 #define FCPP_TIME_EPSILON 0.01f
 #endif
 
 
+#ifndef FCPP_CALENDAR
+//! @brief Setting defining whether events should be scheduled through a calendar queue (true, pays off with many nodes on near-periodic schedules) or through a priority queue (false).
+#define FCPP_CALENDAR false
+#endif
+
+
 #ifndef FCPP_REFRESH_RATE
 //! @brief Setting defining the minimum acceptable refresh rate of graphical representations.
 #define FCPP_REFRESH_RATE 0.1f
@@ -220,6 +277,12 @@
 #endif
 
 
+#ifndef FCPP_FIELD_INLINE
+//! @brief Setting defining the number of neighbours whose values are stored inline in a field (without heap allocation).
+#define FCPP_FIELD_INLINE 8
+#endif
+
+
 #ifndef FCPP_FIELD_DRAW_LIMIT
 //! @brief Setting defining the maximum number of elements displayed for a field.
 #define FCPP_FIELD_DRAW_LIMIT 8
@@ -238,6 +301,13 @@ namespace fcpp {
     constexpr times_t TIME_MIN = std::numeric_limits<times_t>::has_infinity ? -std::numeric_limits<times_t>::infinity() : std::numeric_limits<times_t>::lowest();
     //! @brief Maximum time (infinitely in the future).
     constexpr times_t TIME_MAX = std::numeric_limits<times_t>::has_infinity ? std::numeric_limits<times_t>::infinity() : std::numeric_limits<times_t>::max();
+    //! @brief Converts a real time to a time, rounding it up for integral times (and saturating it to \ref TIME_MIN and \ref TIME_MAX).
+    inline times_t time_ceil(real_t t) {
+        if (not std::numeric_limits<times_t>::is_integer) return times_t(t);
+        if (not (t < real_t(TIME_MAX))) return TIME_MAX;
+        if (not (t > real_t(TIME_MIN))) return TIME_MIN;
+        return times_t(std::ceil(t));
+    }
     //! @brief Shorthand to real infinity value.
     constexpr real_t INF = std::numeric_limits<real_t>::infinity();
 #ifdef NAN
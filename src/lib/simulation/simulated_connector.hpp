@@ -9,10 +9,14 @@
 #define FCPP_SIMULATION_SIMULATED_CONNECTOR_H_
 
 #include <cmath>
+#include <cstdint>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
 #include <type_traits>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 #include "lib/common/option.hpp"
@@ -20,6 +24,7 @@
 #include "lib/component/base.hpp"
 #include "lib/data/field.hpp"
 #include "lib/data/vec.hpp"
+#include "lib/internal/field_builder.hpp"
 #include "lib/option/connect.hpp"
 #include "lib/option/distribution.hpp"
 
@@ -48,14 +53,30 @@ namespace tags {
     template <size_t n>
     struct dimension;
 
+    //! @brief Declaration tag associating to the number of levels of the grid of cells.
+    template <size_t n>
+    struct grid_levels {};
+
+    //! @brief Declaration flag associating to whether messages are queued in inboxes of receivers, until their next round.
+    template <bool b>
+    struct inbox {};
+
     //! @brief Declaration flag associating to whether message sizes should be emulated.
     template <bool b>
     struct message_size {};
 
+    //! @brief Declaration flag associating to whether nodes keep lists of candidate neighbours.
+    template <bool b>
+    struct neighbour_list {};
+
     //! @brief Declaration flag associating to whether parallelism is enabled.
     template <bool b>
     struct parallel;
 
+    //! @brief Declaration flag associating to whether the topology of the network is static.
+    template <bool b>
+    struct static_topology;
+
     //! @brief Node initialisation tag associating to communication power.
     struct connection_data {};
 
@@ -64,12 +85,94 @@ namespace tags {
 
     //! @brief Net initialisation tag associating to communication radius.
     struct radius {};
+
+    //! @brief Net initialisation tag associating to the margin beyond the radius of candidate neighbours.
+    struct skin {};
 }
 
 
 //! @cond INTERNAL
 namespace details {
-    //! @brief A cell of space, containing nodes and linking to neighbour cells.
+    /**
+     * @brief A value which is replaced as a whole on updates, so that it can be read while updated.
+     *
+     * Replaced values are kept until `collect()` is called, when no reader may be accessing them.
+     * Updates should not be called concurrently.
+     */
+    template <bool parallel, typename T>
+    class snapshot;
+
+    //! @brief A value updated in place when parallelism is disabled.
+    template <typename T>
+    class snapshot<false, T> {
+      public:
+        //! @brief Const access to the current value.
+        T const& get() const {
+            return m_data;
+        }
+
+        //! @brief Updates the value through a function.
+        template <typename F>
+        void update(F&& f) {
+            f(m_data);
+        }
+
+        //! @brief Frees replaced values.
+        void collect() {}
+
+      private:
+        //! @brief The value.
+        T m_data;
+    };
+
+    //! @brief A value replaced by an updated copy on updates.
+    template <typename T>
+    class snapshot<true, T> {
+      public:
+        //! @brief Default constructors.
+        snapshot() : m_data(new T()) {}
+        snapshot(const snapshot&) = delete;
+        snapshot& operator=(const snapshot&) = delete;
+
+        //! @brief Destructor.
+        ~snapshot() {
+            delete m_data.load(std::memory_order_relaxed);
+        }
+
+        //! @brief Const access to the current value.
+        T const& get() const {
+            return *m_data.load(std::memory_order_acquire);
+        }
+
+        //! @brief Updates a copy of the value through a function, then replaces the value with it.
+        template <typename F>
+        void update(F&& f) {
+            T* old = m_data.load(std::memory_order_relaxed);
+            T* x = new T(*old);
+            f(*x);
+            m_data.store(x, std::memory_order_release);
+            m_retired.emplace_back(old);
+        }
+
+        //! @brief Frees replaced values.
+        void collect() {
+            m_retired.clear();
+        }
+
+      private:
+        //! @brief The current value.
+        std::atomic<T*> m_data;
+
+        //! @brief The replaced values.
+        std::vector<std::unique_ptr<T>> m_retired;
+    };
+
+    /**
+     * @brief A cell of space, containing nodes and linking to neighbour cells.
+     *
+     * Contents and links are kept in dense arrays, which can be read without locking while the cell is modified.
+     * Arrays replaced by modifications are freed by `collect()`, when no reader may be accessing them.
+     */
     template <bool parallel, typename N>
     class cell {
       public:
@@ -82,45 +185,290 @@ namespace details {
 
         //! @brief Inserts a node in the cell.
         void insert(N& n) {
-            common::exclusive_guard<parallel> l(m_mutex);
-            m_contents.insert(&n);
+            common::lock_guard<parallel> l(m_mutex);
+            m_contents.update([&n](std::vector<N*>& v){
+                v.push_back(&n);
+            });
         }
 
         //! @brief Removes a node from the cell.
         void erase(N& n) {
-            common::exclusive_guard<parallel> l(m_mutex);
-            m_contents.erase(&n);
+            common::lock_guard<parallel> l(m_mutex);
+            m_contents.update([&n](std::vector<N*>& v){
+                auto it = std::find(v.begin(), v.end(), &n);
+                if (it == v.end()) return;
+                *it = v.back();
+                v.pop_back();
+            });
         }
 
         //! @brief Links a new cell.
         void link(cell const& o) {
-            common::exclusive_guard<parallel> l(m_mutex);
-            m_linked.push_back(&o);
+            common::lock_guard<parallel> l(m_mutex);
+            m_linked.update([&o](std::vector<const cell*>& v){
+                v.push_back(&o);
+            });
+        }
+
+        //! @brief Unlinks a cell.
+        void unlink(cell const& o) {
+            common::lock_guard<parallel> l(m_mutex);
+            m_linked.update([&o](std::vector<const cell*>& v){
+                v.erase(std::remove(v.begin(), v.end(), &o), v.end());
+            });
         }
 
         //! @brief Gives const access to linked cells.
-        std::conditional_t<parallel, std::vector<const cell*>, std::vector<const cell*> const&>
-        linked() const {
-            common::shared_guard<parallel> l(m_mutex);
-            return m_linked;
+        std::vector<const cell*> const& linked() const {
+            return m_linked.get();
+        }
+
+        //! @brief Gives const access to the nodes in the cell.
+        std::vector<N*> const& content() const {
+            return m_contents.get();
         }
 
-        std::conditional_t<parallel, std::unordered_set<N*>, std::unordered_set<N*> const&>
-        content() const {
-            common::shared_guard<parallel> l(m_mutex);
-            return m_contents;
+        //! @brief Marks the cell as modified, returning whether it was not already marked.
+        bool touch() {
+            return not m_touched.exchange(true, std::memory_order_relaxed);
+        }
+
+        //! @brief Frees replaced arrays and clears the modified mark (should be called while the cell is not accessed).
+        void collect() {
+            m_contents.collect();
+            m_linked.collect();
+            m_touched.store(false, std::memory_order_relaxed);
         }
 
       private:
         //! @brief The content of the cell.
-        std::unordered_set<N*> m_contents;
+        snapshot<parallel, std::vector<N*>> m_contents;
 
         //! @brief The linked cells.
-        std::vector<const cell*> m_linked;
+        snapshot<parallel, std::vector<const cell*>> m_linked;
+
+        //! @brief Whether the cell has been modified since the last collection.
+        std::atomic<bool> m_touched{false};
+
+        //! @brief A mutex regulating modifications of this cell.
+        common::mutex<parallel> m_mutex;
+    };
+
+    /**
+     * @brief Per-thread free lists of `T` objects.
+     *
+     * Objects given back are kept by the thread releasing them (up to a fixed number), and handed out
+     * again in the state they were left in, so that steady streams of messages do not allocate.
+     */
+    template <typename T>
+    class recycler {
+      public:
+        //! @brief Gets an object (default constructed if none is free).
+        static T* acquire() {
+            if (destroyed() or local().empty()) return new T();
+            T* x = local().back();
+            local().pop_back();
+            return x;
+        }
+
+        //! @brief Gives back an object which is no longer used.
+        static void release(T* x) {
+            if (destroyed() or local().size() >= capacity) delete x;
+            else local().push_back(x);
+        }
+
+      private:
+        //! @brief Maximum number of free objects kept by a thread.
+        static constexpr size_t capacity = 4096;
+
+        //! @brief The list of free objects of a thread (deleting them when the thread ends).
+        struct free_list : public std::vector<T*> {
+            ~free_list() {
+                destroyed() = true;
+                for (T* x : *this) delete x;
+            }
+        };
+
+        //! @brief The list of free objects of the current thread.
+        static free_list& local() {
+            thread_local free_list l;
+            return l;
+        }
+
+        //! @brief Whether the list of the current thread has been destroyed (at thread exit).
+        static bool& destroyed() {
+            thread_local bool d = false;
+            return d;
+        }
+    };
+
+    //! @brief A message shared by the receivers of a send, recycled by the last of them.
+    struct parcel_base {
+        //! @brief Drops `k` references, recycling the parcel if they were the last ones.
+        void release(size_t k = 1) {
+            if (pending.fetch_sub(k, std::memory_order_acq_rel) == k) recycle(this);
+        }
+
+        //! @brief Number of references still to be dropped (starting from `shared` while sending).
+        std::atomic<size_t> pending;
+
+        //! @brief Recycles the parcel, knowing the type of its message.
+        void (*recycle)(parcel_base*);
+
+        //! @brief Initial number of references, exceeding any number of receivers.
+        static constexpr size_t shared = std::numeric_limits<size_t>::max() / 2;
+    };
+
+    /**
+     * @brief A message of type `M` shared by the receivers of a send.
+     *
+     * The sender hands out references while counting them, and then drops all the references that
+     * it did not hand out: receivers drop their own with no increments on sending.
+     */
+    template <typename M>
+    struct parcel : public parcel_base {
+        //! @brief Wraps a message, with references to be handed out.
+        static parcel* make(M&& m) {
+            parcel* p = recycler<parcel>::acquire();
+            p->message = std::move(m);
+            p->pending.store(shared, std::memory_order_relaxed);
+            p->recycle = recycle_impl;
+            return p;
+        }
+
+        //! @brief The message.
+        M message;
+
+      private:
+        //! @brief Empties the message and gives the parcel back to the recycler.
+        static void recycle_impl(parcel_base* b) {
+            parcel* p = static_cast<parcel*>(b);
+            p->message = M();
+            recycler<parcel>::release(p);
+        }
+    };
+
+    //! @brief A reference to a parcel, dropped on destruction.
+    class parcel_ref {
+      public:
+        //! @brief Null constructor.
+        parcel_ref() = default;
+
+        //! @brief Takes one of the references to be handed out of a parcel.
+        explicit parcel_ref(parcel_base* p) : m_parcel(p) {}
+
+        //! @brief Move constructor.
+        parcel_ref(parcel_ref&& o) : m_parcel(o.m_parcel) {
+            o.m_parcel = nullptr;
+        }
+
+        //! @brief Move assignment.
+        parcel_ref& operator=(parcel_ref&& o) {
+            std::swap(m_parcel, o.m_parcel);
+            return *this;
+        }
+
+        //! @brief Destructor dropping the reference.
+        ~parcel_ref() {
+            if (m_parcel != nullptr) m_parcel->release();
+        }
+
+        //! @brief Accesses the message (which must have type `M`).
+        template <typename M>
+        M const& get() const {
+            return static_cast<parcel<M> const*>(m_parcel)->message;
+        }
+
+      private:
+        //! @brief The referenced parcel.
+        parcel_base* m_parcel = nullptr;
+    };
+
+    /**
+     * @brief A lock-free queue with multiple producers and a single consumer.
+     *
+     * Producers push elements on an atomic stack, which the consumer takes as a whole and reverts
+     * to obtain the elements in order of insertion. Items of the stack are recycled through the
+     * free lists of the threads draining them.
+     */
+    template <typename T>
+    class inbox {
+      public:
+        //! @brief Default constructors.
+        inbox() = default;
+        inbox(const inbox&) = delete;
+        inbox& operator=(const inbox&) = delete;
+
+        //! @brief Destructor discarding the remaining elements.
+        ~inbox() {
+            drain([](T&){});
+        }
+
+        //! @brief Inserts an element (may be called concurrently).
+        void push(T&& x) {
+            item* i = recycler<item>::acquire();
+            i->value = std::move(x);
+            i->next = m_head.load(std::memory_order_relaxed);
+            while (not m_head.compare_exchange_weak(i->next, i, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        //! @brief Applies a function to every element in order of insertion, removing them (should not be called concurrently).
+        template <typename F>
+        void drain(F&& f) {
+            item* i = m_head.exchange(nullptr, std::memory_order_acquire);
+            item* r = nullptr;
+            while (i != nullptr) {
+                item* n = i->next;
+                i->next = r;
+                r = i;
+                i = n;
+            }
+            while (r != nullptr) {
+                T x = std::move(r->value);
+                item* n = r->next;
+                recycler<item>::release(r);
+                r = n;
+                f(x);
+            }
+        }
+
+      private:
+        //! @brief An element in the stack.
+        struct item {
+            T value;
+            item* next;
+        };
+
+        //! @brief The top of the stack.
+        std::atomic<item*> m_head{nullptr};
+    };
+
+    //! @brief Checks whether a connector class can check connection with batches of devices (with positions of type P and data of type D).
+    template <typename C, typename P, typename D>
+    struct has_batch_check {
+      private:
+        template <typename T>
+        static constexpr auto check(T*) -> decltype(std::declval<T const&>()(std::declval<crand&>(), std::declval<D const&>(), std::declval<P const&>(), std::declval<connect::batch<P,D> const&>(), uint64_t{}));
 
-        //! @brief A mutex regulating access to this cell.
-        mutable common::shared_mutex<parallel> m_mutex;
+        template <typename>
+        static constexpr void check(...);
+
+      public:
+        static constexpr bool value = std::is_same<decltype(check<C>(0)), uint64_t>::value;
     };
+
+    //! @brief Checks whether a connector class declares its connection checks as deterministic.
+    template <typename C, typename = void>
+    struct is_deterministic : std::false_type {};
+
+    //! @brief Checks whether a connector class declares its connection checks as deterministic.
+    template <typename C>
+    struct is_deterministic<C, std::enable_if_t<C::deterministic>> : std::true_type {};
+
+    //! @brief Computes an integral power at compile time.
+    constexpr size_t power(size_t b, size_t e) {
+        return e == 0 ? 1 : b * power(b, e-1);
+    }
 }
 //! @endcond
 
@@ -136,16 +484,28 @@ namespace details {
  * - \ref tags::connector defines the connector class (defaults to \ref connect::clique "connect::clique<dimension>").
  * - \ref tags::delay defines the delay generator for sending messages after rounds (defaults to zero delay through \ref distribution::constant_n "distribution::constant_n<times_t, 0>").
  * - \ref tags::dimension defines the dimensionality of the space (defaults to 2).
+ * - \ref tags::grid_levels defines the number of levels of cells, with sides halving from the maximum radius, each node being placed in the finest level not below its own reach (defaults to 1).
  *
  * <b>Declaration flags:</b>
+ * - \ref tags::inbox defines whether messages are queued in a lock-free inbox of the receiver and delivered at its next round start, instead of locking the receiver on sending (defaults to false).
  * - \ref tags::message_size defines whether message sizes should be emulated (defaults to false).
+ * - \ref tags::neighbour_list defines whether nodes send to a list of candidate neighbours, within the maximum radius plus a skin from them, rebuilt only after moving by half of the skin (defaults to false).
  * - \ref tags::parallel defines whether parallelism is enabled (defaults to \ref FCPP_PARALLEL).
+ * - \ref tags::static_topology defines whether nodes are assumed not to move, sending messages through a compressed adjacency of connected nodes (defaults to false).
  *
  * <b>Node initialisation tags:</b>
  * - \ref tags::connection_data associates to communication power (defaults to `connector_type::data_type{}`).
  * - \ref tags::epsilon associates to the time sensitivity, allowing indeterminacy below it (defaults to \ref FCPP_TIME_EPSILON).
  *
- * Net initialisation tags (such as \ref tags::radius) are forwarded to connector classes.
+ * <b>Net initialisation tags:</b>
+ * - \ref tags::skin associates to the margin of candidate neighbours beyond the maximum radius, if \ref tags::neighbour_list is true (defaults to a quarter of the maximum radius).
+ *
+ * Candidate neighbours are rebuilt between net updates, so that lists may be stale for the events happening together (within the time sensitivity) with their moves.
+ * Similarly, the adjacency of a static topology is rebuilt at the first net update after nodes are created or destroyed, or `topology_changed()`
+ * is called on the net (which should be done after moving nodes or changing their connection data); messages are sent through cells until then.
+ * If the connector class declares `constexpr static bool deterministic = true;` (as every connector in \ref connect except \ref connect::radial),
+ * connection is checked only while rebuilding. Otherwise, the adjacency lists the nodes within the maximum radius, and connection is checked at every send.
+ * Net initialisation tags (such as \ref tags::radius) are also forwarded to connector classes.
  * Connector classes should have the following members (see \ref connect for a list of available ones):
  * ~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
  * using data_type = // type for connection power data on nodes
@@ -154,23 +514,50 @@ namespace details {
  * real_t maximum_radius() const;
  * bool operator()(data_type const& data1, position_type const& position1, data_type const& data2, position_type const& position2) const;
  * ~~~~~~~~~~~~~~~~~~~~~~~~~
+ * If connector classes also check connection with a \ref connect::batch "batch" of devices, returning a bitmask:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * uint64_t operator()(data_type const& data1, position_type const& position1, connect::batch<position_type, data_type> const& batch, uint64_t mask) const;
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~
+ * neighbours are checked in batches when sending without inboxes and parallelism (which requires positions of neighbours to be read while locking them).
+ * With more than one grid level (not supported together with neighbour lists), connector classes should also provide the reach of a device,
+ * not below the radius of its connection with any other device:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * real_t relative_radius(data_type const& data) const;
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~
+ * A sender then looks for neighbours in every level only within its reach or the side of cells (bounding the reach of nodes therein), whichever is smaller,
+ * so that few devices with a long reach do not force every other device to scan large cells.
  */
 template <class... Ts>
 struct simulated_connector {
+    //! @brief Whether messages are queued in inboxes of receivers.
+    constexpr static bool inbox = common::option_flag<tags::inbox, false, Ts...>;
+
     //! @brief Whether message sizes should be emulated.
     constexpr static bool message_size = common::option_flag<tags::message_size, false, Ts...>;
 
+    //! @brief Whether nodes keep lists of candidate neighbours.
+    constexpr static bool neighbour_list = common::option_flag<tags::neighbour_list, false, Ts...>;
+
     //! @brief Whether parallelism is enabled.
     constexpr static bool parallel = common::option_flag<tags::parallel, FCPP_PARALLEL, Ts...>;
 
+    //! @brief Whether the topology of the network is static.
+    constexpr static bool static_topology = common::option_flag<tags::static_topology, false, Ts...>;
+
     //! @brief The dimensionality of the space.
     constexpr static size_t dimension = common::option_num<tags::dimension, 2, Ts...>;
 
     //! @brief Type for representing a position.
     using position_type = vec<dimension>;
 
-    //! @brief Type for representing a cell identifier.
-    using cell_id_type = std::array<int, dimension>;
+    //! @brief The number of levels of the grid of cells.
+    constexpr static size_t grid_levels = common::option_num<tags::grid_levels, 1, Ts...>;
+
+    static_assert(grid_levels > 0, "the grid of cells needs at least one level");
+    static_assert(grid_levels == 1 or not neighbour_list, "neighbour lists are not supported with multiple grid levels");
+
+    //! @brief Type for representing a cell identifier (followed by the grid level, with multiple levels).
+    using cell_id_type = std::array<int, dimension + (grid_levels > 1)>;
 
     //! @brief Connector class.
     using connector_type = common::option_type<tags::connector, connect::clique<dimension>, Ts...>;
@@ -178,6 +565,12 @@ struct simulated_connector {
     //! @brief The type of settings data regulating connection.
     using connection_data_type = typename connector_type::data_type;
 
+    //! @brief Whether connection checks are deterministic, so that they are not repeated through a static adjacency.
+    constexpr static bool deterministic = details::is_deterministic<connector_type>::value;
+
+    //! @brief Whether connection is checked with batches of neighbours.
+    constexpr static bool batch_check = not inbox and not parallel and details::has_batch_check<connector_type, position_type, connection_data_type>::value;
+
     //! @brief Delay generator for sending messages after rounds.
     using delay_type = common::option_type<tags::delay, distribution::constant_n<times_t, 0>, Ts...>;
 
@@ -198,8 +591,12 @@ struct simulated_connector {
         CHECK_COMPONENT(randomizer);
         CHECK_COMPONENT(scheduler);
 
+        class net;
+
         //! @brief The local part of the component.
         class node : public P::node {
+            friend class net;
+
           public: // visible by net objects and the main program
             //! @brief The type of settings data regulating connection.
             using connection_data_type = simulated_connector<Ts...>::connection_data_type;
@@ -250,12 +647,12 @@ struct simulated_connector {
 
             //! @brief Size of last message sent.
             size_t msg_size() const {
-                return fcpp::details::self(m_nbr_msg_size.front(), P::node::uid);
+                return fcpp::details::self(m_nbr_msg_size.front().get(), P::node::uid);
             }
 
             //! @brief Sizes of messages received from neighbours.
             field<size_t> const& nbr_msg_size() const {
-                return m_nbr_msg_size.front();
+                return m_nbr_msg_size.front().get();
             }
 
             /**
@@ -277,7 +674,10 @@ struct simulated_connector {
                         PROFILE_COUNT("connector/cell");
                         m_leave = TIME_MAX;
                         if (pt < TIME_MAX) {
-                            P::node::net.cell_move(P::node::as_final(), t);
+                            if (neighbour_list) {
+                                m_anchor.front() = P::node::position(t);
+                                P::node::net.neighbour_move(P::node::as_final());
+                            } else P::node::net.cell_move(P::node::as_final(), t);
                             set_leave_time(t);
                         }
                     }
@@ -287,28 +687,30 @@ struct simulated_connector {
                         typename F::node::message_t m;
                         P::node::as_final().send(t, m);
                         P::node::as_final().receive(t, P::node::uid, m);
-                        common::unlock_guard<parallel> u(P::node::mutex);
-                        for (auto c : P::node::net.cell_of(P::node::as_final()).linked())
-                            for (typename F::node* n : c->content()) {
-                                common::lock_guard<parallel> l(n->mutex);
-                                if (n != this and P::node::net.connection_success(get_generator(has_randomizer<P>{}, *this), m_data, P::node::position(t), n->m_data, n->position(t))) {
-                                    n->receive(t, P::node::uid, m);
-                                }
-                            }
+                        if (static_topology and not inbox and P::node::net.topology_ready()) send_adjacent(t, m);
+                        else send_impl(common::bool_pack<inbox>{}, common::bool_pack<batch_check>{}, t, m);
                     }
                 } else P::node::update();
             }
 
             //! @brief Performs computations at round start with current time `t`.
             void round_start(times_t t) {
+                receive_inbox(common::bool_pack<inbox>{});
                 m_send = t + m_delay(get_generator(has_randomizer<P>{}, *this));
+                m_nbr_msg_size.front().merge();
                 P::node::round_start(t);
             }
 
+            //! @brief Restricts data about neighbours to a sorted domain of devices (called when the domain is frozen).
+            void align_neighbours(std::vector<device_t> const& dom) {
+                m_nbr_msg_size.front().align(dom);
+                P::node::align_neighbours(dom);
+            }
+
             //! @brief Performs computations at round end with current time `t`.
             void round_end(times_t t) {
                 P::node::round_end(t);
-                P::node::net.cell_move(P::node::as_final(), t);
+                if (not neighbour_list and not static_topology) P::node::net.cell_move(P::node::as_final(), t);
                 if (has_scheduler<P>::value and P::node::next() == TIME_MAX) m_leave = TIME_MAX;
                 else set_leave_time(t);
             }
@@ -321,6 +723,108 @@ struct simulated_connector {
             }
 
           private: // implementation details
+            //! @brief A message queued in an inbox, with the sender's identifier, connection data and position at the sending time.
+            struct envelope {
+                times_t time;
+                device_t uid;
+                connection_data_type data;
+                position_type position;
+                //! @brief Whether the message was sent through the static adjacency of a deterministic connector (so that connection is already checked).
+                bool adjacent;
+                //! @brief The message, shared among receivers (as a `F::node::message_t`, incomplete at this point).
+                details::parcel_ref message;
+            };
+
+            //! @brief Sends a message to the nodes adjacent in the static topology, locking them in turn (checking connection unless deterministic).
+            template <typename M>
+            void send_adjacent(times_t t, M const& m) {
+                common::unlock_guard<parallel> u(P::node::mutex);
+                position_type x = P::node::position(t);
+                typename F::node* const* adj = P::node::net.adjacency().data();
+                for (size_t i = m_adjacency_begin; i < m_adjacency_end; ++i) {
+                    common::lock_guard<parallel> l(adj[i]->mutex);
+                    if (deterministic or P::node::net.connection_success(get_generator(has_randomizer<P>{}, *this), m_data, x, adj[i]->m_data, adj[i]->position(t)))
+                        adj[i]->receive(t, P::node::uid, m);
+                }
+            }
+
+            //! @brief Sends a message to neighbours, locking them in turn.
+            template <typename M>
+            void send_impl(common::bool_pack<false>, common::bool_pack<false>, times_t t, M const& m) {
+                common::unlock_guard<parallel> u(P::node::mutex);
+                position_type x = P::node::position(t);
+                for_candidates(x, [&](typename F::node* n){
+                    common::lock_guard<parallel> l(n->mutex);
+                    if (P::node::net.connection_success(get_generator(has_randomizer<P>{}, *this), m_data, x, n->m_data, n->position(t))) {
+                        n->receive(t, P::node::uid, m);
+                    }
+                });
+            }
+
+            //! @brief Sends a message to neighbours, checking connection with batches of them.
+            template <typename M>
+            void send_impl(common::bool_pack<false>, common::bool_pack<true>, times_t t, M const& m) {
+                connect::batch<position_type, connection_data_type> b;
+                typename F::node* nodes[connect::batch_size];
+                position_type x = P::node::position(t);
+                auto flush = [&](){
+                    uint64_t k = P::node::net.connection_success(get_generator(has_randomizer<P>{}, *this), m_data, x, b, b.mask());
+                    for (size_t i = 0; i < b.size(); ++i)
+                        if ((k >> i) & 1) nodes[i]->receive(t, P::node::uid, m);
+                    b.clear();
+                };
+                for_candidates(x, [&](typename F::node* n){
+                    nodes[b.size()] = n;
+                    b.push_back(n->m_data, n->position(t));
+                    if (b.full()) flush();
+                });
+                if (b.size() > 0) flush();
+            }
+
+            //! @brief Sends a message to the inboxes of neighbours (checking connection on delivery, unless already checked in the static adjacency).
+            template <typename M>
+            void send_impl(common::bool_pack<true>, common::bool_pack<false>, times_t t, M& m) {
+                details::parcel<M>* msg = details::parcel<M>::make(std::move(m));
+                position_type x = P::node::position(t);
+                bool adjacent = static_topology and deterministic and P::node::net.topology_ready();
+                size_t k = 0;
+                for_candidates(x, [&](typename F::node* n){
+                    n->m_inbox.front().push({t, P::node::uid, m_data, x, adjacent, details::parcel_ref(msg)});
+                    ++k;
+                });
+                msg->release(details::parcel_base::shared - k);
+            }
+
+            //! @brief Calls a function on every other node which may be connected (given the current position of the node).
+            template <typename G>
+            inline void for_candidates(position_type const& x, G&& g) {
+                if (static_topology and P::node::net.topology_ready()) {
+                    typename F::node* const* adj = P::node::net.adjacency().data();
+                    for (size_t i = m_adjacency_begin; i < m_adjacency_end; ++i) g(adj[i]);
+                } else if (neighbour_list) {
+                    for (typename F::node* n : m_candidates.front()) g(n);
+                } else if (grid_levels > 1) {
+                    P::node::net.for_reachable(P::node::as_final(), x, [&](typename F::node* n){
+                        if (n != this) g(n);
+                    });
+                } else {
+                    for (auto c : P::node::net.cell_of(P::node::as_final()).linked())
+                        for (typename F::node* n : c->content())
+                            if (n != this) g(n);
+                }
+            }
+
+            //! @brief Delivers messages from the inbox (disabled).
+            inline void receive_inbox(common::bool_pack<false>) {}
+
+            //! @brief Delivers messages from the inbox, checking connection at their sending time (unless already checked).
+            void receive_inbox(common::bool_pack<true>) {
+                m_inbox.front().drain([this](envelope& e){
+                    if (e.adjacent or P::node::net.connection_success(get_generator(has_randomizer<P>{}, *this), e.data, e.position, m_data, P::node::position(e.time)))
+                        P::node::as_final().receive(e.time, e.uid, e.message.template get<typename F::node::message_t>());
+                });
+            }
+
             //! @brief Stores size of received message (disabled).
             template <typename S, typename T>
             void receive_size(common::bool_pack<false>, device_t, const common::tagged_tuple<S,T>&) {}
@@ -329,14 +833,25 @@ struct simulated_connector {
             void receive_size(common::bool_pack<true>, device_t d, common::tagged_tuple<S,T> const& m) {
                 common::osstream os;
                 os << m;
-                fcpp::details::self(m_nbr_msg_size.front(), d) = os.size();
+                m_nbr_msg_size.front().set(d, os.size());
             }
 
-            //! @brief Checks when the node will leave the current cell.
+            //! @brief Checks when the node will leave the current cell (or move by half of the skin).
             void set_leave_time(times_t t) {
                 m_leave = TIME_MAX;
+                if (static_topology) return;
+                if (neighbour_list) {
+                    position_type const& x = m_anchor.front();
+                    real_t h = P::node::net.skin() / (2 * std::sqrt(real_t(dimension)));
+                    for (size_t i=0; i<dimension; ++i) {
+                        m_leave = std::min(m_leave, P::node::reach_time(i, x[i] - h, t));
+                        m_leave = std::min(m_leave, P::node::reach_time(i, x[i] + h, t));
+                    }
+                    m_leave = std::max(m_leave, t);
+                    return;
+                }
                 position_type x = P::node::position(t);
-                real_t R = P::node::net.connection_radius();
+                real_t R = P::node::net.cell_side(P::node::as_final());
                 for (size_t i=0; i<dimension; ++i) {
                     int c = (int)floor(x[i]/R);
                     m_leave = std::min(m_leave, P::node::reach_time(i,  c   *R, t));
@@ -368,7 +883,28 @@ struct simulated_connector {
             connection_data_type m_data;
 
             //! @brief Sizes of messages received from neighbours.
-            common::option<field<size_t>, message_size> m_nbr_msg_size;
+            common::option<internal::field_builder<size_t>, message_size> m_nbr_msg_size;
+
+            //! @brief Messages waiting for delivery.
+            common::option<details::inbox<envelope>, inbox> m_inbox;
+
+            //! @brief The cell containing the node (null if none).
+            details::cell<parallel, typename F::node>* m_cell = nullptr;
+
+            //! @brief The identifier of the cell containing the node.
+            cell_id_type m_cell_id;
+
+            //! @brief The position of the node when its candidate neighbours were last computed.
+            common::option<position_type, neighbour_list> m_anchor;
+
+            //! @brief The candidate neighbours.
+            common::option<std::vector<typename F::node*>, neighbour_list> m_candidates;
+
+            //! @brief Whether the node moved since its candidate neighbours were last computed.
+            bool m_moved = false;
+
+            //! @brief The range of connected nodes in the compressed adjacency.
+            size_t m_adjacency_begin = 0, m_adjacency_end = 0;
         };
 
         //! @brief The global part of the component.
@@ -385,35 +921,60 @@ struct simulated_connector {
 
             //! @brief Constructor from a tagged tuple.
             template <typename S, typename T>
-            net(common::tagged_tuple<S,T> const& t) : P::net(t), m_connector(get_generator(has_randomizer<P>{}, *this),t) {}
+            net(common::tagged_tuple<S,T> const& t) : P::net(t), m_connector(get_generator(has_randomizer<P>{}, *this),t), m_skin(common::get_or<tags::skin>(t, m_connector.maximum_radius()/4)) {}
 
             //! @brief Destructor ensuring that nodes are deleted first.
             ~net() {
                 maybe_clear(has_identifier<P>{}, *this);
             }
 
+            //! @brief Updates the internal status of net component, reclaiming memory of cells modified by nodes meanwhile.
+            void update() {
+                if (static_topology and not topology_ready()) build_topology();
+                P::net::update();
+                for (typename F::node* n : m_moved) {
+                    n->m_moved = false;
+                    build_candidates(common::bool_pack<neighbour_list>{}, *n);
+                }
+                m_moved.clear();
+                collect_cells();
+            }
+
             //! @brief Inserts a new node into its cell.
             void cell_enter(typename F::node& n) {
-                cell_enter_impl<false>(n, n.position());
+                topology_changed();
+                place(n, n.position());
             }
 
             //! @brief Removes a node from all cells.
             void cell_leave(typename F::node& n) {
-                if (m_nodes.size() == 0) return;
-                common::exclusive_guard<parallel> l(m_node_mutex);
-                m_nodes.at(n.uid)->second.erase(n);
-                m_nodes.erase(n.uid);
+                if (n.m_moved) {
+                    n.m_moved = false;
+                    m_moved.erase(std::find(m_moved.begin(), m_moved.end(), &n));
+                }
+                clear_candidates(common::bool_pack<neighbour_list>{}, n);
+                topology_changed();
+                if (n.m_cell == nullptr) return;
+                n.m_cell->erase(n);
+                touch(n.m_cell_id, n.m_cell);
+                n.m_cell = nullptr;
             }
 
             //! @brief Moves a node across cells.
             void cell_move(typename F::node& n, times_t t) {
-                cell_enter_impl<true>(n, n.position(t));
+                cell_enter_impl(n, n.position(t));
+            }
+
+            //! @brief Records that a node moved by half of the skin, so that its candidate neighbours are computed again at the end of the update.
+            void neighbour_move(typename F::node& n) {
+                common::lock_guard<parallel> l(m_touch_mutex);
+                if (not n.m_moved) m_moved.push_back(&n);
+                n.m_moved = true;
             }
 
             //! @brief Returns the cells in proximity of node `n`.
             cell_type const& cell_of(const typename F::node& n) const {
-                common::shared_guard<parallel> l(m_node_mutex);
-                return m_nodes.at(n.uid)->second;
+                return *n.m_cell;
             }
 
             //! @brief The maximum connection radius.
@@ -421,12 +982,76 @@ struct simulated_connector {
                 return m_connector.maximum_radius();
             }
 
+            //! @brief The margin of candidate neighbours beyond the maximum connection radius.
+            inline real_t skin() const {
+                return m_skin;
+            }
+
+            //! @brief The side of the cell containing node `n`.
+            inline real_t cell_side(typename F::node const& n) const {
+                return std::ldexp(connection_radius(), -level(n.m_cell_id));
+            }
+
+            //! @brief Calls a function on the nodes in every level of cells which may be connected to node `n` at position `x`.
+            template <typename G>
+            void for_reachable(typename F::node const& n, position_type const& x, G&& g) const {
+                const cell_type* cells[grid_levels * details::power(3, dimension)];
+                size_t k = 0;
+                real_t r = reach(common::bool_pack<(grid_levels > 1)>{}, n);
+                {
+                    common::shared_guard<parallel> l(m_cell_mutex);
+                    for (size_t lv = 0; lv < grid_levels; ++lv) {
+                        // nodes in this level reach at most the side of cells
+                        real_t h = std::ldexp(connection_radius(), -int(lv));
+                        real_t w = r < h ? r/h : 1;
+                        cell_id_type lo, hi;
+                        for (size_t i=0; i<dimension; ++i) {
+                            lo[i] = (int)floor(x[i]/h - w);
+                            hi[i] = (int)floor(x[i]/h + w);
+                        }
+                        if (grid_levels > 1) lo.back() = hi.back() = (int)lv;
+                        cell_id_type c = lo;
+                        while (true) {
+                            auto it = m_cells.find(c);
+                            if (it != m_cells.end()) cells[k++] = it->second.get();
+                            size_t i;
+                            for (i = 0; i < dimension and c[i] == hi[i]; ++i) c[i] = lo[i];
+                            if (i == dimension) break;
+                            ++c[i];
+                        }
+                    }
+                }
+                for (size_t i = 0; i < k; ++i)
+                    for (typename F::node* m : cells[i]->content()) g(m);
+            }
+
             //! @brief Checks whether connection is possible.
             template <typename G>
             inline bool connection_success(G&& gen, connection_data_type const& data1, position_type const& position1, connection_data_type const& data2, position_type const& position2) const {
                 return m_connector(gen, data1, position1, data2, position2);
             }
 
+            //! @brief Records that nodes moved or changed connection data, so that the static topology is rebuilt at the next update.
+            inline void topology_changed() {
+                m_topology_ready.store(false, std::memory_order_release);
+            }
+
+            //! @brief Whether the adjacency reflects the current static topology.
+            inline bool topology_ready() const {
+                return m_topology_ready.load(std::memory_order_acquire);
+            }
+
+            //! @brief The compressed adjacency, listing the nodes connected to every node in a contiguous range.
+            std::vector<typename F::node*> const& adjacency() const {
+                return m_adjacency;
+            }
+
+            //! @brief Checks which devices in a bitmask of a batch can be connected.
+            template <typename G>
+            inline uint64_t connection_success(G&& gen, connection_data_type const& data1, position_type const& position1, connect::batch<position_type, connection_data_type> const& b, uint64_t mask) const {
+                return m_connector(gen, data1, position1, b, mask);
+            }
+
           private: // implementation details
             //! @brief A custom hash for cell identifiers.
             struct cell_hasher {
@@ -438,60 +1063,167 @@ struct simulated_connector {
             };
 
             //! @brief The map type used internally for storing cells.
-            using cell_map_type = std::unordered_map<cell_id_type, cell_type, cell_hasher>;
+            using cell_map_type = std::unordered_map<cell_id_type, std::unique_ptr<cell_type>, cell_hasher>;
 
-            //! @brief Converts a position into a cell identifier.
-            cell_id_type to_cell(position_type const& v) {
+            //! @brief Converts a position into a cell identifier, in a given grid level.
+            cell_id_type to_cell(position_type const& v, int lv) {
                 cell_id_type c;
-                for (size_t i=0; i<dimension; ++i) c[i] = (int)floor(v[i]/connection_radius());
+                real_t side = neighbour_list ? connection_radius() + m_skin : std::ldexp(connection_radius(), -lv);
+                for (size_t i=0; i<dimension; ++i) c[i] = (int)floor(v[i]/side);
+                if (grid_levels > 1) c.back() = lv;
                 return c;
             }
 
-            //! @brief Interts a node in the cell correspoding to a given position.
-            template <bool move>
-            inline void cell_enter_impl(typename F::node& n, position_type const& p) {
-                cell_id_type c = to_cell(p);
-                typename cell_map_type::iterator nit;
-                bool create;
+            //! @brief The grid level of a cell identifier.
+            inline static int level(cell_id_type const& c) {
+                return grid_levels > 1 ? c.back() : 0;
+            }
+
+            //! @brief The reach of a node (single grid level).
+            inline real_t reach(common::bool_pack<false>, typename F::node const&) const {
+                return connection_radius();
+            }
+
+            //! @brief The reach of a node, as given by the connector.
+            inline real_t reach(common::bool_pack<true>, typename F::node const& n) const {
+                return m_connector.relative_radius(n.m_data);
+            }
+
+            //! @brief The finest grid level whose cells are not smaller than the reach of a node.
+            int level_of(typename F::node const& n) const {
+                real_t r = reach(common::bool_pack<(grid_levels > 1)>{}, n);
+                int lv = 0;
+                for (real_t h = connection_radius()/2; lv+1 < (int)grid_levels and r <= h; h /= 2) ++lv;
+                return lv;
+            }
+
+            //! @brief Clears candidate neighbours (disabled).
+            inline void clear_candidates(common::bool_pack<false>, typename F::node&) {}
+
+            //! @brief Removes a node from the candidate neighbours of others, and clears its own.
+            void clear_candidates(common::bool_pack<true>, typename F::node& n) {
+                for (typename F::node* m : n.m_candidates.front()) {
+                    auto& v = m->m_candidates.front();
+                    *std::find(v.begin(), v.end(), &n) = v.back();
+                    v.pop_back();
+                }
+                n.m_candidates.front().clear();
+            }
+
+            //! @brief Computes candidate neighbours (disabled).
+            inline void build_candidates(common::bool_pack<false>, typename F::node&) {}
+
+            //! @brief Computes the candidate neighbours of a node from its anchor, updating them symmetrically (while no node is running).
+            void build_candidates(common::bool_pack<true>, typename F::node& n) {
+                clear_candidates(common::bool_pack<true>{}, n);
+                position_type const& x = n.m_anchor.front();
+                cell_enter_impl(n, x);
+                real_t r = connection_radius() + m_skin;
+                for (auto c : n.m_cell->linked())
+                    for (typename F::node* m : c->content())
+                        if (m != &n and norm(m->m_anchor.front() - x) <= r) {
+                            n.m_candidates.front().push_back(m);
+                            m->m_candidates.front().push_back(&n);
+                        }
+            }
+
+            //! @brief Places a node at a given position, in cells or in lists of candidate neighbours.
+            void place(typename F::node& n, position_type const& p) {
+                if (neighbour_list) {
+                    n.m_anchor.front() = p;
+                    build_candidates(common::bool_pack<neighbour_list>{}, n);
+                } else cell_enter_impl(n, p);
+            }
+
+            //! @brief Places nodes at their positions as of their last update, and lists the nodes connected to each of them (or within the maximum radius, if connection is not deterministic).
+            void build_topology() {
+                std::vector<typename F::node*> nodes;
+                for (auto const& c : m_cells)
+                    for (typename F::node* n : c.second->content()) nodes.push_back(n);
+                for (typename F::node* n : nodes) place(*n, n->position());
+                m_adjacency.clear();
+                real_t r = connection_radius();
+                for (typename F::node* n : nodes) {
+                    n->m_adjacency_begin = m_adjacency.size();
+                    n->for_candidates(n->position(), [&](typename F::node* m){
+                        if (deterministic ? connection_success(get_generator(has_randomizer<P>{}, *n), n->m_data, n->position(), m->m_data, m->position()) : norm(n->position() - m->position()) <= r)
+                            m_adjacency.push_back(m);
+                    });
+                    n->m_adjacency_end = m_adjacency.size();
+                }
+                m_topology_ready.store(true, std::memory_order_release);
+            }
+
+            //! @brief Inserts a node in the cell correspoding to a given position (leaving the previous one).
+            void cell_enter_impl(typename F::node& n, position_type const& p) {
+                cell_id_type c = to_cell(p, level_of(n));
+                if (n.m_cell != nullptr and n.m_cell_id == c) return;
+                cell_type* nc = get_cell(c);
+                cell_leave(n);
+                nc->insert(n);
+                touch(c, nc);
+                n.m_cell = nc;
+                n.m_cell_id = c;
+            }
+
+            //! @brief Finds the cell with a given identifier, creating and linking it if missing.
+            cell_type* get_cell(cell_id_type const& c) {
                 {
                     common::shared_guard<parallel> l(m_cell_mutex);
-                    nit = m_cells.find(c);
-                    create = nit == m_cells.end();
+                    auto it = m_cells.find(c);
+                    if (it != m_cells.end()) return it->second.get();
                 }
-                if (create) {
-                    common::exclusive_guard<parallel> l(m_cell_mutex);
-                    nit = m_cells.emplace(std::piecewise_construct, std::make_tuple(c), std::make_tuple()).first;
-                    nit->second.link(nit->second);
-                    cell_id_type d;
-                    for (size_t i=0; i<dimension; ++i) d[i] = c[i]-1;
-                    while (true) {
-                        if (c != d) {
-                            auto lit = m_cells.find(d);
-                            if (lit != m_cells.end()) {
-                                nit->second.link(lit->second);
-                                lit->second.link(nit->second);
-                            }
-                        }
-                        size_t i;
-                        for (i = 0; i < dimension and d[i] == c[i]+1; ++i) d[i] = c[i]-1;
-                        if (i == dimension) break;
-                        ++d[i];
+                common::exclusive_guard<parallel> l(m_cell_mutex);
+                auto itb = m_cells.emplace(c, nullptr);
+                if (not itb.second) return itb.first->second.get();
+                cell_type* nc = new cell_type();
+                itb.first->second.reset(nc);
+                nc->link(*nc);
+                touch(c, nc);
+                for_neighbours(c, [&](cell_id_type const& d, cell_type* x){
+                    nc->link(*x);
+                    x->link(*nc);
+                    touch(d, x);
+                });
+                return nc;
+            }
+
+            //! @brief Calls a function on the existing cells adjacent to a given one (with their identifiers).
+            template <typename G>
+            void for_neighbours(cell_id_type const& c, G&& g) {
+                cell_id_type d = c;
+                for (size_t i=0; i<dimension; ++i) d[i] = c[i]-1;
+                while (true) {
+                    if (c != d) {
+                        auto it = m_cells.find(d);
+                        if (it != m_cells.end()) g(d, it->second.get());
                     }
+                    size_t i;
+                    for (i = 0; i < dimension and d[i] == c[i]+1; ++i) d[i] = c[i]-1;
+                    if (i == dimension) break;
+                    ++d[i];
                 }
-                typename cell_map_type::iterator *it;
-                if (move) {
-                    {
-                        common::shared_guard<parallel> l(m_node_mutex);
-                        it = &m_nodes.at(n.uid);
-                    }
-                    if (c == (*it)->first) return;
-                    else (*it)->second.erase(n);
-                } else {
-                    common::exclusive_guard<parallel> l(m_node_mutex);
-                    it = &m_nodes[n.uid];
+            }
+
+            //! @brief Records a cell as modified.
+            inline void touch(cell_id_type const& c, cell_type* x) {
+                if (x->touch()) {
+                    common::lock_guard<parallel> l(m_touch_mutex);
+                    m_touched.emplace_back(c, x);
                 }
-                *it = nit;
-                (*it)->second.insert(n);
+            }
+
+            //! @brief Frees arrays replaced in modified cells, and reclaims modified cells which are empty (while no node is running).
+            void collect_cells() {
+                for (auto const& x : m_touched) x.second->collect();
+                for (auto const& x : m_touched) if (x.second->content().empty()) {
+                    for_neighbours(x.first, [&x](cell_id_type const&, cell_type* y){
+                        y->unlink(*x.second);
+                        y->collect();
+                    });
+                    m_cells.erase(x.first);
+                }
+                m_touched.clear();
             }
 
             //! @brief Returns the `randomizer` generator if available.
@@ -519,14 +1251,29 @@ struct simulated_connector {
             //! @brief The map from cell identifiers to cells.
             cell_map_type m_cells;
 
-            //! @brief The map associating devices identifiers to their cell.
-            std::unordered_map<device_t, typename cell_map_type::iterator> m_nodes;
+            //! @brief The cells modified since the last collection.
+            std::vector<std::pair<cell_id_type, cell_type*>> m_touched;
 
             //! @brief The connector predicate.
             connector_type m_connector;
 
-            //! @brief The mutexes regulating access to maps.
-            mutable common::shared_mutex<parallel> m_node_mutex, m_cell_mutex;
+            //! @brief The margin of candidate neighbours beyond the maximum connection radius.
+            const real_t m_skin;
+
+            //! @brief The nodes which moved by half of the skin since the last update.
+            std::vector<typename F::node*> m_moved;
+
+            //! @brief The mutex regulating access to the map of cells.
+            mutable common::shared_mutex<parallel> m_cell_mutex;
+
+            //! @brief The mutex regulating access to modified cells.
+            common::mutex<parallel> m_touch_mutex;
+
+            //! @brief The compressed adjacency of the static topology.
+            std::vector<typename F::node*> m_adjacency;
+
+            //! @brief Whether the adjacency reflects the current static topology.
+            std::atomic<bool> m_topology_ready{false};
         };
     };
 };
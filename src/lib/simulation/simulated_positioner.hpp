@@ -15,6 +15,7 @@
 #include "lib/component/base.hpp"
 #include "lib/data/field.hpp"
 #include "lib/data/vec.hpp"
+#include "lib/internal/field_builder.hpp"
 
 
 /**
@@ -114,8 +115,8 @@ struct simulated_positioner {
             node(typename F::net& n, common::tagged_tuple<S,T> const& t) : P::node(n,t), m_x(common::get_or<tags::x>(t, position_type{})), m_v(common::get_or<tags::v>(t, position_type{})), m_a(common::get_or<tags::a>(t, position_type{})), m_f(common::get_or<tags::f>(t, 0)), m_nbr_vec{details::nan_vec<dimension>()}, m_nbr_dist{INF} {
                 static_assert(common::tagged_tuple<S,T>::tags::template count<tags::x> >= 1, MISSING_TAG_MESSAGE);
                 m_last = TIME_MIN;
-                fcpp::details::self(m_nbr_vec, P::node::uid) = vec<dimension>();
-                fcpp::details::self(m_nbr_dist, P::node::uid) = 0;
+                m_nbr_vec.set(P::node::uid, vec<dimension>());
+                m_nbr_dist.set(P::node::uid, 0);
             }
 
             #undef MISSING_TAG_MESSAGE
@@ -222,7 +223,7 @@ struct simulated_positioner {
                 t -= m_last;
                 if (m_a[i] == m_v[i] * m_f) { // limit velocity reached, linear motion
                     real_t sol = y / m_v[i];
-                    return sol > t ? m_last + sol : TIME_MAX;
+                    return sol > t ? time_ceil(m_last + sol) : TIME_MAX;
                 }
                 if (m_f == 0) { // no friction, uniformily accelerated motion
                     real_t delta = m_v[i] * m_v[i] + 2 * y * m_a[i];
@@ -231,13 +232,13 @@ struct simulated_positioner {
                     delta = m_a[i] > 0 ? delta : -delta;
                     real_t sol1 = (-m_v[i] - delta) / m_a[i]; // lower solution
                     real_t sol2 = (-m_v[i] + delta) / m_a[i]; // higher solution
-                    return sol1 > t ? m_last + sol1 : sol2 > t ? m_last + sol2 : TIME_MAX;
+                    return sol1 > t ? time_ceil(m_last + sol1) : sol2 > t ? time_ceil(m_last + sol2) : TIME_MAX;
                 }
                 if (m_f == INF) return TIME_MAX; // infinite friction, no motion
                 if (m_a[i] == 0) { // no acceleration, exponentially decreasing motion
                     real_t sol = 1 - y * m_f / m_v[i];
                     sol = sol <= 0 ? TIME_MIN : -log(sol) / m_f;
-                    return sol > t ? m_last + sol : TIME_MAX;
+                    return sol > t ? time_ceil(m_last + sol) : TIME_MAX;
                 }
                 real_t inv = m_v[i]*m_a[i] > 0 ? TIME_MIN : log(1 - m_v[i] / m_a[i] * m_f) / m_f; // inversion time
                 if (inv <= t) { // unidirectional motion
@@ -255,6 +256,8 @@ struct simulated_positioner {
 
             //! @brief Performs computations at round start with current time `t`.
             void round_start(times_t t) {
+                m_nbr_vec.merge();
+                m_nbr_dist.merge();
                 P::node::round_start(t);
                 PROFILE_COUNT("positioner");
                 if (m_last > TIME_MIN) {
@@ -272,14 +275,21 @@ struct simulated_positioner {
                 m_last = t;
             }
 
+            //! @brief Restricts data about neighbours to a sorted domain of devices (called when the domain is frozen).
+            void align_neighbours(std::vector<device_t> const& dom) {
+                m_nbr_vec.align(dom);
+                m_nbr_dist.align(dom);
+                P::node::align_neighbours(dom);
+            }
+
             //! @brief Receives an incoming message (possibly reading values from sensors).
             template <typename S, typename T>
             void receive(times_t t, device_t d, common::tagged_tuple<S,T> const& m) {
                 P::node::receive(t, d, m);
                 position_type v = common::get<positioner_tag>(m) - position(t);
                 if (d != P::node::uid) {
-                    fcpp::details::self(m_nbr_vec, d) = v;
-                    fcpp::details::self(m_nbr_dist, d) = norm(v);
+                    m_nbr_dist.set(d, norm(v));
+                    m_nbr_vec.set(d, std::move(v));
                 }
             }
 
@@ -293,12 +303,12 @@ struct simulated_positioner {
 
             //! @brief Perceived positions of neighbours as difference vectors.
             fcpp::field<position_type> const& nbr_vec() const {
-                return m_nbr_vec;
+                return m_nbr_vec.get();
             }
 
             //! @brief Perceived distances from neighbours.
             fcpp::field<real_t> const& nbr_dist() const {
-                return m_nbr_dist;
+                return m_nbr_dist.get();
             }
 
           private: // implementation details
@@ -336,10 +346,10 @@ struct simulated_positioner {
             real_t m_f;
 
             //! @brief Perceived positions of neighbours as difference vectors.
-            fcpp::field<position_type> m_nbr_vec;
+            internal::field_builder<position_type> m_nbr_vec;
 
             //! @brief Perceived distances from neighbours.
-            fcpp::field<real_t> m_nbr_dist;
+            internal::field_builder<real_t> m_nbr_dist;
 
             //! @brief Time of the last round happened.
             times_t m_last;
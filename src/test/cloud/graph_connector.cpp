@@ -27,7 +27,10 @@ struct exposer {
         struct node : public P::node {
             using P::node::node;
         };
-        using net = typename P::net;
+        struct net : public P::net {
+            using P::net::net;
+            using P::net::node_emplace;
+        };
     };
 };
 
@@ -37,7 +40,7 @@ template <int O>
 using combo = component::combine_spec<
     exposer,
     component::scheduler<round_schedule<seq_per>>,
-    component::graph_connector<message_size<(O & 2) == 2>, parallel<(O & 1) == 1>, delay<distribution::constant_n<times_t, 1, 4>>>,
+    component::graph_connector<message_size<(O & 2) == 2>, parallel<(O & 1) == 1>, static_topology<(O & 4) == 4>, delay<distribution::constant_n<times_t, 1, 4>>>,
     component::identifier<
         parallel<(O & 1) == 1>,
         synchronised<(O & 2) == 2>
@@ -110,3 +113,48 @@ MULTI_TEST(GraphConnectorTest, Messages, O, 2) {
     EXPECT_EQ(3.25, d3.next());
     EXPECT_EQ(3.25, d4.next());
 }
+
+MULTI_TEST(GraphConnectorTest, StaticTopology, O, 2) {
+    auto connect = [](auto& network, device_t i, device_t j) {
+        typename std::decay_t<decltype(network)>::lock_type l1, l2;
+        network.node_at(i, l1).connect(&network.node_at(j, l2));
+    };
+    auto disconnect = [](auto& network, device_t i, device_t j) {
+        typename std::decay_t<decltype(network)>::lock_type l;
+        network.node_at(i, l).disconnect(j);
+    };
+    auto senders = [](auto& network, device_t i) {
+        auto const& ids = fcpp::details::get_ids(network.node_at(i).nbr_msg_size());
+        return std::vector<device_t>(ids.begin(), ids.end());
+    };
+    // the same graph, sending through lists of neighbours or through the compressed adjacency
+    typename combo<O | 2>::net net1{common::make_tagged_tuple<oth>("foo")};
+    typename combo<O | 6>::net net2{common::make_tagged_tuple<oth>("foo")};
+    for (device_t i = 0; i < 5; ++i) {
+        net1.node_emplace(common::make_tagged_tuple<uid>(i));
+        net2.node_emplace(common::make_tagged_tuple<uid>(i));
+    }
+    for (device_t i = 0; i < 4; ++i) {
+        connect(net1, i, i+1);
+        connect(net2, i, i+1);
+    }
+    connect(net1, 4, 0);
+    connect(net2, 4, 0);
+    EXPECT_FALSE(net2.topology_ready());
+    net1.run(3.5);
+    net2.run(3.5);
+    EXPECT_TRUE(net2.topology_ready());
+    EXPECT_EQ(5u, net2.adjacency().size() / 2);
+    EXPECT_EQ(std::vector<device_t>({0,1,4}), senders(net2, 0));
+    for (device_t i = 0; i < 5; ++i)
+        EXPECT_EQ(senders(net1, i), senders(net2, i));
+    disconnect(net1, 0, 1);
+    disconnect(net2, 0, 1);
+    EXPECT_FALSE(net2.topology_ready());
+    net1.run(5.5);
+    net2.run(5.5);
+    EXPECT_TRUE(net2.topology_ready());
+    EXPECT_EQ(4u, net2.adjacency().size() / 2);
+    for (device_t i = 0; i < 5; ++i)
+        EXPECT_EQ(senders(net1, i), senders(net2, i));
+}
@@ -1,9 +1,13 @@
 // Copyright © 2021 Giorgio Audrito. All Rights Reserved.
 
+#include <algorithm>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 
+#include "lib/settings.hpp"
 #include "lib/common/multitype_map.hpp"
 
 using namespace fcpp;
@@ -51,3 +55,238 @@ TEST_F(MultitypeMapTest, Values) {
     EXPECT_EQ(999, data.at<int>(18));
     EXPECT_EQ('b', data.at<char>(7));
 }
+
+
+class FlatMultitypeMapTest : public ::testing::Test {
+  protected:
+    virtual void SetUp() {
+        data.insert(7, 'a');
+        data.insert<char>(7, 'b');
+        data.insert<char>(42, '+');
+        data.insert<char>(3, '-');
+        data.insert<int>(18, 31);
+        data.insert(18, 999);
+        data.insert(2);
+        data.insert(3);
+        data.insert(3);
+    }
+
+    common::flat_multitype_map<short, int, double, char> data;
+};
+
+
+TEST_F(FlatMultitypeMapTest, Operators) {
+    common::flat_multitype_map<short, int, double, char> x(data), y, z;
+    z = y;
+    y = x;
+    z = std::move(y);
+    EXPECT_EQ(data, z);
+    z.insert(1);
+    EXPECT_FALSE(data == z);
+}
+
+TEST_F(FlatMultitypeMapTest, Points) {
+    EXPECT_TRUE(data.contains(2));
+    EXPECT_TRUE(data.contains(3));
+    data.remove(3);
+    EXPECT_FALSE(data.contains(3));
+    EXPECT_FALSE(data.contains(0));
+    EXPECT_FALSE(data.contains(999));
+}
+
+TEST_F(FlatMultitypeMapTest, Values) {
+    EXPECT_TRUE(data.count<char>(42));
+    data.erase<char>(42);
+    EXPECT_FALSE(data.count<char>(42));
+    EXPECT_FALSE(data.count<double>(42));
+    EXPECT_EQ(999, data.at<int>(18));
+    EXPECT_EQ('b', data.at<char>(7));
+    EXPECT_EQ('-', data.at<char>(3));
+    data.at<char>(3) = '*';
+    EXPECT_EQ('*', data.at<char>(3));
+    EXPECT_FALSE(data.count<bool>(3));
+}
+
+TEST_F(MultitypeMapTest, Iteration) {
+    int keys = 0, vals = 0;
+    data.for_keys([&keys](short k) {
+        keys += k;
+    });
+    data.for_values<char>([&vals](short k, char c) {
+        vals += k * c;
+    });
+    EXPECT_EQ(5, keys);
+    EXPECT_EQ(7*'b' + 42*'+', vals);
+    data.for_values<bool>([&vals](short, bool) {
+        ++vals;
+    });
+    EXPECT_EQ(7*'b' + 42*'+', vals);
+}
+
+TEST_F(FlatMultitypeMapTest, Iteration) {
+    std::vector<short> keys, vals;
+    data.for_keys([&keys](short k) {
+        keys.push_back(k);
+    });
+    data.for_values<char>([&vals](short k, char) {
+        vals.push_back(k);
+    });
+    EXPECT_EQ(std::vector<short>({2, 3}), keys);
+    EXPECT_EQ(std::vector<short>({3, 7, 42}), vals);
+}
+
+
+TEST_F(MultitypeMapTest, Clear) {
+    data.clear();
+    EXPECT_EQ((common::multitype_map<short, int, double, char>{}), data);
+    EXPECT_FALSE(data.contains(2));
+    EXPECT_FALSE(data.count<char>(42));
+}
+
+TEST_F(FlatMultitypeMapTest, Clear) {
+    data.clear();
+    EXPECT_EQ((common::flat_multitype_map<short, int, double, char>{}), data);
+    EXPECT_FALSE(data.contains(2));
+    EXPECT_FALSE(data.count<char>(42));
+}
+
+
+class SchemaMultitypeMapTest : public ::testing::Test {
+  protected:
+    using map_type = common::schema_multitype_map<short, int, double, char>;
+
+    virtual void SetUp() {
+        schema = std::make_shared<map_type::schema_type>();
+        data.attach(schema);
+        data.insert(7, 'a');
+        data.insert<char>(7, 'b');
+        data.insert<char>(42, '+');
+        data.insert<char>(3, '-');
+        data.insert<int>(18, 31);
+        data.insert(18, 999);
+        data.insert(2);
+        data.insert(3);
+        data.insert(3);
+    }
+
+    std::shared_ptr<map_type::schema_type> schema;
+    map_type data;
+};
+
+
+TEST_F(SchemaMultitypeMapTest, Operators) {
+    map_type x(data), y, z;
+    z = y;
+    y = x;
+    z = std::move(y);
+    EXPECT_EQ(data, z);
+    EXPECT_EQ(schema, z.schema());
+    z.insert(1);
+    EXPECT_FALSE(data == z);
+    z.remove(1);
+    EXPECT_EQ(data, z);
+    x.insert(100, 'x');
+    x.erase<char>(100);
+    EXPECT_EQ(data, x);
+}
+
+TEST_F(SchemaMultitypeMapTest, Points) {
+    EXPECT_TRUE(data.contains(2));
+    EXPECT_TRUE(data.contains(3));
+    data.remove(3);
+    EXPECT_FALSE(data.contains(3));
+    EXPECT_FALSE(data.contains(0));
+    EXPECT_FALSE(data.contains(999));
+}
+
+TEST_F(SchemaMultitypeMapTest, Values) {
+    EXPECT_TRUE(data.count<char>(42));
+    data.erase<char>(42);
+    EXPECT_FALSE(data.count<char>(42));
+    EXPECT_FALSE(data.count<double>(42));
+    EXPECT_EQ(999, data.at<int>(18));
+    EXPECT_EQ('b', data.at<char>(7));
+    EXPECT_EQ('-', data.at<char>(3));
+    data.at<char>(3) = '*';
+    EXPECT_EQ('*', data.at<char>(3));
+    EXPECT_FALSE(data.count<bool>(3));
+    data.erase<bool>(3);
+}
+
+TEST_F(SchemaMultitypeMapTest, Iteration) {
+    std::vector<short> keys, vals;
+    data.for_keys([&keys](short k) {
+        keys.push_back(k);
+    });
+    data.for_values<char>([&vals](short k, char) {
+        vals.push_back(k);
+    });
+    std::sort(keys.begin(), keys.end());
+    std::sort(vals.begin(), vals.end());
+    EXPECT_EQ(std::vector<short>({2, 3}), keys);
+    EXPECT_EQ(std::vector<short>({3, 7, 42}), vals);
+}
+
+TEST_F(SchemaMultitypeMapTest, Clear) {
+    data.clear();
+    EXPECT_EQ(map_type{}, data);
+    EXPECT_EQ(nullptr, data.schema());
+    EXPECT_FALSE(data.contains(2));
+    EXPECT_FALSE(data.count<char>(42));
+}
+
+TEST_F(SchemaMultitypeMapTest, Attach) {
+    map_type x, y;
+    x.insert(3);
+    x.insert(42, '+');
+    x.insert(18, 999);
+    EXPECT_EQ(nullptr, x.schema());
+    y = x;
+    y.attach(schema);
+    EXPECT_EQ(x, y);
+    EXPECT_EQ(999, y.at<int>(18));
+    // a different network has its own schema, assigning slots in a different order
+    auto other = std::make_shared<map_type::schema_type>();
+    EXPECT_EQ(map_type::schema_type::registry_type::npos, other->registry<char>().find(42));
+    x.attach(other);
+    x.insert(2);
+    x.insert(7, 'b');
+    x.insert(3, '-');
+    EXPECT_EQ(0u, other->registry<char>().find(42));
+    EXPECT_EQ(1u, other->registry<char>().find(7));
+    EXPECT_EQ(0u, schema->registry<char>().find(7));
+    EXPECT_EQ(data, x);
+    x.attach(schema);
+    EXPECT_EQ(schema, x.schema());
+    EXPECT_EQ(data, x);
+}
+
+TEST(SchemaMultitypeMapOverflowTest, Overflow) {
+    using map_type = common::schema_multitype_map<int, double>;
+    auto schema = std::make_shared<map_type::schema_type>();
+    map_type x, y, z;
+    x.attach(schema);
+    y.attach(schema);
+    int n = FCPP_EXPORT_SLOTS + 10;
+    for (int i = 0; i < n; ++i) x.insert(i, i/2.0);
+    for (int i = n-1; i >= 0; --i) y.insert(i, i/2.0);
+    for (int i = 0; i < n; ++i) z.insert(i, i/2.0);
+    EXPECT_EQ(x, y);
+    EXPECT_EQ(x, z);
+    EXPECT_EQ(map_type::schema_type::registry_type::npos, schema->registry<double>().find(n-1));
+    for (int i = 0; i < n; ++i) {
+        EXPECT_TRUE(x.count<double>(i));
+        EXPECT_EQ(i/2.0, x.at<double>(i));
+    }
+    int count = 0;
+    x.for_values<double>([&count](int k, double v) {
+        EXPECT_EQ(k/2.0, v);
+        ++count;
+    });
+    EXPECT_EQ(n, count);
+    x.erase<double>(n-1);
+    x.erase<double>(0);
+    EXPECT_FALSE(x.count<double>(n-1));
+    EXPECT_FALSE(x.count<double>(0));
+    EXPECT_FALSE(x == y);
+}
@@ -1,5 +1,6 @@
 // Copyright © 2021 Giorgio Audrito. All Rights Reserved.
 
+#include <memory>
 #include <sstream>
 #include <iomanip>
 
@@ -46,17 +47,27 @@ TEST(OstreamTest, FCPP) {
     m.insert(42, 'x');
     m.insert(10, false);
     PRINT_EQ("(bool => {10:false}; char => {42:'x'})", m);
+    common::flat_multitype_map<trace_t,bool,char> f;
+    f.insert(42, 'x');
+    f.insert(10, false);
+    f.insert(7, 'y');
+    PRINT_EQ("(bool => [(10; false)]; char => [(7; 'y'), (42; 'x')])", f);
+    common::schema_multitype_map<trace_t,bool,char> s;
+    s.attach(std::make_shared<common::slot_schema<trace_t,bool,char>>());
+    s.insert(42, 'x');
+    s.insert(10, false);
+    PRINT_EQ("(bool => {10:false}; char => {42:'x'})", s);
     PRINT_EQ("{42:\"hello world\"}", common::random_access_map<int, std::string>{{42, "hello world"}});
     PRINT_EQ("(void => 3; int& => 'x')", common::make_tagged_tuple<void,int&>(3, 'x'));
     PRINT_EQ("(2)", internal::twin<int,true>{2});
     PRINT_EQ("(2; 2)", internal::twin<int,false>{2});
     {
-        internal::context<true, true, int, bool, char> c;
+        internal::context<true, true, false, false, false, false, false, int, bool, char> c;
         c.insert(42, m, 0, 10, 10);
         PRINT_EQ("(42:(bool => {10:false}; char => {42:'x'})@0)", c);
     }
     {
-        internal::context<false, false, int, bool, char> c;
+        internal::context<false, false, false, false, false, false, false, int, bool, char> c;
         c.insert(42, m, 0, 10, 10);
         PRINT_EQ("(42:(bool => {10:false}; char => {42:'x'})@0)", c);
     }
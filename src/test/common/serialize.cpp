@@ -1,5 +1,7 @@
 // Copyright © 2021 Giorgio Audrito. All Rights Reserved.
 
+#include <memory>
+
 #include "gtest/gtest.h"
 
 #include "lib/common/multitype_map.hpp"
@@ -114,6 +116,31 @@ TEST(SerializeTest, FCPP) {
     m.insert(3, 'x');
     m.insert(4, 4242);
     SERIALIZE_CHECK(m, {});
+    common::flat_multitype_map<trace_t, bool, char, int> fm;
+    fm.insert(42);
+    fm.insert(10);
+    fm.insert(1, false);
+    fm.insert(3, 'x');
+    fm.insert(2, 'z');
+    fm.insert(4, 4242);
+    SERIALIZE_CHECK(fm, {});
+    common::schema_multitype_map<trace_t, bool, char, int> sm;
+    sm.attach(std::make_shared<common::slot_schema<trace_t, bool, char, int>>());
+    sm.insert(42);
+    sm.insert(10);
+    sm.insert(1, false);
+    sm.insert(3, 'x');
+    sm.insert(2, 'z');
+    sm.insert(4, 4242);
+    SERIALIZE_CHECK(sm, {});
+    {
+        common::osstream os;
+        os << sm;
+        common::isstream is(os);
+        common::multitype_map<trace_t, bool, char, int> rm;
+        is >> rm;
+        EXPECT_EQ(m, rm);
+    }
     internal::flat_ptr<int, true> p{42};
     SERIALIZE_CHECK(p, {});
     internal::flat_ptr<int, false> q{42};
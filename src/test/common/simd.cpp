@@ -0,0 +1,196 @@
+// Copyright © 2021 Giorgio Audrito. All Rights Reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lib/common/simd.hpp"
+
+using namespace fcpp;
+
+
+// sequential folding of a vector prefix
+template <typename O, typename T>
+T sequential(O const& op, std::vector<T> const& v, size_t n) {
+    T r = v[0];
+    for (size_t i = 1; i < n; ++i) r = op(v[i], r);
+    return r;
+}
+
+// checks vectorised against sequential folding for every prefix
+template <typename T>
+void check_integral() {
+    std::mt19937 rnd(42);
+    std::uniform_int_distribution<int> d(-100, 100);
+    std::vector<T> v;
+    for (int i=0; i<100; ++i) v.push_back(d(rnd));
+    for (size_t n = 1; n <= v.size(); ++n) {
+        EXPECT_EQ(sequential(common::fold_min<T>{}, v, n), common::reduce(common::fold_min<T>{}, v.data(), n));
+        EXPECT_EQ(sequential(common::fold_max<T>{}, v, n), common::reduce(common::fold_max<T>{}, v.data(), n));
+        EXPECT_EQ(sequential(common::fold_sum<T>{}, v, n), common::reduce(common::fold_sum<T>{}, v.data(), n));
+    }
+}
+
+
+TEST(SIMDTest, Operators) {
+    EXPECT_EQ(2, common::fold_min<int>{}(2, 5));
+    EXPECT_EQ(5, common::fold_max<int>{}(2, 5));
+    EXPECT_EQ(7, common::fold_sum<int>{}(2, 5));
+    EXPECT_EQ(12, common::fold_sum<int>::repeat(3, 4));
+    EXPECT_EQ(3, common::fold_min<int>::repeat(3, 4));
+    EXPECT_FALSE(common::fold_all<bool>{}(true, false));
+    EXPECT_TRUE(common::fold_any<bool>{}(true, false));
+    EXPECT_TRUE((common::is_fold_op<common::fold_min<double>, double>));
+    EXPECT_FALSE((common::is_fold_op<common::fold_min<double>, int>));
+    EXPECT_FALSE((common::is_fold_op<std::less<int>, int>));
+}
+
+TEST(SIMDTest, Integral) {
+    check_integral<int8_t>();
+    check_integral<int16_t>();
+    check_integral<int32_t>();
+    check_integral<int64_t>();
+}
+
+TEST(SIMDTest, Floating) {
+    std::mt19937 rnd(42);
+    std::uniform_real_distribution<double> d(-100, 100);
+    std::vector<double> v;
+    std::vector<float> w;
+    for (int i=0; i<100; ++i) {
+        v.push_back(d(rnd));
+        w.push_back(v.back());
+    }
+    for (size_t n = 1; n <= v.size(); ++n) {
+        EXPECT_EQ(sequential(common::fold_min<double>{}, v, n), common::reduce(common::fold_min<double>{}, v.data(), n));
+        EXPECT_EQ(sequential(common::fold_max<double>{}, v, n), common::reduce(common::fold_max<double>{}, v.data(), n));
+        EXPECT_NEAR(sequential(common::fold_sum<double>{}, v, n), common::reduce(common::fold_sum<double>{}, v.data(), n), 1e-9);
+        EXPECT_EQ(sequential(common::fold_min<float>{}, w, n), common::reduce(common::fold_min<float>{}, w.data(), n));
+        EXPECT_EQ(sequential(common::fold_max<float>{}, w, n), common::reduce(common::fold_max<float>{}, w.data(), n));
+        EXPECT_NEAR(sequential(common::fold_sum<float>{}, w, n), common::reduce(common::fold_sum<float>{}, w.data(), n), 1e-2);
+    }
+}
+
+TEST(SIMDTest, Unordered) {
+    std::mt19937 rnd(42);
+    std::uniform_real_distribution<double> d(1, 2);
+    std::vector<double> v;
+    for (int i=0; i<100; ++i) v.push_back(d(rnd));
+    // zeros of both signs: the same value is found, possibly with a different sign
+    v[10] = -0.0;
+    v[60] = 0.0;
+    for (size_t n = 11; n <= v.size(); ++n) {
+        EXPECT_EQ(0.0, common::reduce(common::fold_min<double>{}, v.data(), n));
+        EXPECT_EQ(sequential(common::fold_min<double>{}, v, n), common::reduce(common::fold_min<double>{}, v.data(), n));
+    }
+    for (double& x : v) x = -x;
+    for (size_t n = 11; n <= v.size(); ++n)
+        EXPECT_EQ(0.0, common::reduce(common::fold_max<double>{}, v.data(), n));
+    // a NaN value: either NaN or a non-NaN value from the sequence is found
+    v[37] = std::numeric_limits<double>::quiet_NaN();
+    EXPECT_TRUE(std::isnan(sequential(common::fold_max<double>{}, v, 38)));
+    EXPECT_FALSE(std::isnan(sequential(common::fold_max<double>{}, v, 39)));
+    for (size_t n = 38; n <= v.size(); ++n) {
+        double r = common::reduce(common::fold_max<double>{}, v.data(), n);
+        EXPECT_TRUE(std::isnan(r) or std::find(v.begin(), v.begin() + n, r) != v.begin() + n);
+        r = common::reduce(common::fold_min<double>{}, v.data(), n);
+        EXPECT_TRUE(std::isnan(r) or std::find(v.begin(), v.begin() + n, r) != v.begin() + n);
+    }
+}
+
+TEST(SIMDTest, Boolean) {
+    bool v[100];
+    for (size_t i = 0; i < 100; ++i) v[i] = true;
+    for (size_t k = 0; k < 100; k += 7) {
+        v[k] = false;
+        for (size_t n = 1; n <= 100; ++n) {
+            EXPECT_EQ(k >= n, common::reduce(common::fold_all<bool>{}, v, n));
+            EXPECT_EQ(k > 0 or n > 1, common::reduce(common::fold_any<bool>{}, v, n));
+        }
+        v[k] = true;
+    }
+    for (size_t i = 0; i < 100; ++i) v[i] = false;
+    for (size_t n = 1; n <= 100; ++n) {
+        EXPECT_FALSE(common::reduce(common::fold_any<bool>{}, v, n));
+        v[n-1] = true;
+        EXPECT_TRUE(common::reduce(common::fold_any<bool>{}, v, n));
+        v[n-1] = false;
+    }
+}
+
+// square rounded before being used (as in within_radius, even if the compiler contracts multiply-adds)
+template <typename T>
+T rounded_square(T e) {
+    volatile T p = e * e;
+    return p;
+}
+
+TEST(SIMDTest, Radius) {
+    std::mt19937 rnd(42);
+    std::uniform_real_distribution<double> d(-2, 2);
+    double c[3] = {0.5, -0.25, 1}, x[3*64], r[64];
+    float cf[3] = {0.5, -0.25, 1}, xf[3*64], rf[64];
+    for (size_t i = 0; i < 3*64; ++i) xf[i] = x[i] = d(rnd);
+    for (size_t i = 0; i < 64; ++i) rf[i] = r[i] = d(rnd) + 2;
+    // points on the boundary are within the radius
+    x[5] = c[0] + 1.5;
+    x[64+5] = c[1];
+    r[5] = 1.5;
+    for (size_t k = 0; k <= 64; ++k) {
+        uint64_t m = 0, mu = 0, mf = 0;
+        for (size_t i = 0; i < k; ++i) {
+            double s = 0;
+            float sf = 0;
+            for (size_t j = 0; j < 2; ++j) {
+                s += rounded_square(x[j*64+i] - c[j]);
+                sf += rounded_square(xf[j*64+i] - cf[j]);
+            }
+            if (s <= r[i] * r[i]) m |= uint64_t(1) << i;
+            if (s <= r[0] * r[0]) mu |= uint64_t(1) << i;
+            if (sf <= rf[i] * rf[i]) mf |= uint64_t(1) << i;
+        }
+        EXPECT_EQ(m, common::within_radius<2>(c, x, 64, r, false, k));
+        EXPECT_EQ(mu, common::within_radius<2>(c, x, 64, r, true, k));
+        EXPECT_EQ(mf, common::within_radius<2>(cf, xf, 64, rf, false, k));
+        if (k > 5) {
+            EXPECT_TRUE((m >> 5) & 1);
+        }
+    }
+    EXPECT_EQ(0ULL, common::within_radius<3>(c, x, 64, r, false, 0));
+    EXPECT_NE(0ULL, common::within_radius<3>(c, x, 64, r, false, 64));
+}
+
+// points at exactly their radius (with squares computed exactly) on the boundary, and just inside or outside it
+template <typename T>
+void boundary_test() {
+    T c[2] = {1, -2}, x[2*64], r[64], in[64], out[64];
+    int triples[3][3] = {{3, 4, 5}, {5, 12, 13}, {8, 15, 17}};
+    for (size_t i = 0; i < 64; ++i) {
+        int const* t = triples[i % 3];
+        T sx = (i & 1) ? 1 : -1, sy = (i & 2) ? 1 : -1;
+        x[i] = c[0] + sx * t[0] * T(i/3 + 1);
+        x[64+i] = c[1] + sy * t[1] * T(i/3 + 1);
+        r[i] = t[2] * T(i/3 + 1);
+        in[i] = std::nextafter(r[i], T(0));
+        out[i] = std::nextafter(r[i], T(1000));
+    }
+    for (size_t k = 0; k <= 64; ++k) {
+        uint64_t all = k == 64 ? ~uint64_t(0) : (uint64_t(1) << k) - 1;
+        EXPECT_EQ(all, common::within_radius<2>(c, x, 64, r, false, k));
+        EXPECT_EQ(0ULL, common::within_radius<2>(c, x, 64, in, false, k));
+        EXPECT_EQ(all, common::within_radius<2>(c, x, 64, out, false, k));
+    }
+    // with the radius of the first point for all, only the first point is within it
+    EXPECT_EQ(1ULL, common::within_radius<2>(c, x, 64, r, true, 64));
+}
+
+TEST(SIMDTest, RadiusBoundary) {
+    boundary_test<double>();
+    boundary_test<float>();
+}
@@ -0,0 +1,153 @@
+// Copyright © 2021 Giorgio Audrito. All Rights Reserved.
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lib/common/slab_map.hpp"
+
+using namespace fcpp;
+
+
+// A non-movable value type counting live instances.
+struct pinned {
+    static int live;
+    pinned(int v) : val(v) {
+        ++live;
+    }
+    pinned(const pinned&) = delete;
+    ~pinned() {
+        --live;
+    }
+    int val;
+};
+int pinned::live = 0;
+
+// A non-movable value type refusing negative values.
+struct fragile : public pinned {
+    fragile(int v) : pinned(v) {
+        if (v < 0) throw std::invalid_argument("negative value");
+    }
+};
+
+
+TEST(SlabMapTest, Access) {
+    common::slab_map<int, double, 4> x, y;
+    EXPECT_TRUE(x.empty());
+    x.emplace(1, 3);
+    x.emplace(2, 4);
+    EXPECT_FALSE(x.empty());
+    EXPECT_EQ(2, (int)x.size());
+    EXPECT_EQ(3.0, x.at(1));
+    EXPECT_EQ(4.0, x.at(2));
+    EXPECT_THROW(x.at(7), std::out_of_range);
+    EXPECT_EQ(1, (int)x.count(2));
+    EXPECT_EQ(0, (int)x.count(42));
+    x.at(2) = 5;
+    EXPECT_EQ(5.0, x.at(2));
+    x.swap(y);
+    EXPECT_EQ(0, (int)x.size());
+    EXPECT_EQ(2, (int)y.size());
+    x = std::move(y);
+    EXPECT_EQ(5.0, x.at(2));
+    x.clear();
+    EXPECT_EQ(0, (int)x.size());
+    EXPECT_EQ(0, (int)x.count(1));
+}
+
+TEST(SlabMapTest, Modify) {
+    common::slab_map<int, pinned, 4> x;
+    for (int i = 0; i < 10; ++i) {
+        auto p = x.emplace(std::piecewise_construct, std::make_tuple(i), std::make_tuple(2*i));
+        EXPECT_TRUE(p.second);
+        EXPECT_EQ(i, p.first->first);
+        EXPECT_EQ(2*i, p.first->second.val);
+    }
+    EXPECT_EQ(10, pinned::live);
+    pinned* p3 = &x.at(3);
+    auto p = x.emplace(std::piecewise_construct, std::make_tuple(3), std::make_tuple(42));
+    EXPECT_FALSE(p.second);
+    EXPECT_EQ(6, p.first->second.val);
+    EXPECT_EQ(10, pinned::live);
+    EXPECT_EQ(0, (int)x.erase(92));
+    EXPECT_EQ(1, (int)x.erase(0));
+    EXPECT_EQ(1, (int)x.erase(9));
+    EXPECT_EQ(1, (int)x.erase(5));
+    EXPECT_EQ(7, (int)x.size());
+    EXPECT_EQ(7, pinned::live);
+    // values do not move, and do not share cache lines
+    EXPECT_EQ(p3, &x.at(3));
+    for (auto const& q : x) {
+        EXPECT_EQ(2*q.first, q.second.val);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(&q) % common::cache_line);
+    }
+    // erased slots are reused
+    x.emplace(std::piecewise_construct, std::make_tuple(11), std::make_tuple(22));
+    x.emplace(std::piecewise_construct, std::make_tuple(12), std::make_tuple(24));
+    x.emplace(std::piecewise_construct, std::make_tuple(13), std::make_tuple(26));
+    EXPECT_EQ(10, (int)x.size());
+    x.clear();
+    EXPECT_EQ(0, pinned::live);
+    x.emplace(std::piecewise_construct, std::make_tuple(1), std::make_tuple(2));
+    {
+        common::slab_map<int, pinned, 4> y(std::move(x));
+        EXPECT_EQ(1, pinned::live);
+    }
+    EXPECT_EQ(0, pinned::live);
+}
+
+TEST(SlabMapTest, Failures) {
+    common::slab_map<int, fragile, 4> x;
+    x.emplace(std::piecewise_construct, std::make_tuple(1), std::make_tuple(2));
+    // a duplicate key frees the slot it was constructed in
+    auto p = x.emplace(std::piecewise_construct, std::make_tuple(1), std::make_tuple(3));
+    EXPECT_FALSE(p.second);
+    EXPECT_EQ(2, p.first->second.val);
+    EXPECT_EQ(1, pinned::live);
+    p = x.emplace(std::piecewise_construct, std::make_tuple(2), std::make_tuple(4));
+    EXPECT_TRUE(p.second);
+    fragile* p2 = &p.first->second;
+    x.erase(2);
+    // a throwing constructor leaves the map unchanged and the slot free
+    EXPECT_THROW(x.emplace(std::piecewise_construct, std::make_tuple(3), std::make_tuple(-1)), std::invalid_argument);
+    EXPECT_EQ(1, (int)x.size());
+    EXPECT_EQ(0, (int)x.count(3));
+    EXPECT_EQ(1, pinned::live);
+    p = x.emplace(std::piecewise_construct, std::make_tuple(3), std::make_tuple(6));
+    EXPECT_TRUE(p.second);
+    EXPECT_EQ(p2, &p.first->second);
+    EXPECT_EQ(2, pinned::live);
+    x.clear();
+    EXPECT_EQ(0, pinned::live);
+}
+
+TEST(SlabMapTest, Iterators) {
+    common::slab_map<int, double, 4> x;
+    for (int i : {1, 2, 3, 11}) x.emplace(i, i*i);
+    auto it = x.find(2);
+    EXPECT_EQ(2, it->first);
+    EXPECT_EQ(4.0, it->second);
+    EXPECT_EQ(x.end(), x.find(9));
+    EXPECT_EQ(x.size(), (size_t)(x.end()-x.begin()));
+    x.erase(1);
+    it = x.find(11);
+    EXPECT_EQ(11, it->first);
+    EXPECT_EQ(121.0, it->second);
+    std::vector<int> v;
+    it = x.begin();
+    for (size_t i=0; i<x.size(); ++i) {
+        v.push_back(it[i].first);
+        v.push_back((int)it[i].second);
+    }
+    std::sort(v.begin(), v.end());
+    std::vector<int> w = {2,3,4,9,11,121};
+    EXPECT_EQ(w, v);
+    common::slab_map<int, double, 4> const& y = x;
+    EXPECT_EQ(3, y.find(3)->first);
+    EXPECT_EQ(y.end(), y.find(1));
+}
@@ -0,0 +1,106 @@
+// Copyright © 2021 Giorgio Audrito. All Rights Reserved.
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lib/common/small_vector.hpp"
+
+using namespace fcpp;
+
+
+// A type whose move constructor may throw.
+struct throwing {
+    throwing() = default;
+    throwing(throwing const&) = default;
+    throwing(throwing&&) {}
+};
+
+
+TEST(SmallVectorTest, Inline) {
+    common::small_vector<int, 4> v;
+    EXPECT_TRUE(v.empty());
+    EXPECT_TRUE(v.is_inline());
+    for (int i=0; i<4; ++i) v.push_back(i);
+    EXPECT_EQ(4ULL, v.size());
+    EXPECT_TRUE(v.is_inline());
+    v.push_back(4);
+    EXPECT_FALSE(v.is_inline());
+    EXPECT_EQ(5ULL, v.size());
+    for (int i=0; i<5; ++i) EXPECT_EQ(i, v[i]);
+    EXPECT_EQ(0, v.front());
+    EXPECT_EQ(4, v.back());
+    v.resize(2);
+    EXPECT_EQ(2ULL, v.size());
+    v.resize(3, 7);
+    EXPECT_EQ(7, v.back());
+    v.clear();
+    EXPECT_TRUE(v.empty());
+}
+
+TEST(SmallVectorTest, Copy) {
+    std::vector<int> s{1,2,3,4,5,6};
+    common::small_vector<int, 4> v(s.begin(), s.begin()+3), w(s), x;
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_FALSE(w.is_inline());
+    x = v;
+    EXPECT_EQ(v, x);
+    x = w;
+    EXPECT_EQ(w, x);
+    EXPECT_NE(v, x);
+    common::small_vector<int, 4> y(x);
+    EXPECT_EQ(w, y);
+    y = s;
+    EXPECT_EQ(w, y);
+}
+
+TEST(SmallVectorTest, Move) {
+    static_assert(std::is_nothrow_move_constructible<common::small_vector<std::unique_ptr<int>, 2>>::value, "");
+    static_assert(std::is_nothrow_move_assignable<common::small_vector<std::unique_ptr<int>, 2>>::value, "");
+    static_assert(not std::is_nothrow_move_constructible<common::small_vector<throwing, 2>>::value, "");
+    common::small_vector<std::unique_ptr<int>, 2> v, w;
+    v.emplace_back(new int(1));
+    w = std::move(v);
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(1, *w[0]);
+    w.emplace_back(new int(2));
+    w.emplace_back(new int(3));
+    std::unique_ptr<int>* p = w.data();
+    common::small_vector<std::unique_ptr<int>, 2> x(std::move(w));
+    EXPECT_TRUE(w.empty());
+    EXPECT_TRUE(w.is_inline());
+    EXPECT_EQ(p, x.data());
+    EXPECT_EQ(3, *x.back());
+}
+
+TEST(SmallVectorTest, Insert) {
+    common::small_vector<std::string, 3> v;
+    v.insert(v.end(), "c");
+    v.insert(v.begin(), "a");
+    v.insert(v.begin()+1, "b");
+    v.insert(v.end(), v[0]);
+    v.insert(v.begin(), v[3]);
+    EXPECT_EQ(5ULL, v.size());
+    EXPECT_EQ("a", v[0]);
+    EXPECT_EQ("a", v[1]);
+    EXPECT_EQ("b", v[2]);
+    EXPECT_EQ("c", v[3]);
+    EXPECT_EQ("a", v[4]);
+    std::vector<std::string> s{"x", "y"};
+    v.insert(v.begin()+1, s.begin(), s.end());
+    EXPECT_EQ("x", v[1]);
+    EXPECT_EQ("y", v[2]);
+    EXPECT_EQ("a", v[3]);
+    v.erase(v.begin()+1, v.begin()+3);
+    EXPECT_EQ(5ULL, v.size());
+    EXPECT_EQ("a", v[1]);
+    v.erase(v.begin());
+    EXPECT_EQ("a", v[0]);
+    EXPECT_EQ("b", v[1]);
+    v.pop_back();
+    EXPECT_EQ(3ULL, v.size());
+    EXPECT_EQ("c", v.back());
+}
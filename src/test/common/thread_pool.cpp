@@ -0,0 +1,86 @@
+// Copyright © 2021 Giorgio Audrito. All Rights Reserved.
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lib/common/algorithm.hpp"
+#include "lib/common/thread_pool.hpp"
+
+using namespace fcpp;
+
+
+TEST(ThreadPoolTest, Reserve) {
+    common::thread_pool pool(2);
+#ifdef FCPP_DISABLE_THREADS
+    EXPECT_EQ(0ULL, pool.size());
+#else
+    EXPECT_EQ(2ULL, pool.size());
+    pool.reserve(1);
+    EXPECT_EQ(2ULL, pool.size());
+    pool.reserve(5);
+    EXPECT_EQ(5ULL, pool.size());
+    pool.reserve(common::thread_pool::capacity + 1);
+    EXPECT_EQ(size_t(common::thread_pool::capacity), pool.size());
+#endif
+}
+
+TEST(ThreadPoolTest, Run) {
+    common::thread_pool pool;
+    for (size_t n : {0, 1, 2, 7, 64}) {
+        std::vector<int> v(n, 0);
+        pool.run(n, [&v](size_t t) {
+            ++v[t];
+        });
+        for (size_t t=0; t<n; ++t)
+            EXPECT_EQ(1, v[t]);
+    }
+}
+
+TEST(ThreadPoolTest, Nested) {
+    common::thread_pool pool(3);
+    const size_t N = 8;
+    std::atomic<int> acc{0};
+    std::vector<int> v(N*N, 0);
+    pool.run(N, [&](size_t i) {
+        pool.run(N, [&](size_t j) {
+            ++v[i*N+j];
+            ++acc;
+        });
+    });
+    EXPECT_EQ(int(N*N), acc);
+    for (size_t i=0; i<N*N; ++i)
+        EXPECT_EQ(1, v[i]);
+}
+
+TEST(ThreadPoolTest, Repeated) {
+    const size_t N = 1000;
+    std::atomic<size_t> acc{0};
+    for (size_t k=0; k<N; ++k)
+        common::parallel_for(common::tags::parallel_execution(4), 8, [&acc](size_t i, size_t t) {
+            EXPECT_LT(t, 4ULL);
+            acc += i;
+        });
+    EXPECT_EQ(28*N, acc);
+    size_t workers = common::thread_pool::instance().size();
+    for (size_t k=0; k<N; ++k)
+        common::parallel_for(common::tags::dynamic_execution(4, 2), 8, [&acc](size_t i, size_t t) {
+            EXPECT_LT(t, 4ULL);
+            acc += i;
+        });
+    EXPECT_EQ(56*N, acc);
+    EXPECT_EQ(workers, common::thread_pool::instance().size());
+}
+
+TEST(ThreadPoolTest, Concurrent) {
+    const size_t N = 100;
+    std::atomic<size_t> acc{0};
+    common::parallel_for(common::tags::parallel_execution(4), 4, [&acc](size_t, size_t) {
+        for (size_t k=0; k<N; ++k)
+            common::parallel_for(common::tags::dynamic_execution(3), 10, [&acc](size_t i, size_t) {
+                acc += i;
+            });
+    });
+    EXPECT_EQ(45*4*N, acc);
+}
@@ -1,6 +1,7 @@
 // Copyright © 2021 Giorgio Audrito. All Rights Reserved.
 
 #include <algorithm>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -19,7 +20,11 @@ using combo = component::combine_spec<
         exports<field<int>, times_t, int>,
         export_pointer<(O & 1) == 1>,
         export_split<(O & 2) == 2>,
-        online_drop<(O & 4) == 4>
+        trace_index<(O & 2) == 2>,
+        online_drop<(O & 4) == 4>,
+        export_flat<(O & 8) == 8>,
+        expiry_wheel<(O & 8) == 8>,
+        export_schema<(O & 16) == 16>
     >,
     component::base<>
 >;
@@ -74,7 +79,7 @@ void rounder(T& node) {
 }
 
 
-MULTI_TEST(CalculusTest, Size, O, 3) {
+MULTI_TEST(CalculusTest, Size, O, 5) {
     typename combo<O>::net  network{common::make_tagged_tuple<>()};
     typename combo<O>::node d0{network, common::make_tagged_tuple<uid, hoodsize>(0, device_t(3))};
     typename combo<O>::node d1{network, common::make_tagged_tuple<uid>(1)};
@@ -126,7 +131,7 @@ MULTI_TEST(CalculusTest, Size, O, 3) {
     d0.round_end(0);
 }
 
-MULTI_TEST(CalculusTest, Old, O, 3) {
+MULTI_TEST(CalculusTest, Old, O, 5) {
     typename combo<O>::net  network{common::make_tagged_tuple<>()};
     typename combo<O>::node d0{network, common::make_tagged_tuple<uid>(0)};
     times_t d;
@@ -161,7 +166,7 @@ MULTI_TEST(CalculusTest, Old, O, 3) {
     EXPECT_EQ(3, d);
 }
 
-MULTI_TEST(CalculusTest, Nbr, O, 3) {
+MULTI_TEST(CalculusTest, Nbr, O, 5) {
     typename combo<O>::net  network{common::make_tagged_tuple<>()};
     typename combo<O>::node d0{network, common::make_tagged_tuple<uid>(0)};
     typename combo<O>::node d1{network, common::make_tagged_tuple<uid>(1)};
@@ -198,3 +203,32 @@ MULTI_TEST(CalculusTest, Nbr, O, 3) {
     d = gossip(d0, 1, 1);
     EXPECT_EQ(4, d);
 }
+
+TEST(CalculusTest, Schema) {
+    typename combo<0>::net  plain{common::make_tagged_tuple<>()};
+    typename combo<16>::net n0{common::make_tagged_tuple<>()};
+    typename combo<16>::net n1{common::make_tagged_tuple<>()};
+    EXPECT_EQ(nullptr, plain.export_slots());
+    EXPECT_NE(nullptr, n0.export_slots());
+    EXPECT_NE(n0.export_slots(), n1.export_slots());
+    typename combo<16>::node d0{n0, common::make_tagged_tuple<uid>(0)};
+    typename combo<16>::node d1{n1, common::make_tagged_tuple<uid>(1)};
+    d0.round_start(0);
+    d1.round_start(0);
+    EXPECT_EQ(n0.export_slots(), details::get_export(d0).second()->schema());
+    EXPECT_EQ(n1.export_slots(), details::get_export(d1).second()->schema());
+    sharing(d0, 0, 4);
+    std::vector<trace_t> keys;
+    details::get_export(d0).second()->for_values<int>([&keys](trace_t k, int) {
+        keys.push_back(k);
+    });
+    ASSERT_EQ(1u, keys.size());
+    EXPECT_EQ(0u, n0.export_slots()->registry<int>().find(keys[0]));
+    EXPECT_EQ(size_t(-1), n1.export_slots()->registry<int>().find(keys[0]));
+    d0.round_end(0);
+    d1.round_end(0);
+    sendto(d0, d0);
+    d0.round_start(0);
+    EXPECT_EQ(4, sharing(d0, 0, 3));
+    d0.round_end(0);
+}
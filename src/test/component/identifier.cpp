@@ -1,5 +1,8 @@
 // Copyright © 2021 Giorgio Audrito. All Rights Reserved.
 
+#include <random>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "lib/component/base.hpp"
@@ -56,7 +59,8 @@ using combo1 = component::combine_spec<
     exposer,
     component::identifier<
         parallel<(O & 1) == 1>,
-        synchronised<(O & 2) == 2>
+        synchronised<(O & 2) == 2>,
+        calendar<(O & 4) == 4>
     >,
     component::base<parallel<(O & 1) == 1>>
 >;
@@ -68,13 +72,14 @@ using combo2 = component::combine_spec<
     component::scheduler<round_schedule<seq_per>>,
     component::identifier<
         parallel<(O & 1) == 1>,
-        synchronised<(O & 2) == 2>
+        synchronised<(O & 2) == 2>,
+        calendar<(O & 4) == 4>
     >,
     component::base<parallel<(O & 1) == 1>>
 >;
 
 
-MULTI_TEST(IdentifierTest, Sequential, O, 2) {
+MULTI_TEST(IdentifierTest, Sequential, O, 3) {
     typename combo1<O>::net network{common::make_tagged_tuple<>()};
     EXPECT_EQ(0, (int)network.node_size());
     EXPECT_EQ(0, (int)network.node_count(0));
@@ -100,7 +105,7 @@ MULTI_TEST(IdentifierTest, Sequential, O, 2) {
     EXPECT_EQ(1, (int)network.node_at(1).uid);
 }
 
-MULTI_TEST(IdentifierTest, Customised, O, 2) {
+MULTI_TEST(IdentifierTest, Customised, O, 3) {
     typename combo1<O>::net network{common::make_tagged_tuple<>()};
     EXPECT_EQ(0, (int)network.node_size());
     EXPECT_EQ(0, (int)network.node_count(0));
@@ -127,7 +132,7 @@ MULTI_TEST(IdentifierTest, Customised, O, 2) {
     EXPECT_EQ(24, (int)network.node_at(24).uid);
 }
 
-MULTI_TEST(IdentifierTest, Parallel, O, 2) {
+MULTI_TEST(IdentifierTest, Parallel, O, 3) {
     typename combo2<O>::net network{common::make_tagged_tuple<>()};
     EXPECT_EQ(0, (int)network.node_size());
     EXPECT_EQ(0, (int)network.node_count(0));
@@ -146,3 +151,68 @@ MULTI_TEST(IdentifierTest, Parallel, O, 2) {
     EXPECT_EQ(1, (int)network.node_erase(42));
     EXPECT_EQ(99, (int)network.node_size());
 }
+
+TEST(IdentifierTest, Balanced) {
+    combo2<0>::net sequential{common::make_tagged_tuple<>()};
+    combo2<1>::net balanced{common::make_tagged_tuple<threads>(4)};
+    EXPECT_EQ(4u, balanced.thread_utilisation().size());
+    EXPECT_EQ(0u, sequential.thread_utilisation().size());
+    for (int i=0; i<100; ++i) {
+        sequential.node_emplace(common::make_tagged_tuple<>());
+        balanced.node_emplace(common::make_tagged_tuple<>());
+    }
+    for (int i=0; i<2; ++i) {
+        sequential.update();
+        balanced.update();
+    }
+    for (device_t i=0; i<100; ++i)
+        EXPECT_EQ(sequential.node_at(i).result, balanced.node_at(i).result);
+    real_t total = 0;
+    for (real_t u : balanced.thread_utilisation()) {
+        EXPECT_LE(0, u);
+        EXPECT_GE(1, u);
+        total += u;
+    }
+    EXPECT_LT(0, total);
+}
+
+TEST(IdentifierTest, CalendarQueue) {
+    std::mt19937 rnd(42);
+    std::uniform_real_distribution<times_t> phase(0, 1);
+    std::uniform_real_distribution<times_t> jitter(0.9, 1.1);
+    component::details::times_queue<false> q;
+    component::details::calendar_queue c;
+    EXPECT_EQ(TIME_MAX, c.next());
+    EXPECT_EQ(std::vector<device_t>{}, c.pop(1));
+    // near-periodic rounds, with a growing and shrinking number of devices
+    device_t n = 0;
+    for (int r = 0; r < 2000; ++r) {
+        if (r < 1000 and r % 2 == 0) {
+            times_t t = (q.next() < TIME_MAX ? q.next() : 0) + phase(rnd);
+            q.push(t, n);
+            c.push(t, n);
+            ++n;
+        }
+        EXPECT_EQ(q.next(), c.next());
+        times_t t = q.next() + (r % 7 == 0 ? 0.3 : 0.01);
+        std::vector<device_t> v = q.pop(t);
+        EXPECT_EQ(v, c.pop(t));
+        EXPECT_EQ(q.next(), c.next());
+        for (device_t i : v) if (r < 1500 or i % 3 > 0) {
+            times_t nxt = t + jitter(rnd);
+            q.push(nxt, i);
+            c.push(nxt, i);
+        }
+    }
+    // synchronised rounds
+    for (device_t i = 0; i < 100; ++i) {
+        q.push(2000, i);
+        c.push(2000, i);
+    }
+    while (q.next() < TIME_MAX) {
+        times_t t = q.next();
+        EXPECT_EQ(t, c.next());
+        EXPECT_EQ(q.pop(t), c.pop(t));
+    }
+    EXPECT_EQ(TIME_MAX, c.next());
+}
@@ -93,6 +93,10 @@ TEST(TimerTest, NodePlanning) {
     EXPECT_EQ(12, device.next_time());
     fcpp::field<bool> f = device.message_time() == details::make_field({1,2,3}, std::vector<times_t>{TIME_MIN,2,3,4});
     EXPECT_TRUE(f);
+    device.align_neighbours({1,3});
+    EXPECT_EQ(2ULL, details::get_ids(device.message_time()).size());
+    EXPECT_EQ(TIME_MIN, details::self(device.message_time(), 2));
+    EXPECT_EQ(4, details::self(device.message_time(), 3));
     device.next_time(8);
     EXPECT_EQ(8, device.next_time());
     device.update();
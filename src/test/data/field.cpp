@@ -1,5 +1,7 @@
 // Copyright © 2021 Giorgio Audrito. All Rights Reserved.
 
+#include <functional>
+#include <type_traits>
 #include <unordered_map>
 
 #include "lib/data/field.hpp"
@@ -64,6 +66,9 @@ class FieldTest : public ::testing::Test {
 
 
 TEST_F(FieldTest, Constructors) {
+    // vectors of fields move them on reallocation
+    static_assert(std::is_nothrow_move_constructible<field<int>>::value, "");
+    static_assert(std::is_nothrow_move_assignable<field<int>>::value, "");
     field<double> x(fd), y;
     y = x;
     EXPECT_EQ(details::other(fd), details::other(y));
@@ -321,6 +326,36 @@ TEST_F(FieldTest, MapReduce) {
            return a < b ? a : b;
     }, f, {1,2,3});
     EXPECT_EQ(make_tuple(5,8), g);
+    x = map_hood([] (int i) {return i+1;}, copy(fi2));
+    eq = map_hood([] (int i, int j) {return i==j;}, x, build_field(2, {{1,5},{2,4}}));
+    EXPECT_TRUE(eq);
+    x = map_hood([] (int a, int i) {return a*i;}, 2, copy(fi2));
+    eq = map_hood([] (int i, int j) {return i==j;}, x, build_field(2, {{1,8},{2,6}}));
+    EXPECT_TRUE(eq);
+    x = map_hood([] (int a, int b, int i) {return a+b-i;}, 2, 3, copy(fi2));
+    eq = map_hood([] (int i, int j) {return i==j;}, x, build_field(4, {{1,1},{2,2}}));
+    EXPECT_TRUE(eq);
+}
+
+TEST_F(FieldTest, LargeDomain) {
+    std::unordered_map<device_t, int> data;
+    for (device_t i = 0; i < 3*FCPP_FIELD_INLINE; ++i) data[2*i] = i;
+    field<int> x = build_field(-1, data);
+    field<int> y = x;
+    field<int> z = std::move(y);
+    for (device_t i = 0; i < 3*FCPP_FIELD_INLINE; ++i) {
+        EXPECT_EQ(int(i), details::self(constify(z), 2*i));
+        EXPECT_EQ(-1, details::self(constify(z), 2*i+1));
+    }
+    details::self(z, 1) = 42;
+    EXPECT_EQ(3*FCPP_FIELD_INLINE+1, int(details::get_ids(z).size()));
+    EXPECT_EQ(42, details::self(constify(z), 1));
+    z = x + z;
+    EXPECT_EQ(41, details::self(constify(z), 1));
+    EXPECT_EQ(4, details::self(constify(z), 4));
+    field<int> w = details::align(constify(z), {1, 4, 5});
+    EXPECT_EQ(std::vector<device_t>({1,4}), joined_domain(w));
+    EXPECT_EQ(-2, details::other(w));
 }
 
 TEST_F(FieldTest, UnaryOperators) {
@@ -388,6 +423,64 @@ TEST_F(FieldTest, BinaryOperators) {
     EXPECT_EQ(make_tuple(1,0.5), details::other(z));
 }
 
+TEST_F(FieldTest, VectorisedFold) {
+    std::unordered_map<device_t, int> data;
+    std::vector<device_t> dom, sub;
+    for (device_t i=0; i<100; ++i) {
+        data[i] = (i * 37) % 101 - 50;
+        dom.push_back(i);
+        if (i % 3) sub.push_back(i);
+    }
+    field<int> f = build_field(7, data);
+    auto sum = [] (int i, int j) {return i+j;};
+    auto mn = [] (int i, int j) {return std::min(i,j);};
+    EXPECT_EQ(details::fold_hood(sum, f, dom), details::fold_hood(common::fold_sum<int>{}, f, dom));
+    EXPECT_EQ(details::fold_hood(mn, f, dom), details::fold_hood(common::fold_min<int>{}, f, dom));
+    EXPECT_EQ(details::fold_hood(sum, f, sub), details::fold_hood(common::fold_sum<int>{}, f, sub));
+    EXPECT_EQ(details::fold_hood(sum, f, 3, dom, 40), details::fold_hood(common::fold_sum<int>{}, f, 3, dom, 40));
+    dom.push_back(150);
+    dom.push_back(200);
+    EXPECT_EQ(details::fold_hood(sum, f, dom), details::fold_hood(common::fold_sum<int>{}, f, dom));
+    EXPECT_EQ(details::fold_hood(sum, fi1, dom), details::fold_hood(common::fold_sum<int>{}, fi1, dom));
+    EXPECT_EQ(details::fold_hood(sum, f, 3, dom, 200), details::fold_hood(common::fold_sum<int>{}, f, 3, dom, 200));
+    EXPECT_EQ(details::fold_hood(sum, f, 3, dom, 0), details::fold_hood(common::fold_sum<int>{}, f, 3, dom, 0));
+    EXPECT_EQ(details::fold_hood(mn, fi1, 5, dom, 0), details::fold_hood(common::fold_min<int>{}, fi1, 5, dom, 0));
+    EXPECT_FALSE(details::fold_hood(common::fold_all<bool>{}, fb1, {1,2,3}));
+    EXPECT_TRUE(details::fold_hood(common::fold_all<bool>{}, fb1, {1,3}));
+    EXPECT_TRUE(details::fold_hood(common::fold_any<bool>{}, fb2, {0,1,3}));
+    EXPECT_FALSE(details::fold_hood(common::fold_any<bool>{}, fb2, {0,3}));
+}
+
+TEST_F(FieldTest, Expressions) {
+    auto plus  = [] (int i, int j) { return i+j; };
+    auto times = [] (int i, int j) { return i*j; };
+    auto const& e = details::map_lazy(plus, fi1, details::map_lazy(times, fi2, 2));
+    EXPECT_TRUE(details::is_field_expr<decltype(e)>);
+    EXPECT_FALSE(std::is_copy_constructible<std::decay_t<decltype(e)>>::value);
+    EXPECT_FALSE(std::is_move_constructible<std::decay_t<decltype(e)>>::value);
+    EXPECT_SAME(int, to_local<decltype(e)>);
+    EXPECT_EQ(std::vector<device_t>({1,2,3}), joined_domain(e));
+    EXPECT_EQ(4, details::other(e));
+    EXPECT_EQ(9, details::self(e, 1));
+    EXPECT_EQ(8, details::self(e, 2));
+    EXPECT_EQ(1, details::self(e, 3));
+    field<int> x = e;
+    FIELD_EQ(x, build_field(4, {{1,9},{2,8},{3,1}}));
+    EXPECT_EQ(22, details::fold_hood(plus, e, {0,1,2,3}));
+    EXPECT_EQ(22, details::fold_hood(plus, details::map_lazy(plus, fi1, fi2 * 2), {0,1,2,3}));
+    auto const& f = details::map_lazy(plus, details::map_lazy(std::negate<int>{}, e), build_field(1, {{4,2}}));
+    x = f;
+    FIELD_EQ(x, build_field(-3, {{1,-8},{2,-7},{3,0},{4,-2}}));
+    field<bool> b = details::map_lazy([] (int i) { return i > 0; }, e);
+    EXPECT_TRUE(b);
+    x = map_hood(times, e, f);
+    FIELD_EQ(x, build_field(-12, {{1,-72},{2,-56},{3,0},{4,-8}}));
+    auto y = fi1 + fi2 * 2;
+    EXPECT_SAME(decltype(y), field<int>);
+    x = e;
+    FIELD_EQ(x, y);
+}
+
 TEST_F(FieldTest, InfixOperators) {
     field<int> f = fi2;
     fi2 <<= 2;
@@ -43,10 +43,15 @@ using combo = component::combine_spec<
     component::base<parallel<(O & 1) == 1>>
 >;
 
+template <typename T>
+std::vector<device_t> ids_of(field<T> const& f) {
+    return {details::get_ids(f).begin(), details::get_ids(f).end()};
+}
+
 #define EXPECT_ROUND(t, send, ...)                                      \
         std::this_thread::sleep_for(std::chrono::milliseconds(30));     \
         EXPECT_EQ(n.next(), times_t{t});                                \
-        EXPECT_EQ(details::get_ids(n.node_at(42).nbr_dist()),           \
+        EXPECT_EQ(ids_of(n.node_at(42).nbr_dist()),                     \
                   (std::vector<device_t>__VA_ARGS__));                  \
         EXPECT_EQ(conn->fake_send().size(), send ? sizeof(int)+1 : 0);  \
         n.update();
@@ -0,0 +1,167 @@
+// Copyright © 2021 Giorgio Audrito. All Rights Reserved.
+
+#include <algorithm>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define FCPP_TIME_TYPE int64_t
+#define FCPP_TIME_EPSILON 0
+
+#include "lib/component/base.hpp"
+#include "lib/component/identifier.hpp"
+#include "lib/component/scheduler.hpp"
+#include "lib/component/storage.hpp"
+#include "lib/component/timer.hpp"
+#include "lib/simulation/simulated_positioner.hpp"
+
+#include "test/helper.hpp"
+
+using namespace fcpp;
+using namespace component::tags;
+
+
+struct oth {};
+struct rounds {};
+
+// Component counting rounds and checking their times, exposing node creation.
+struct counter {
+    template <typename F, typename P>
+    struct component : public P {
+        struct node : public P::node {
+            using P::node::node;
+
+            void round_main(times_t t) {
+                P::node::round_main(t);
+                EXPECT_EQ(t, P::node::current_time());
+                ++P::node::storage(rounds{});
+            }
+        };
+        struct net : public P::net {
+            using P::net::net;
+            using P::net::node_emplace;
+        };
+    };
+};
+
+// rounds every 1/3 of a second in nanoseconds (not representable exactly as a real)
+using seq_per = sequence::periodic_n<1, 333333333, 333333333>;
+
+template <int O>
+using combo1 = component::combine_spec<
+    counter,
+    component::timer<>,
+    component::scheduler<round_schedule<seq_per>>,
+    component::identifier<
+        parallel<(O & 1) == 1>,
+        synchronised<(O & 2) == 2>,
+        calendar<(O & 4) == 4>
+    >,
+    component::storage<tuple_store<rounds,int>>,
+    component::base<parallel<(O & 1) == 1>>
+>;
+
+using combo2 = component::combine_spec<
+    component::scheduler<round_schedule<seq_per>>,
+    component::simulated_positioner<dimension<2>>,
+    component::base<>
+>;
+
+
+TEST(IntegerTimeTest, RadixQueue) {
+    std::mt19937 rnd(42);
+    std::uniform_int_distribution<times_t> delay(0, 1000);
+    std::priority_queue<std::pair<times_t, device_t>, std::vector<std::pair<times_t, device_t>>, std::greater<std::pair<times_t, device_t>>> q;
+    component::details::radix_queue<times_t> r;
+    EXPECT_EQ(TIME_MAX, r.next());
+    EXPECT_EQ(std::vector<device_t>{}, r.pop(1000));
+    for (device_t i = 0; i < 100; ++i) {
+        times_t t = delay(rnd) - 500;
+        q.emplace(t, i);
+        r.push(t, i);
+    }
+    for (int k = 0; k < 1000; ++k) {
+        EXPECT_EQ(q.top().first, r.next());
+        times_t t = q.top().first + (k % 3) * delay(rnd) / 10;
+        std::vector<device_t> v, w = r.pop(t);
+        while (q.top().first <= t) {
+            v.push_back(q.top().second);
+            q.pop();
+        }
+        std::sort(v.begin(), v.end());
+        std::sort(w.begin(), w.end());
+        EXPECT_EQ(v, w);
+        for (device_t i : v) {
+            times_t nxt = i % 5 ? t + delay(rnd) : TIME_MAX;
+            q.emplace(nxt, i);
+            r.push(nxt, i);
+        }
+    }
+    EXPECT_EQ(q.size(), r.pop(TIME_MAX).size());
+    EXPECT_EQ(TIME_MAX, r.next());
+    // times earlier than the last popped are postponed to it
+    r = component::details::radix_queue<times_t>{};
+    r.push(10, 0);
+    r.push(20, 1);
+    EXPECT_EQ(std::vector<device_t>{0}, r.pop(15));
+    r.push(5, 2);
+    EXPECT_EQ(10, r.next());
+    EXPECT_EQ(std::vector<device_t>{2}, r.pop(15));
+    EXPECT_EQ(20, r.next());
+}
+
+TEST(IntegerTimeTest, Distribution) {
+    std::mt19937 rnd(42);
+    EXPECT_EQ(2,        (distribution::constant_n<times_t, 5, 2>{rnd}(rnd)));
+    EXPECT_EQ(TIME_MAX, (distribution::constant_n<times_t, 1, 0>{rnd}(rnd)));
+    EXPECT_EQ(TIME_MIN, (distribution::constant_n<times_t, -1, 0>{rnd}(rnd)));
+    distribution::interval_n<times_t, 10, 20> d1{rnd};
+    distribution::exponential_n<times_t, 1000> d2{rnd};
+    double sum = 0;
+    for (int i = 0; i < 1000; ++i) {
+        times_t t = d1(rnd);
+        EXPECT_LE(10, t);
+        EXPECT_GE(20, t);
+        sum += d2(rnd);
+    }
+    EXPECT_NEAR(1000, sum / 1000, 100);
+}
+
+TEST(IntegerTimeTest, Sequence) {
+    std::mt19937 rnd(42);
+    sequence::periodic_n<1, 2, 3, 10> s1{rnd};
+    EXPECT_EQ(2, s1(rnd));
+    EXPECT_EQ(5, s1(rnd));
+    EXPECT_EQ(8, s1(rnd));
+    EXPECT_EQ(TIME_MAX, s1(rnd));
+    sequence::periodic<distribution::constant_n<times_t, 0>, distribution::interval_n<times_t, 95, 105>> s2{rnd};
+    times_t t = s2(rnd);
+    for (int i = 0; i < 100; ++i) {
+        times_t nt = s2(rnd);
+        EXPECT_LE(95, nt - t);
+        EXPECT_GE(105, nt - t);
+        t = nt;
+    }
+}
+
+TEST(IntegerTimeTest, Positioner) {
+    combo2::net  network{common::make_tagged_tuple<oth>("foo")};
+    combo2::node device{network, common::make_tagged_tuple<uid, x, v>(0, make_vec(0,0), make_vec(3,0))};
+    device.update();
+    // reaching 10 takes 10/3 ticks, rounded up
+    EXPECT_EQ(333333333 + 4, device.reach_time(0, 10, 333333333));
+    EXPECT_EQ(TIME_MAX, device.reach_time(1, 10, 333333333));
+}
+
+MULTI_TEST(IntegerTimeTest, Rounds, O, 3) {
+    typename combo1<O>::net network{common::make_tagged_tuple<oth>("foo")};
+    for (int i = 0; i < 10; ++i) network.node_emplace(common::make_tagged_tuple<oth>("bar"));
+    // exactly 30 rounds in ten seconds (the last one at 9999999990)
+    network.run(10000000000);
+    for (device_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(30, network.node_at(i).storage(rounds{}));
+        EXPECT_EQ(9999999990, network.node_at(i).current_time());
+    }
+}
@@ -26,7 +26,8 @@ using combo = component::combine_spec<
         exports<coordination::distance_compare_t, coordination::connection_t>,
         export_pointer<(O & 1) == 1>,
         export_split<(O & 2) == 2>,
-        online_drop<(O & 4) == 4>
+        online_drop<(O & 4) == 4>,
+        export_epoch<(O & 32) == 32>
     >,
     component::base<parallel<(O & 8) == 8>>
 >;
@@ -84,3 +85,45 @@ TEST(SlowdistanceTest, Connection) {
     EXPECT_ROUND(n, {7, 10, 7});
     EXPECT_ROUND(n, {9, 13, 9});
 }
+
+TEST(SlowdistanceTest, Epoch) {
+    test_net<combo<0b101001>, std::tuple<real_t,real_t,real_t>()> n{
+        [&](auto& node){
+            node.round_main(0);
+            return std::make_tuple(
+                node.storage(idealdist{}),
+                node.storage( fastdist{}),
+                node.storage( slowdist{})
+            );
+        }
+    };
+    EXPECT_ROUND(n,
+        {0,   1,   1.5f},
+        {0,   INF, INF},
+        {0,   INF, INF}
+    );
+    internal::end_epoch();
+    EXPECT_ROUND(n,
+        {0,   1,   1.5f},
+        {0,   1,   INF},
+        {0,   INF, INF},
+    );
+    internal::end_epoch();
+    EXPECT_ROUND(n,
+        {0,   1,   1.5f},
+        {0,   1,   1.5f},
+        {0,   1,   INF},
+    );
+    internal::end_epoch();
+    EXPECT_ROUND(n,
+        {0,   1,   1.5f},
+        {0,   1,   1.5f},
+        {0,   1,   INF},
+    );
+    internal::end_epoch();
+    EXPECT_ROUND(n,
+        {0,   1,   1.5f},
+        {0,   1,   1.5f},
+        {0,   1,   1.5f},
+    );
+}
@@ -1,6 +1,12 @@
 // Copyright © 2021 Giorgio Audrito. All Rights Reserved.
 
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -32,8 +38,31 @@ struct metric {
     double val;
 };
 
+// mock metric class growing by a given step at every update
+struct aging {
+    aging(double v) : step(v) {}
+
+    template <typename... Ts>
+    double update(double const& r, Ts const&...) const {
+        return r == 0 ? 0 : r + step;
+    }
+
+  protected:
+    double step;
+};
+
+// mock metric class growing by a given step at every update, declaring it
+struct linear_aging : public aging {
+    using aging::aging;
+
+    template <typename N>
+    double shift(N const&) const {
+        return step;
+    }
+};
+
 template <int O>
-using context_type = internal::context<(O & 2) != 2, (O & 1) == 1, double, fcpp::field<int>, char>;
+using context_type = internal::context<(O & 2) != 2, (O & 1) == 1, false, false, false, (O & 4) == 4, true, double, fcpp::field<int>, char>;
 
 class ContextTest : public ::testing::Test {
   protected:
@@ -81,7 +110,7 @@ MULTI_TEST_F(ContextTest, InsertErase, O, 1) {
     EXPECT_EQ(size_t(1), x.size(9));
 }
 
-MULTI_TEST_F(ContextTest, Align, O, 2) {
+MULTI_TEST_F(ContextTest, Align, O, 3) {
     context_type<O> data;
     data.insert(1, m, 0.5, 1.5, 9);
     m.insert(9);
@@ -97,7 +126,7 @@ MULTI_TEST_F(ContextTest, Align, O, 2) {
     data.unfreeze(0, metric{}, 1.5);
 }
 
-MULTI_TEST_F(ContextTest, Old, O, 2) {
+MULTI_TEST_F(ContextTest, Old, O, 3) {
     char c;
     context_type<O> data;
     data.insert(1, m, 0.5, 1.5, 9);
@@ -112,7 +141,7 @@ MULTI_TEST_F(ContextTest, Old, O, 2) {
     data.unfreeze(0, metric{}, 1.5);
 }
 
-MULTI_TEST_F(ContextTest, Nbr, O, 2) {
+MULTI_TEST_F(ContextTest, Nbr, O, 3) {
     context_type<O> data;
     data.insert(1, m, 0.5, 1.5, 9);
     m.insert(42, '-');
@@ -133,3 +162,217 @@ MULTI_TEST_F(ContextTest, Nbr, O, 2) {
     EXPECT_EQ(fie, fir);
     data.unfreeze(0, metric{}, 1.5);
 }
+
+MULTI_TEST_F(ContextTest, Flat, O, 2) {
+    common::flat_multitype_map<trace_t, fcpp::field<int>, char> f;
+    f.insert(42,'+');
+    f.insert(18, details::make_field({1,9}, std::vector<int>{9,2,2}));
+    f.insert(8);
+    internal::context<(O & 2) != 2, (O & 1) == 1, true, false, false, false, true, double, fcpp::field<int>, char> data;
+    data.insert(1, f, 0.5, 1.5, 9);
+    f.insert(42, '-');
+    f.insert(9);
+    data.insert(2, f, 1.0, 1.5, 9);
+    data.freeze(9, 0);
+    std::vector<device_t> ex, res;
+    ex = std::vector<device_t>{0,2};
+    res = data.align(9, 0);
+    EXPECT_EQ(ex, res);
+    fcpp::field<char> fcr, fce;
+    fcr = data.nbr(42, '*', 0);
+    fce = details::make_field({1,2}, std::vector<char>{'*', '+', '-'});
+    EXPECT_EQ(fce, fcr);
+    EXPECT_EQ('*', data.old(42, '*', 0));
+    data.unfreeze(0, metric{}, 1.5);
+}
+
+MULTI_TEST_F(ContextTest, Schema, O, 3) {
+    common::schema_multitype_map<trace_t, fcpp::field<int>, char> f;
+    f.attach(std::make_shared<common::slot_schema<trace_t, fcpp::field<int>, char>>());
+    f.insert(42,'+');
+    f.insert(18, details::make_field({1,9}, std::vector<int>{9,2,2}));
+    f.insert(8);
+    internal::context<(O & 2) != 2, (O & 1) == 1, false, true, false, (O & 4) == 4, true, double, fcpp::field<int>, char> data;
+    data.insert(1, f, 0.5, 1.5, 9);
+    f.insert(42, '-');
+    f.insert(9);
+    data.insert(2, f, 1.0, 1.5, 9);
+    data.freeze(9, 0);
+    std::vector<device_t> ex, res;
+    ex = std::vector<device_t>{0,2};
+    res = data.align(9, 0);
+    EXPECT_EQ(ex, res);
+    fcpp::field<char> fcr, fce;
+    fcr = data.nbr(42, '*', 0);
+    fce = details::make_field({1,2}, std::vector<char>{'*', '+', '-'});
+    EXPECT_EQ(fce, fcr);
+    EXPECT_EQ('*', data.old(42, '*', 0));
+    data.unfreeze(0, metric{}, 1.5);
+}
+
+MULTI_TEST_F(ContextTest, Epoch, O, 1) {
+    common::multitype_map<trace_t, fcpp::field<int>, char> f;
+    f.insert(42,'+');
+    f.insert(18, details::make_field({1,9}, std::vector<int>{9,2,2}));
+    f.insert(8);
+    internal::context<(O & 1) == 1, true, false, false, true, false, true, double, fcpp::field<int>, char> data;
+    data.insert(1, f, 0.5, 1.5, 9);
+    f.insert(42, '-');
+    f.insert(9);
+    data.insert(2, f, 1.0, 1.5, 9);
+    internal::end_epoch();
+    data.freeze(9, 0);
+    std::vector<device_t> ex, res;
+    ex = std::vector<device_t>{0,2};
+    res = data.align(9, 0);
+    EXPECT_EQ(ex, res);
+    fcpp::field<char> fcr, fce;
+    fcr = data.nbr(42, '*', 0);
+    fce = details::make_field({1,2}, std::vector<char>{'*', '+', '-'});
+    EXPECT_EQ(fce, fcr);
+    EXPECT_EQ('*', data.old(42, '*', 0));
+    data.unfreeze(0, metric{}, 1.5);
+    data.insert(2, f, 2.0, 1.5, 9);
+    internal::end_epoch();
+    data.freeze(9, 0);
+    fcr = data.nbr(42, '*', 0);
+    EXPECT_EQ(fce, fcr);
+    data.unfreeze(0, metric{}, 1.5);
+}
+
+TEST(ContextTest, Churn) {
+    std::mt19937 rnd(42);
+    internal::context<false, true, false, false, false, false, true, double, char> data;
+    std::map<device_t, char> ref;
+    for (int r = 0; r < 50; ++r) {
+        // few new devices in some rounds, many in others
+        std::uniform_int_distribution<device_t> d(1, r % 3 == 0 ? 200 : 30);
+        for (int i = 0; i < 40; ++i) {
+            device_t x = d(rnd);
+            char c = 'a' + (r + i) % 26;
+            common::multitype_map<trace_t, char> e;
+            e.insert(42, c);
+            data.insert(x, e, 0.5, 1.5, 0);
+            ref[x] = c;
+        }
+        data.freeze(std::numeric_limits<device_t>::max(), 0);
+        std::vector<device_t> ids{0};
+        std::vector<char> vals{'*'};
+        for (auto const& x : ref) {
+            ids.push_back(x.first);
+            vals.push_back(x.second);
+        }
+        EXPECT_EQ(ids, data.align(0));
+        field<char> f = data.nbr(42, '*', 0);
+        EXPECT_EQ(std::vector<device_t>(ids.begin()+1, ids.end()), std::vector<device_t>(details::get_ids(f).begin(), details::get_ids(f).end()));
+        EXPECT_EQ(vals, std::vector<char>(details::get_vals(f).begin(), details::get_vals(f).end()));
+        data.unfreeze(0, metric{}, 1.5);
+    }
+}
+
+TEST(ContextTest, HoodSize) {
+    std::mt19937 rnd(42);
+    std::uniform_int_distribution<device_t> d(1, 40);
+    std::uniform_int_distribution<int> v(0, 9);
+    internal::context<true, true, false, false, false, false, true, double, char> data;
+    std::map<device_t, double> ref;
+    for (int r = 0; r < 20; ++r) {
+        for (int i = 0; i < 30; ++i) {
+            device_t x = d(rnd);
+            double m = v(rnd) / 10.0;
+            common::multitype_map<trace_t, char> e;
+            e.insert(42);
+            data.insert(x, e, m, 0.85, 10);
+            if (m > 0.85) continue;
+            ref[x] = m;
+            if (ref.size() > 10) {
+                auto w = ref.begin();
+                for (auto it = ref.begin(); it != ref.end(); ++it)
+                    if (it->second >= w->second) w = it;
+                ref.erase(w);
+            }
+            auto w = ref.begin();
+            for (auto it = ref.begin(); it != ref.end(); ++it)
+                if (it->second >= w->second) w = it;
+            EXPECT_EQ(w->first, data.top());
+        }
+        data.freeze(10, 0);
+        std::vector<device_t> ids{0};
+        for (auto const& x : ref) ids.push_back(x.first);
+        EXPECT_EQ(ids, data.align(0));
+        EXPECT_EQ(ids, data.align(42, 0));
+        data.unfreeze(0, metric{0.8}, 0.85);
+        for (auto& x : ref) x.second = 0.8;
+    }
+}
+
+TEST(ContextTest, Expiry) {
+    std::mt19937 rnd(42);
+    std::uniform_int_distribution<device_t> d(1, 60);
+    std::uniform_int_distribution<int> v(0, 8);
+    internal::context<false, true, false, false, false, false, true, double, char> data;
+    internal::context<false, true, false, false, false, false, false, double, char> lin;
+    for (int r = 0; r < 50; ++r) {
+        for (int i = 0; i < 20; ++i) {
+            device_t x = d(rnd);
+            double m = v(rnd) * 0.25;
+            common::multitype_map<trace_t, char> e;
+            e.insert(42, char('a' + i));
+            data.insert(x, e, m, 2.0, 0);
+            lin.insert(x, e, m, 2.0, 0);
+        }
+        data.insert(0, {}, 0.0, 2.0, 0);
+        lin.insert(0, {}, 0.0, 2.0, 0);
+        device_t hoodsize = r % 5 == 0 ? 10 : 100;
+        data.freeze(hoodsize, 0);
+        lin.freeze(hoodsize, 0);
+        EXPECT_EQ(data.align(0), lin.align(0));
+        EXPECT_EQ(data.nbr(42, '*', 0), lin.nbr(42, '*', 0));
+        std::stringstream sd, sl;
+        data.print(sd);
+        lin.print(sl);
+        EXPECT_EQ(sd.str(), sl.str());
+        data.unfreeze(0, aging{0.25}, 2.0);
+        lin.unfreeze(0, linear_aging{0.25}, 2.0);
+        EXPECT_EQ(data.size(0), lin.size(0));
+    }
+}
+
+TEST(TraceIndexTest, Queries) {
+    common::multitype_map<trace_t, fcpp::field<int>, char> m1, m2;
+    m1.insert(7, 'a');
+    m1.insert(9);
+    m1.insert(8);
+    m2.insert(8);
+    m2.insert(7, 'b');
+    m2.insert(3, details::make_field({2}, std::vector<int>{1,5}));
+    internal::trace_index<fcpp::field<int>, char> index;
+    index.insert(1, m1);
+    index.insert(4, m2);
+    index.sort();
+    std::vector<device_t> ex, res;
+    ex = std::vector<device_t>{1,2,4};
+    res = index.align(8, 2);
+    EXPECT_EQ(ex, res);
+    ex = std::vector<device_t>{1,4};
+    res = index.align(8, 4);
+    EXPECT_EQ(ex, res);
+    ex = std::vector<device_t>{0,1};
+    res = index.align(9, 0);
+    EXPECT_EQ(ex, res);
+    ex = std::vector<device_t>{5};
+    res = index.align(42, 5);
+    EXPECT_EQ(ex, res);
+    fcpp::field<char> fc = details::make_field({1,4}, std::vector<char>{'*', 'a', 'b'});
+    EXPECT_EQ(fc, index.nbr(7, '*', 0));
+    EXPECT_EQ(fcpp::field<char>('*'), index.nbr(9, '*', 0));
+    fcpp::field<int> fi = details::make_field({4}, std::vector<int>{0,5});
+    EXPECT_EQ(fi, index.nbr(3, fcpp::field<int>(0), 2));
+    index.clear();
+    index.insert(4, m1);
+    index.sort();
+    ex = std::vector<device_t>{0,4};
+    res = index.align(9, 0);
+    EXPECT_EQ(ex, res);
+    EXPECT_EQ(fcpp::field<char>('*'), index.nbr(3, '*', 0));
+}
@@ -0,0 +1,86 @@
+// Copyright © 2021 Giorgio Audrito. All Rights Reserved.
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lib/data/field.hpp"
+#include "lib/internal/field_builder.hpp"
+
+using namespace fcpp;
+
+
+TEST(FieldBuilderTest, Default) {
+    internal::field_builder<int> b(3);
+    EXPECT_EQ(3, details::other(b.get()));
+    EXPECT_EQ(0u, details::get_ids(b.get()).size());
+    b.set(5, 2);
+    EXPECT_EQ(2, details::self(b.get(), 5));
+    EXPECT_EQ(3, details::self(b.get(), 4));
+    EXPECT_EQ(3, details::other(b.get()));
+}
+
+TEST(FieldBuilderTest, Merge) {
+    internal::field_builder<int> b(0);
+    b.set(4, 1);
+    b.set(2, 2);
+    b.set(7, 3);
+    b.set(2, 4);
+    b.merge();
+    field<int> const& f = b.get();
+    EXPECT_EQ(std::vector<device_t>({2, 4, 7}), std::vector<device_t>(details::get_ids(f).begin(), details::get_ids(f).end()));
+    EXPECT_EQ(4, details::self(f, 2));
+    EXPECT_EQ(1, details::self(f, 4));
+    EXPECT_EQ(3, details::self(f, 7));
+    b.set(7, 5);
+    b.set(1, 6);
+    b.set(9, 7);
+    b.set(5, 8);
+    b.set(1, 9);
+    internal::field_builder<int> const& c = b;
+    field<int> const& g = c.get();
+    EXPECT_EQ(std::vector<device_t>({1, 2, 4, 5, 7, 9}), std::vector<device_t>(details::get_ids(g).begin(), details::get_ids(g).end()));
+    EXPECT_EQ(9, details::self(g, 1));
+    EXPECT_EQ(4, details::self(g, 2));
+    EXPECT_EQ(1, details::self(g, 4));
+    EXPECT_EQ(8, details::self(g, 5));
+    EXPECT_EQ(5, details::self(g, 7));
+    EXPECT_EQ(7, details::self(g, 9));
+    EXPECT_EQ(0, details::other(g));
+}
+
+TEST(FieldBuilderTest, Random) {
+    std::mt19937 rnd(42);
+    std::uniform_int_distribution<int> d(0, 50);
+    internal::field_builder<int> b(-1);
+    field<int> f(-1);
+    for (int r = 0; r < 20; ++r) {
+        for (int i = 0; i < 30; ++i) {
+            device_t x = d(rnd);
+            b.set(x, 100*r + i);
+            details::self(f, x) = 100*r + i;
+        }
+        b.merge();
+        EXPECT_EQ(details::get_ids(f), details::get_ids(b.get()));
+        EXPECT_EQ(details::get_vals(f), details::get_vals(b.get()));
+    }
+}
+
+TEST(FieldBuilderTest, Align) {
+    internal::field_builder<int> b(0);
+    b.set(1, 1);
+    b.set(3, 3);
+    b.set(5, 5);
+    b.merge();
+    b.set(7, 7);
+    b.set(4, 4);
+    b.align({2, 3, 4, 5});
+    field<int> const& f = b.get();
+    EXPECT_EQ(std::vector<device_t>({3, 4, 5}), std::vector<device_t>(details::get_ids(f).begin(), details::get_ids(f).end()));
+    EXPECT_EQ(3, details::self(f, 3));
+    EXPECT_EQ(4, details::self(f, 4));
+    EXPECT_EQ(5, details::self(f, 5));
+    EXPECT_EQ(0, details::self(f, 1));
+    EXPECT_EQ(0, details::self(f, 7));
+}
@@ -1,17 +1,83 @@
 // Copyright © 2021 Giorgio Audrito. All Rights Reserved.
 
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
 
+#include "lib/common/multitype_map.hpp"
 #include "lib/internal/flat_ptr.hpp"
+#include "lib/internal/trace.hpp"
 
 using namespace fcpp;
 
 
+// counts the memory allocations performed in the program
+size_t allocations = 0;
+
+// the functions backing the counting operators (called indirectly, so that the compiler
+// does not match the replaced operators against malloc and free)
+void* (*allocate)(size_t) = std::malloc;
+void (*release)(void*) = std::free;
+
+void* operator new(size_t n) {
+    ++allocations;
+    if (void* p = allocate(n)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t n) {
+    return operator new(n);
+}
+
+void operator delete(void* p) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+// allocations per round, while every device produces an export shared with every other device
+template <typename M>
+std::vector<size_t> round_allocations() {
+    using export_type = internal::flat_ptr<M, false>;
+    constexpr size_t devices = 10;
+    std::vector<std::vector<export_type>> contexts(devices, std::vector<export_type>(devices));
+    std::vector<size_t> counts;
+    for (int r = 0; r < 10; ++r) {
+        size_t start = allocations;
+        for (size_t i = 0; i < devices; ++i) {
+            export_type e;
+            for (trace_t t = 0; t < 20; ++t) {
+                e->insert(t);
+                e->insert(t, int(r+t));
+                e->insert(t, double(r-t));
+            }
+            for (size_t j = 0; j < devices; ++j) contexts[j][i] = e;
+        }
+        counts.push_back(allocations - start);
+    }
+    return counts;
+}
+
+
 TEST(FlatPtrTest, Size) {
     EXPECT_EQ(sizeof(char),                  sizeof(internal::flat_ptr<char, true>));
-    EXPECT_EQ(sizeof(std::shared_ptr<char>), sizeof(internal::flat_ptr<char, false>));
+    EXPECT_EQ(sizeof(char),                  sizeof(internal::flat_ptr<char, true, true>));
+    EXPECT_EQ(sizeof(char*),                 sizeof(internal::flat_ptr<char, false>));
+    EXPECT_EQ(sizeof(char*),                 sizeof(internal::flat_ptr<char, false, true>));
 }
 
 TEST(FlatPtrTest, TrueOperators) {
@@ -62,3 +128,211 @@ TEST(FlatPtrTest, Assignment) {
     EXPECT_EQ('z', *fdata);
     EXPECT_EQ('a', *tdata);
 }
+
+TEST(FlatPtrTest, Moving) {
+    std::vector<int> v{1, 2, 3};
+    internal::flat_ptr<std::vector<int>, false> fdata(std::move(v));
+    EXPECT_EQ(3, (int)fdata->size());
+    EXPECT_EQ(0, (int)v.size());
+    v = {4, 5};
+    fdata = std::move(v);
+    EXPECT_EQ(2, (int)fdata->size());
+    EXPECT_EQ(0, (int)v.size());
+    v = {6};
+    internal::flat_ptr<std::vector<int>, true> tdata(std::move(v));
+    EXPECT_EQ(1, (int)tdata->size());
+    EXPECT_EQ(0, (int)v.size());
+}
+
+TEST(FlatPtrTest, Recycling) {
+    int* p;
+    {
+        internal::flat_ptr<std::vector<int>, false> fdata;
+        fdata->assign(100, 42);
+        p = fdata->data();
+        internal::flat_ptr<std::vector<int>, false> f1 = fdata;
+    }
+    internal::flat_ptr<std::vector<int>, false> fdata;
+    EXPECT_EQ(0, (int)fdata->size());
+    EXPECT_LE(100, (int)fdata->capacity());
+    fdata->push_back(1);
+    EXPECT_EQ(p, fdata->data());
+    internal::flat_ptr<std::vector<int>, false> f1 = fdata;
+    f1 = std::vector<int>{2};
+    EXPECT_EQ(1, (*fdata)[0]);
+    EXPECT_EQ(2, (*f1)[0]);
+}
+
+TEST(FlatPtrTest, Allocations) {
+    // flat maps keep their memory when cleared: no allocations after warm-up
+    std::vector<size_t> counts = round_allocations<common::flat_multitype_map<trace_t, int, double>>();
+    std::string report;
+    for (size_t c : counts) report += std::to_string(c) + " ";
+    RecordProperty("flat allocations per round", report);
+    EXPECT_LT(0u, counts[0]);
+    for (int r = 2; r < 10; ++r) EXPECT_EQ(0u, counts[r]);
+    // hash maps keep their buckets but not their entries: a steady number of allocations
+    counts = round_allocations<common::multitype_map<trace_t, int, double>>();
+    report.clear();
+    for (size_t c : counts) report += std::to_string(c) + " ";
+    RecordProperty("hash allocations per round", report);
+    EXPECT_LT(counts[2], counts[0]);
+    for (int r = 3; r < 10; ++r) EXPECT_EQ(counts[2], counts[r]);
+}
+
+TEST(FlatPtrTest, EpochOperators) {
+    internal::flat_ptr<char, false, true> data('a');
+    internal::flat_ptr<char, false, true> x(data), y, z;
+    z = y;
+    y = x;
+    z = std::move(y);
+    EXPECT_EQ(data, z);
+    *x = 'b';
+    EXPECT_EQ('b', *z);
+    x = 'c';
+    EXPECT_EQ('c', *x);
+    EXPECT_EQ('b', *data);
+    internal::end_epoch();
+    EXPECT_EQ('b', *data);
+    EXPECT_EQ('b', *z);
+}
+
+TEST(FlatPtrTest, EpochRecycling) {
+    std::vector<int>* p;
+    std::vector<internal::flat_ptr<std::vector<int>, false, true>> v;
+    {
+        internal::flat_ptr<std::vector<int>, false, true> fdata;
+        fdata->assign(100, 42);
+        p = &*fdata;
+        for (int i = 0; i < 10; ++i) v.push_back(fdata);
+    }
+    internal::end_epoch();
+    EXPECT_EQ(100, (int)v[0]->size());
+    v.pop_back();
+    internal::end_epoch();
+    EXPECT_EQ(p, &*v[0]);
+    v.clear();
+    internal::end_epoch();
+    bool found = false;
+    std::vector<internal::flat_ptr<std::vector<int>, false, true>> w(100);
+    for (auto const& x : w) {
+        EXPECT_EQ(0, (int)x->size());
+        if (&*x == p) {
+            found = true;
+            EXPECT_LE(100, (int)x->capacity());
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST(FlatPtrTest, EpochConcurrent) {
+    std::vector<std::thread> workers;
+    std::vector<int> errors(4, 0);
+    for (int t = 0; t < 4; ++t) workers.emplace_back([t,&errors](){
+        internal::flat_ptr<std::vector<int>, false, true> held;
+        held->assign(100, t);
+        std::vector<internal::flat_ptr<std::vector<int>, false, true>> v;
+        for (int i = 0; i < 20000; ++i) {
+            for (int j = 0; j < 5; ++j) v.push_back(held);
+            v.clear();
+            if (held->size() != 100 or held->back() != t) ++errors[t];
+        }
+    });
+    for (int i = 0; i < 1000; ++i) internal::end_epoch();
+    for (std::thread& w : workers) w.join();
+    internal::end_epoch();
+    for (int e : errors) EXPECT_EQ(0, e);
+}
+
+TEST(FlatPtrTest, EpochDomain) {
+    // threads log in lists of their own within a domain, whose epochs end while they are idle
+    using ptr_type = internal::flat_ptr<std::vector<long>, false, true>;
+    internal::epoch_domain domain(4);
+    ptr_type held;
+    held->assign(100, 42);
+    std::vector<int> errors(4, 0);
+    for (int r = 0; r < 50; ++r) {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < 4; ++t) workers.emplace_back([t,&held,&domain,&errors](){
+            internal::epoch_scope<true> scope(domain, t);
+            std::vector<ptr_type> v;
+            for (int i = 0; i < 1000; ++i) {
+                for (int j = 0; j < 5; ++j) v.push_back(held);
+                v.clear();
+                if (held->size() != 100 or held->back() != 42) ++errors[t];
+            }
+        });
+        for (std::thread& w : workers) w.join();
+        domain.end_epoch();
+        EXPECT_EQ(42, held->back());
+    }
+    for (int e : errors) EXPECT_EQ(0, e);
+    std::vector<long>* p = &*held;
+    {
+        internal::epoch_scope<true> scope(domain);
+        held = std::vector<long>();
+    }
+    domain.end_epoch();
+    // the object is recycled when the epoch of its domain ends
+    bool found = false;
+    std::vector<ptr_type> w(100);
+    for (auto const& x : w) if (&*x == p) {
+        found = true;
+        EXPECT_EQ(0, (int)x->size());
+        EXPECT_LE(100, (int)x->capacity());
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST(FlatPtrTest, EpochDomains) {
+    // every thread has a domain of its own, ending its epochs while the others are running
+    std::vector<std::thread> workers;
+    std::vector<int> errors(4, 0);
+    for (int t = 0; t < 4; ++t) workers.emplace_back([t,&errors](){
+        internal::epoch_domain domain(1);
+        internal::flat_ptr<std::vector<int>, false, true> held;
+        held->assign(100, t);
+        std::vector<internal::flat_ptr<std::vector<int>, false, true>> v;
+        for (int i = 0; i < 20000; ++i) {
+            {
+                internal::epoch_scope<true> scope(domain);
+                for (int j = 0; j < 5; ++j) v.push_back(held);
+                v.clear();
+                if (i % 7 == 0) held = std::vector<int>(100, t);
+            }
+            if (i % 20 == 0) domain.end_epoch();
+            if (held->size() != 100 or held->back() != t) ++errors[t];
+        }
+        internal::epoch_scope<true> scope(domain);
+        held = std::vector<int>();
+    });
+    for (std::thread& w : workers) w.join();
+    for (int e : errors) EXPECT_EQ(0, e);
+}
+
+TEST(FlatPtrTest, EpochAllocations) {
+    // every device produces an export per round, which is shared with every other device
+    using export_type = internal::flat_ptr<common::flat_multitype_map<trace_t, int, double>, false, true>;
+    constexpr size_t devices = 10;
+    std::vector<std::vector<export_type>> contexts(devices, std::vector<export_type>(devices));
+    std::vector<size_t> counts;
+    for (int r = 0; r < 10; ++r) {
+        size_t start = allocations;
+        for (size_t i = 0; i < devices; ++i) {
+            export_type e;
+            for (trace_t t = 0; t < 20; ++t) {
+                e->insert(t);
+                e->insert(t, int(r+t));
+                e->insert(t, double(r-t));
+            }
+            for (size_t j = 0; j < devices; ++j) contexts[j][i] = e;
+        }
+        internal::end_epoch();
+        counts.push_back(allocations - start);
+    }
+    std::string report;
+    for (size_t c : counts) report += std::to_string(c) + " ";
+    RecordProperty("allocations per round", report);
+    EXPECT_LT(0u, counts[0]);
+    for (int r = 3; r < 10; ++r) EXPECT_EQ(0u, counts[r]);
+}
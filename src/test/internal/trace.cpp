@@ -1,5 +1,6 @@
 // Copyright © 2021 Giorgio Audrito. All Rights Reserved.
 
+#include <stdexcept>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -13,6 +14,7 @@ struct public_trace : public internal::trace {
     using internal::trace::clear;
     using internal::trace::push;
     using internal::trace::pop;
+    using internal::trace::next;
 };
 
 public_trace test_trace;
@@ -50,6 +52,24 @@ TEST(TraceTest, PushPop) {
 
     EXPECT_EQ((trace_t)0, stack[0]);
     EXPECT_EQ((trace_t)15, stack[1]);
+
+    test_trace.push(15);
+    test_trace.push(120);
+    trace_t h = test_trace.hash(0);
+    test_trace.next(48);
+    test_trace.next(120);
+    EXPECT_EQ(h, test_trace.hash(0));
+    test_trace.pop();
+    test_trace.push(48);
+    h = test_trace.hash(0);
+    test_trace.pop();
+    test_trace.push(120);
+    test_trace.next(48);
+    EXPECT_EQ(h, test_trace.hash(0));
+    test_trace.pop();
+    EXPECT_EQ(stack[1], test_trace.hash(0));
+    test_trace.pop();
+    EXPECT_EQ(true, test_trace.empty());
 }
 
 TEST(TraceTest, TraceCall) {
@@ -84,3 +104,25 @@ TEST(TraceTest, TraceCycle) {
         EXPECT_EQ(stack[i], test_trace.hash(0));
     }
 }
+
+TEST(TraceTest, Capacity) {
+    public_trace t;
+    size_t capacity = public_trace::capacity;
+    std::vector<trace_t> stack;
+    for (size_t i=0; i<capacity; ++i) {
+        stack.push_back(t.hash(0));
+        t.push(i % k_hash_factor);
+    }
+    EXPECT_EQ(capacity, t.size());
+    EXPECT_THROW(t.push(1), std::length_error);
+    EXPECT_EQ(capacity, t.size());
+    for (size_t i=capacity; i>0; --i) {
+        t.pop();
+        EXPECT_EQ(stack[i-1], t.hash(0));
+    }
+    EXPECT_TRUE(t.empty());
+    t.push(3);
+    t.clear();
+    EXPECT_TRUE(t.empty());
+    EXPECT_EQ((trace_t)0, t.hash(0));
+}
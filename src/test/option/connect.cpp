@@ -1,6 +1,8 @@
 // Copyright © 2021 Giorgio Audrito. All Rights Reserved.
 
 #include <algorithm>
+#include <cstdint>
+#include <random>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -36,6 +38,7 @@ TEST(ConnectTest, Fixed) {
     EXPECT_TRUE(connect);
     connect = connector(nullptr, data, make_vec(0.5f,1), data, make_vec(0.51f,0));
     EXPECT_FALSE(connect);
+    EXPECT_EQ(1, connector.relative_radius(data));
 }
 
 TEST(ConnectTest, Radial) {
@@ -64,6 +67,11 @@ TEST(ConnectTest, Powered) {
     EXPECT_TRUE(connect);
     connect = connector(nullptr, data, make_vec(0.5f,1), data, make_vec(0.51f,0));
     EXPECT_FALSE(connect);
+    connect::powered<4>::data_type full = 1;
+    EXPECT_EQ(1, connector.relative_radius(data, data));
+    EXPECT_EQ(2, connector.relative_radius(data, full));
+    EXPECT_EQ(2, connector.relative_radius(data));
+    EXPECT_EQ(4, connector.relative_radius(full));
 }
 
 TEST(ConnectTest, Hierarchical) {
@@ -108,3 +116,59 @@ TEST(ConnectTest, Hierarchical) {
     connect = connector(nullptr, data1, make_vec(0.5f,1), data3, make_vec(0.51f,0));
     EXPECT_FALSE(connect);
 }
+
+// checks connection of batches against separate connection checks
+template <typename C>
+void check_batch(C const& connector, std::vector<typename C::data_type> const& data) {
+    using position_type = typename C::position_type;
+    std::mt19937_64 rnd(42), gen1(1), gen2(1);
+    std::uniform_real_distribution<real_t> pos(-3, 3);
+    std::vector<position_type> positions;
+    for (size_t i = 0; i < 100; ++i) positions.push_back(make_vec(pos(rnd), pos(rnd)));
+    // a point on the boundary of the unit radius
+    positions[7] = make_vec(positions[0][0] + 1, positions[0][1]);
+    for (size_t k : {0, 1, 5, 9, 63, 64}) {
+        connect::batch<position_type, typename C::data_type> b;
+        uint64_t expected = 0;
+        for (size_t i = 0; i < k; ++i) {
+            b.push_back(data[i+1], positions[i+1]);
+            if (connector(gen1, data[0], positions[0], data[i+1], positions[i+1]))
+                expected |= uint64_t(1) << i;
+        }
+        EXPECT_EQ(k, b.size());
+        EXPECT_EQ(k == 64, b.full());
+        EXPECT_EQ(expected, connector(gen2, data[0], positions[0], b, b.mask()));
+        EXPECT_EQ(0ULL, connector(gen2, data[0], positions[0], b, 0));
+    }
+}
+
+TEST(ConnectTest, Batch) {
+    std::mt19937_64 rnd(42);
+    std::uniform_real_distribution<real_t> power(0.5, 1);
+    std::uniform_int_distribution<int> rank(-1, 2);
+    {
+        connect::clique<2> connector(nullptr, common::make_tagged_tuple<>());
+        check_batch(connector, std::vector<connect::clique<2>::data_type>(100));
+    }
+    {
+        connect::fixed<1> connector(nullptr, common::make_tagged_tuple<>());
+        check_batch(connector, std::vector<connect::fixed<1>::data_type>(100));
+    }
+    {
+        using C = connect::powered<2>;
+        C connector(nullptr, common::make_tagged_tuple<>());
+        std::vector<C::data_type> data(100);
+        for (auto& d : data) common::get<component::tags::power_ratio>(d) = power(rnd);
+        check_batch(connector, data);
+    }
+    {
+        using C = connect::hierarchical<connect::radial<50, connect::powered<2>>>;
+        C connector(nullptr, common::make_tagged_tuple<>());
+        std::vector<C::data_type> data(100);
+        for (auto& d : data) {
+            common::get<component::tags::power_ratio>(d) = power(rnd);
+            common::get<component::tags::network_rank>(d) = rank(rnd);
+        }
+        check_batch(connector, data);
+    }
+}
@@ -1,6 +1,9 @@
 // Copyright © 2021 Giorgio Audrito. All Rights Reserved.
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -37,12 +40,118 @@ using seq_per = sequence::periodic<distribution::constant_n<times_t, 2>, distrib
 template <int O>
 using combo = component::combine_spec<
     exposer,
-    component::simulated_connector<message_size<(O & 2) == 2>, parallel<(O & 1) == 1>, connector<connect::fixed<1>>, delay<distribution::constant_n<times_t, 1, 4>>>,
+    component::simulated_connector<inbox<(O & 4) == 4>, neighbour_list<(O & 8) == 8>, static_topology<(O & 16) == 16>, message_size<(O & 2) == 2>, parallel<(O & 1) == 1>, connector<connect::fixed<1>>, delay<distribution::constant_n<times_t, 1, 4>>>,
     component::scheduler<round_schedule<seq_per>>,
     component::simulated_positioner<>,
     component::base<parallel<(O & 1) == 1>>
 >;
 
+// Connector checking connection only with one device at a time.
+struct single_fixed : public connect::fixed<1> {
+    using connect::fixed<1>::fixed;
+
+    template <typename G, typename T>
+    bool operator()(G&& g, T const& data1, position_type const& pos1, T const& data2, position_type const& pos2) const {
+        return connect::fixed<1>::operator()(std::forward<G>(g), data1, pos1, data2, pos2);
+    }
+};
+
+// Connector counting the connections checked.
+struct counting_fixed : public connect::fixed<1> {
+    using connect::fixed<1>::fixed;
+
+    static std::atomic<int> checks;
+
+    template <typename G, typename T>
+    bool operator()(G&& g, T const& data1, position_type const& pos1, T const& data2, position_type const& pos2) const {
+        ++checks;
+        return connect::fixed<1>::operator()(std::forward<G>(g), data1, pos1, data2, pos2);
+    }
+};
+std::atomic<int> counting_fixed::checks{0};
+
+template <int O>
+using counting_combo = component::combine_spec<
+    exposer,
+    component::simulated_connector<inbox<true>, static_topology<true>, parallel<(O & 1) == 1>, connector<counting_fixed>, delay<distribution::constant_n<times_t, 1, 4>>>,
+    component::scheduler<round_schedule<seq_per>>,
+    component::simulated_positioner<>,
+    component::base<parallel<(O & 1) == 1>>
+>;
+
+// Random connector counting the connections checked.
+struct counting_radial : public connect::radial<50, connect::fixed<1>> {
+    using connect::radial<50, connect::fixed<1>>::radial;
+
+    static std::atomic<int> checks;
+
+    template <typename G, typename T>
+    bool operator()(G&& g, T const& data1, position_type const& pos1, T const& data2, position_type const& pos2) const {
+        ++checks;
+        return connect::radial<50, connect::fixed<1>>::operator()(std::forward<G>(g), data1, pos1, data2, pos2);
+    }
+};
+std::atomic<int> counting_radial::checks{0};
+
+template <int O>
+using radial_combo = component::combine_spec<
+    exposer,
+    component::simulated_connector<inbox<(O & 2) == 2>, static_topology<true>, parallel<(O & 1) == 1>, connector<counting_radial>, delay<distribution::constant_n<times_t, 1, 4>>>,
+    component::scheduler<round_schedule<seq_per>>,
+    component::simulated_positioner<>,
+    component::base<parallel<(O & 1) == 1>>
+>;
+
+template <typename C>
+using batch_combo = component::combine_spec<
+    exposer,
+    component::simulated_connector<parallel<false>, connector<C>, delay<distribution::constant_n<times_t, 1, 4>>>,
+    component::scheduler<round_schedule<seq_per>>,
+    component::simulated_positioner<>,
+    component::base<parallel<false>>
+>;
+
+template <int O, size_t L>
+using level_combo = component::combine_spec<
+    exposer,
+    component::simulated_connector<grid_levels<L>, inbox<(O & 4) == 4>, static_topology<(O & 2) == 2>, parallel<(O & 1) == 1>, connector<connect::powered<4>>, delay<distribution::constant_n<times_t, 1, 4>>>,
+    component::scheduler<round_schedule<seq_per>>,
+    component::simulated_positioner<>,
+    component::base<parallel<(O & 1) == 1>>
+>;
+
+
+// Runs the nodes of a network up to a given time, updating the network before every round.
+template <bool parallel, typename N, typename V>
+void simulate(N& network, V const& nodes, times_t end) {
+    while (true) {
+        times_t t = TIME_MAX;
+        for (auto const& n : nodes) t = std::min(t, n->next());
+        if (t > end) break;
+        network.update();
+        for (auto const& n : nodes) if (n->next() == t) {
+            common::lock_guard<parallel> l(n->mutex);
+            n->update();
+        }
+    }
+}
+
+// Runs two networks of the same nodes up to a given time, expecting the same distances of neighbours (returning the number of connected pairs).
+template <bool parallel, typename N1, typename V1, typename N2, typename V2>
+int simulate_and_compare(N1& net1, V1 const& as, N2& net2, V2 const& bs, times_t end, real_t tolerance = 0) {
+    simulate<parallel>(net1, as, end);
+    simulate<parallel>(net2, bs, end);
+    int connected = 0;
+    for (size_t i=0; i<as.size(); ++i) for (size_t j=0; j<as.size(); ++j) {
+        real_t d = fcpp::details::self(as[i]->nbr_dist(), j);
+        if (d < INF) {
+            EXPECT_NEAR(d, fcpp::details::self(bs[i]->nbr_dist(), j), tolerance);
+            if (i != j) ++connected;
+        } else EXPECT_EQ(INF, fcpp::details::self(bs[i]->nbr_dist(), j));
+    }
+    return connected;
+}
+
 
 MULTI_TEST(SimulatedConnectorTest, Cell, O, 2) {
     int n[4]; // 4 nodes
@@ -90,6 +199,30 @@ MULTI_TEST(SimulatedConnectorTest, Cell, O, 2) {
     EXPECT_EQ(3, n[3]);
 }
 
+MULTI_TEST(SimulatedConnectorTest, Snapshot, O, 2) {
+    int n[3];
+    component::details::cell<(O & 1) == 1, int> c;
+    c.insert(n[0]);
+    c.insert(n[1]);
+    std::vector<int*> const& v = c.content();
+    c.insert(n[2]);
+    c.erase(n[0]);
+    // readers keep the content they started from until collection
+    EXPECT_EQ(2ULL, v.size());
+    EXPECT_EQ((O & 1) == 1 ? &n[0] : &n[2], v[0]);
+    std::vector<int*> w = c.content();
+    std::sort(w.begin(), w.end());
+    EXPECT_EQ(std::vector<int*>({&n[1], &n[2]}), w);
+    EXPECT_TRUE(c.touch());
+    EXPECT_FALSE(c.touch());
+    c.collect();
+    EXPECT_TRUE(c.touch());
+    c.link(c);
+    EXPECT_EQ(1ULL, c.linked().size());
+    c.unlink(c);
+    EXPECT_EQ(0ULL, c.linked().size());
+}
+
 MULTI_TEST(SimulatedConnectorTest, Connection, O, 2) {
     typename combo<O>::net network{common::make_tagged_tuple<oth>("foo")};
     EXPECT_EQ(1, network.connection_radius());
@@ -124,6 +257,21 @@ MULTI_TEST(SimulatedConnectorTest, EnterLeave, O, 2) {
     std::sort(close.begin(), close.end());
     target = {0,1,2,3};
     EXPECT_EQ(target, close);
+    // empty cells are reclaimed, and linked again when recreated
+    network.cell_leave(d3);
+    network.update();
+    close.clear();
+    for (auto c : network.cell_of(d0).linked()) for (auto n : c->content()) close.push_back(n->uid);
+    std::sort(close.begin(), close.end());
+    target = {0,1,2};
+    EXPECT_EQ(target, close);
+    network.cell_enter(d3);
+    close.clear();
+    for (auto c : network.cell_of(d0).linked()) for (auto n : c->content()) close.push_back(n->uid);
+    std::sort(close.begin(), close.end());
+    target = {0,1,2,3};
+    EXPECT_EQ(target, close);
+    EXPECT_EQ(3ULL, network.cell_of(d3).linked().size());
 }
 
 MULTI_TEST(SimulatedConnectorTest, Messages, O, 2) {
@@ -206,3 +354,236 @@ MULTI_TEST(SimulatedConnectorTest, Messages, O, 2) {
     d = fcpp::details::self(d0.nbr_dist(), 5);
     EXPECT_EQ(INF, d);
 }
+
+MULTI_TEST(SimulatedConnectorTest, Inbox, O, 2) {
+    auto update = [](auto& node) {
+        common::lock_guard<(O & 1) == 1> l(node.mutex);
+        node.update();
+    };
+    typename combo<O | 4>::net  network{common::make_tagged_tuple<oth>("foo")};
+    typename combo<O | 4>::node d0{network, common::make_tagged_tuple<uid, x>(0, make_vec(0.25,0.25))};
+    typename combo<O | 4>::node d1{network, common::make_tagged_tuple<uid, x>(1, make_vec(0.0,0.0))};
+    typename combo<O | 4>::node d2{network, common::make_tagged_tuple<uid, x>(2, make_vec(1.5,0.5))};
+    typename combo<O | 4>::node d3{network, common::make_tagged_tuple<uid, x>(3, make_vec(1.5,1.5))};
+    d0.velocity() = make_vec(1,1);
+    for (int i=0; i<2; ++i) {
+        update(d0);
+        update(d1);
+        update(d2);
+        update(d3);
+    }
+    // messages sent at 2.25 are still waiting in the inboxes
+    real_t d;
+    d = fcpp::details::self(d0.nbr_dist(), 1);
+    EXPECT_EQ(INF, d);
+    d = fcpp::details::self(d0.nbr_dist(), 2);
+    EXPECT_EQ(INF, d);
+    EXPECT_NEAR(2.75, d0.next(), FCPP_TIME_EPSILON);
+    update(d0);
+    EXPECT_EQ(3, d0.next());
+    update(d0);
+    update(d1);
+    // delivered at the round start, with positions at sending time
+    d = fcpp::details::self(d0.nbr_dist(), 0);
+    EXPECT_NEAR(0, d, 1e-9);
+    d = fcpp::details::self(d0.nbr_dist(), 1);
+    EXPECT_NEAR(0.7071067811865476, d, 1e-9);
+    d = fcpp::details::self(d0.nbr_dist(), 2);
+    EXPECT_NEAR(1, d, 1e-9);
+    d = fcpp::details::self(d0.nbr_dist(), 3);
+    EXPECT_EQ(INF, d);
+    d = fcpp::details::self(d1.nbr_dist(), 0);
+    EXPECT_NEAR(0.7071067811865476, d, 1e-9);
+}
+
+MULTI_TEST(SimulatedConnectorTest, NeighbourList, O, 3) {
+    // the same nodes, sending to neighbours found through cells or through lists of candidates
+    typename combo<O>::net  net1{common::make_tagged_tuple<oth>("foo")};
+    typename combo<O | 8>::net  net2{common::make_tagged_tuple<skin>(0.5)};
+    EXPECT_EQ(0.5, net2.skin());
+    typename combo<O>::node a0{net1, common::make_tagged_tuple<uid, x, v>(0, make_vec(0,0), make_vec(1,0))};
+    typename combo<O>::node a1{net1, common::make_tagged_tuple<uid, x>(1, make_vec(3,0))};
+    typename combo<O>::node a2{net1, common::make_tagged_tuple<uid, x, v>(2, make_vec(3,3), make_vec(0,-0.5))};
+    typename combo<O>::node a3{net1, common::make_tagged_tuple<uid, x, v>(3, make_vec(6,0), make_vec(-1,0.1))};
+    typename combo<O | 8>::node b0{net2, common::make_tagged_tuple<uid, x, v>(0, make_vec(0,0), make_vec(1,0))};
+    typename combo<O | 8>::node b1{net2, common::make_tagged_tuple<uid, x>(1, make_vec(3,0))};
+    typename combo<O | 8>::node b2{net2, common::make_tagged_tuple<uid, x, v>(2, make_vec(3,3), make_vec(0,-0.5))};
+    typename combo<O | 8>::node b3{net2, common::make_tagged_tuple<uid, x, v>(3, make_vec(6,0), make_vec(-1,0.1))};
+    std::vector<decltype(&a0)> as = {&a0, &a1, &a2, &a3};
+    std::vector<decltype(&b0)> bs = {&b0, &b1, &b2, &b3};
+    int connected = 0;
+    for (times_t end : {3.5, 4.5, 5.5, 6.5, 7.5, 8.5})
+        connected += simulate_and_compare<(O & 1) == 1>(net1, as, net2, bs, end, 1e-6);
+    EXPECT_LT(0, connected);
+}
+
+MULTI_TEST(SimulatedConnectorTest, StaticTopology, O, 3) {
+    // the same stationary nodes, sending through cells or through the compressed adjacency
+    typename combo<O>::net  net1{common::make_tagged_tuple<oth>("foo")};
+    typename combo<O | 16>::net  net2{common::make_tagged_tuple<oth>("foo")};
+    typename combo<O>::node a0{net1, common::make_tagged_tuple<uid, x>(0, make_vec(0.25,0.25))};
+    typename combo<O>::node a1{net1, common::make_tagged_tuple<uid, x>(1, make_vec(0.0,0.0))};
+    typename combo<O>::node a2{net1, common::make_tagged_tuple<uid, x>(2, make_vec(1.0,0.5))};
+    typename combo<O>::node a3{net1, common::make_tagged_tuple<uid, x>(3, make_vec(1.5,1.5))};
+    typename combo<O | 16>::node b0{net2, common::make_tagged_tuple<uid, x>(0, make_vec(0.25,0.25))};
+    typename combo<O | 16>::node b1{net2, common::make_tagged_tuple<uid, x>(1, make_vec(0.0,0.0))};
+    typename combo<O | 16>::node b2{net2, common::make_tagged_tuple<uid, x>(2, make_vec(1.0,0.5))};
+    typename combo<O | 16>::node b3{net2, common::make_tagged_tuple<uid, x>(3, make_vec(1.5,1.5))};
+    std::vector<decltype(&a0)> as = {&a0, &a1, &a2, &a3};
+    std::vector<decltype(&b0)> bs = {&b0, &b1, &b2, &b3};
+    EXPECT_FALSE(net2.topology_ready());
+    EXPECT_EQ(4, simulate_and_compare<(O & 1) == 1>(net1, as, net2, bs, 3.5));
+    EXPECT_TRUE(net2.topology_ready());
+    // arcs 0-1 and 0-2 in both directions
+    EXPECT_EQ(4u, net2.adjacency().size());
+    {
+        typename combo<O>::node a4{net1, common::make_tagged_tuple<uid, x>(4, make_vec(0.5,1.0))};
+        typename combo<O | 16>::node b4{net2, common::make_tagged_tuple<uid, x>(4, make_vec(0.5,1.0))};
+        EXPECT_FALSE(net2.topology_ready());
+        as.push_back(&a4);
+        bs.push_back(&b4);
+        EXPECT_EQ(8, simulate_and_compare<(O & 1) == 1>(net1, as, net2, bs, 5.5));
+        EXPECT_TRUE(net2.topology_ready());
+        // new arcs 0-4 and 2-4 in both directions
+        EXPECT_EQ(8u, net2.adjacency().size());
+        as.pop_back();
+        bs.pop_back();
+    }
+    EXPECT_FALSE(net2.topology_ready());
+    EXPECT_EQ(4, simulate_and_compare<(O & 1) == 1>(net1, as, net2, bs, 6.5));
+    EXPECT_EQ(4u, net2.adjacency().size());
+}
+
+MULTI_TEST(SimulatedConnectorTest, StaticInbox, O, 1) {
+    typename counting_combo<O>::net  network{common::make_tagged_tuple<oth>("foo")};
+    typename counting_combo<O>::node d0{network, common::make_tagged_tuple<uid, x>(0, make_vec(0.25,0.25))};
+    typename counting_combo<O>::node d1{network, common::make_tagged_tuple<uid, x>(1, make_vec(0.0,0.0))};
+    typename counting_combo<O>::node d2{network, common::make_tagged_tuple<uid, x>(2, make_vec(1.0,0.5))};
+    typename counting_combo<O>::node d3{network, common::make_tagged_tuple<uid, x>(3, make_vec(1.5,1.5))};
+    std::vector<decltype(&d0)> ds = {&d0, &d1, &d2, &d3};
+    simulate<(O & 1) == 1>(network, ds, 3.5);
+    EXPECT_TRUE(network.topology_ready());
+    // messages sent through the adjacency are delivered with no further checks
+    counting_fixed::checks = 0;
+    simulate<(O & 1) == 1>(network, ds, 6.5);
+    EXPECT_EQ(0, counting_fixed::checks);
+    real_t d = fcpp::details::self(d0.nbr_dist(), 2);
+    EXPECT_NEAR(0.7905694150420949, d, 1e-9);
+    d = fcpp::details::self(d0.nbr_dist(), 3);
+    EXPECT_EQ(INF, d);
+}
+
+MULTI_TEST(SimulatedConnectorTest, StaticRandom, O, 2) {
+    static_assert(component::simulated_connector<connector<counting_fixed>>::deterministic, "");
+    static_assert(component::simulated_connector<connector<connect::hierarchical<connect::powered<1>>>>::deterministic, "");
+    static_assert(not component::simulated_connector<connector<counting_radial>>::deterministic, "");
+    static_assert(not component::simulated_connector<connector<connect::hierarchical<connect::radial<50, connect::fixed<1>>>>>::deterministic, "");
+    typename radial_combo<O>::net  network{common::make_tagged_tuple<oth>("foo")};
+    typename radial_combo<O>::node d0{network, common::make_tagged_tuple<uid, x>(0, make_vec(0.25,0.25))};
+    typename radial_combo<O>::node d1{network, common::make_tagged_tuple<uid, x>(1, make_vec(0.0,0.0))};
+    typename radial_combo<O>::node d2{network, common::make_tagged_tuple<uid, x>(2, make_vec(1.0,0.5))};
+    typename radial_combo<O>::node d3{network, common::make_tagged_tuple<uid, x>(3, make_vec(1.5,1.5))};
+    std::vector<decltype(&d0)> ds = {&d0, &d1, &d2, &d3};
+    simulate<(O & 1) == 1>(network, ds, 3.5);
+    EXPECT_TRUE(network.topology_ready());
+    // arcs 0-1 and 0-2 within the maximum radius, in both directions
+    EXPECT_EQ(4u, network.adjacency().size());
+    // connection is sampled again for every message, on sending or on delivery
+    counting_radial::checks = 0;
+    simulate<(O & 1) == 1>(network, ds, 6.5);
+    EXPECT_EQ(12, counting_radial::checks);
+    EXPECT_EQ(INF, fcpp::details::self(d0.nbr_dist(), 3));
+}
+
+TEST(SimulatedConnectorTest, Batch) {
+    static_assert(component::simulated_connector<parallel<false>, connector<connect::fixed<1>>>::batch_check, "");
+    static_assert(component::simulated_connector<parallel<false>, connector<connect::powered<1>>>::batch_check, "");
+    static_assert(not component::simulated_connector<parallel<false>, connector<single_fixed>>::batch_check, "");
+    static_assert(not component::simulated_connector<parallel<true>, connector<connect::fixed<1>>>::batch_check, "");
+    static_assert(not component::simulated_connector<parallel<false>, inbox<true>, connector<connect::fixed<1>>>::batch_check, "");
+    // the same nodes, sending with connection checked in batches or one at a time
+    typename batch_combo<connect::fixed<1>>::net net1{common::make_tagged_tuple<oth>("foo")};
+    typename batch_combo<single_fixed>::net net2{common::make_tagged_tuple<oth>("foo")};
+    std::vector<std::unique_ptr<typename batch_combo<connect::fixed<1>>::node>> as;
+    std::vector<std::unique_ptr<typename batch_combo<single_fixed>::node>> bs;
+    std::mt19937_64 rnd(42);
+    std::uniform_real_distribution<real_t> pos(0, 3);
+    for (int i=0; i<150; ++i) {
+        vec<2> p = make_vec(pos(rnd), pos(rnd));
+        as.emplace_back(new typename batch_combo<connect::fixed<1>>::node{net1, common::make_tagged_tuple<uid, x>(i, p)});
+        bs.emplace_back(new typename batch_combo<single_fixed>::node{net2, common::make_tagged_tuple<uid, x>(i, p)});
+    }
+    for (int k=0; k<3; ++k) {
+        for (auto& n : as) n->update();
+        for (auto& n : bs) n->update();
+    }
+    int connected = 0;
+    for (int i=0; i<150; ++i) for (int j=0; j<150; ++j) {
+        real_t d = fcpp::details::self(as[i]->nbr_dist(), j);
+        EXPECT_EQ(d, fcpp::details::self(bs[i]->nbr_dist(), j));
+        if (d < INF) ++connected;
+    }
+    EXPECT_LT(1000, connected);
+}
+
+MULTI_TEST(SimulatedConnectorTest, GridLevels, O, 3) {
+    // the same nodes with mixed powers, in a single grid level or in three levels
+    typename level_combo<O, 1>::net net1{common::make_tagged_tuple<oth>("foo")};
+    typename level_combo<O, 3>::net net2{common::make_tagged_tuple<oth>("foo")};
+    std::vector<std::unique_ptr<typename level_combo<O, 1>::node>> as;
+    std::vector<std::unique_ptr<typename level_combo<O, 3>::node>> bs;
+    std::mt19937_64 rnd(42);
+    std::uniform_real_distribution<real_t> pos(0, 8), vel((O & 2) == 2 ? 0 : -1, (O & 2) == 2 ? 0 : 1);
+    real_t powers[] = {1, 0.5, 0.25, 0.1, 0.25, 0.1, 0.25, 0.1};
+    for (int i=0; i<200; ++i) {
+        vec<2> p = make_vec(pos(rnd), pos(rnd));
+        vec<2> s = make_vec(vel(rnd), vel(rnd));
+        typename connect::powered<4>::data_type d = powers[i % 8];
+        as.emplace_back(new typename level_combo<O, 1>::node{net1, common::make_tagged_tuple<uid, x, v, connection_data>(i, p, s, d)});
+        bs.emplace_back(new typename level_combo<O, 3>::node{net2, common::make_tagged_tuple<uid, x, v, connection_data>(i, p, s, d)});
+    }
+    // cells of the levels reached by powers 1, 0.5 and 0.25 or less
+    EXPECT_EQ(4, net1.cell_side(*as[3]));
+    EXPECT_EQ(4, net2.cell_side(*bs[0]));
+    EXPECT_EQ(2, net2.cell_side(*bs[1]));
+    EXPECT_EQ(1, net2.cell_side(*bs[2]));
+    EXPECT_EQ(1, net2.cell_side(*bs[3]));
+    EXPECT_LT(500, simulate_and_compare<(O & 1) == 1>(net1, as, net2, bs, 5.5));
+}
+
+TEST(SimulatedConnectorTest, InboxQueue) {
+    component::details::inbox<int> q;
+    std::vector<int> v;
+    q.drain([&v](int x){ v.push_back(x); });
+    EXPECT_EQ(std::vector<int>{}, v);
+    for (int i=0; i<5; ++i) q.push(int(i));
+    q.drain([&v](int x){ v.push_back(x); });
+    q.push(7);
+    q.drain([&v](int x){ v.push_back(x); });
+    q.push(8);
+    EXPECT_EQ(std::vector<int>({0,1,2,3,4,7}), v);
+}
+
+TEST(SimulatedConnectorTest, InboxParcel) {
+    std::shared_ptr<int> m = std::make_shared<int>(42);
+    std::weak_ptr<int> w = m;
+    auto* p = component::details::parcel<std::shared_ptr<int>>::make(std::move(m));
+    component::details::inbox<component::details::parcel_ref> q1, q2;
+    q1.push(component::details::parcel_ref(p));
+    q2.push(component::details::parcel_ref(p));
+    p->release(component::details::parcel_base::shared - 2);
+    int received = 0;
+    q1.drain([&](component::details::parcel_ref& r){ received += *r.get<std::shared_ptr<int>>(); });
+    EXPECT_EQ(42, received);
+    EXPECT_FALSE(w.expired());
+    // the last receiver recycles the parcel, emptying its message
+    q2.drain([&](component::details::parcel_ref& r){ received += *r.get<std::shared_ptr<int>>(); });
+    EXPECT_EQ(84, received);
+    EXPECT_TRUE(w.expired());
+    // a message sent to nobody is recycled by the sender
+    m = std::make_shared<int>(7);
+    w = m;
+    p = component::details::parcel<std::shared_ptr<int>>::make(std::move(m));
+    p->release(component::details::parcel_base::shared);
+    EXPECT_TRUE(w.expired());
+}